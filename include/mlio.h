@@ -15,12 +15,15 @@
 
 #pragma once
 
+#include "mlio/buffer_provider.h"                      // IWYU pragma: export
 #include "mlio/config.h"                               // IWYU pragma: export
 #include "mlio/cpu_array.h"                            // IWYU pragma: export
+#include "mlio/csv_decoder.h"                          // IWYU pragma: export
 #include "mlio/csv_reader.h"                           // IWYU pragma: export
 #include "mlio/data_reader.h"                          // IWYU pragma: export
 #include "mlio/data_reader_base.h"                     // IWYU pragma: export
 #include "mlio/data_reader_error.h"                    // IWYU pragma: export
+#include "mlio/data_service.h"                         // IWYU pragma: export
 #include "mlio/data_stores/compression.h"              // IWYU pragma: export
 #include "mlio/data_stores/data_store.h"               // IWYU pragma: export
 #include "mlio/data_stores/file.h"                     // IWYU pragma: export
@@ -32,6 +35,8 @@
 #include "mlio/device_array.h"                         // IWYU pragma: export
 #include "mlio/endian.h"                               // IWYU pragma: export
 #include "mlio/example.h"                              // IWYU pragma: export
+#include "mlio/example_decoder.h"                      // IWYU pragma: export
+#include "mlio/fanout_data_reader.h"                   // IWYU pragma: export
 #include "mlio/init.h"                                 // IWYU pragma: export
 #include "mlio/instance.h"                             // IWYU pragma: export
 #include "mlio/instance_batch.h"                       // IWYU pragma: export
@@ -49,17 +54,22 @@
 #include "mlio/memory/memory_block.h"                  // IWYU pragma: export
 #include "mlio/memory/memory_slice.h"                  // IWYU pragma: export
 #include "mlio/memory/util.h"                          // IWYU pragma: export
+#include "mlio/mixture_reader.h"                       // IWYU pragma: export
 #include "mlio/not_supported_error.h"                  // IWYU pragma: export
 #include "mlio/parallel_data_reader.h"                 // IWYU pragma: export
 #include "mlio/parser.h"                               // IWYU pragma: export
 #include "mlio/record_readers/corrupt_record_error.h"  // IWYU pragma: export
 #include "mlio/record_readers/record.h"                // IWYU pragma: export
+#include "mlio/record_readers/record_index.h"          // IWYU pragma: export
 #include "mlio/record_readers/record_reader.h"         // IWYU pragma: export
 #include "mlio/record_readers/record_reader_base.h"    // IWYU pragma: export
 #include "mlio/record_readers/stream_record_reader.h"  // IWYU pragma: export
 #include "mlio/record_readers/text_record_reader.h"    // IWYU pragma: export
+#include "mlio/rebatching_data_reader.h"               // IWYU pragma: export
 #include "mlio/recordio_protobuf_reader.h"             // IWYU pragma: export
 #include "mlio/schema.h"                               // IWYU pragma: export
+#include "mlio/shard_coordinator.h"                    // IWYU pragma: export
+#include "mlio/shared_memory_channel.h"                // IWYU pragma: export
 #include "mlio/span.h"                                 // IWYU pragma: export
 #include "mlio/streams/file_input_stream.h"            // IWYU pragma: export
 #include "mlio/streams/gzip_inflate_stream.h"          // IWYU pragma: export
@@ -72,6 +82,7 @@
 #include "mlio/tensor.h"                               // IWYU pragma: export
 #include "mlio/tensor_visitor.h"                       // IWYU pragma: export
 #include "mlio/text_encoding.h"                        // IWYU pragma: export
+#include "mlio/transforms.h"                           // IWYU pragma: export
 #include "mlio/type_traits.h"                          // IWYU pragma: export
 #include "mlio/util/cast.h"                            // IWYU pragma: export
 #include "mlio/util/number.h"                          // IWYU pragma: export
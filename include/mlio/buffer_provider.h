@@ -0,0 +1,111 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "mlio/config.h"
+#include "mlio/data_type.h"
+#include "mlio/device_array.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ref_counter.h"
+
+namespace mlio {
+inline namespace v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents an interface for supplying the memory into which a data
+/// reader decodes the dense features of a batch.
+///
+/// By default a data reader allocates new arrays for every batch it
+/// decodes. An application that stages the batches in its own buffers
+/// (e.g. in a ring of framework tensors) can register a provider via
+/// @ref data_reader_params::output_buffers so that the features are decoded
+/// straight into those buffers instead of being copied over later.
+///
+/// @remark
+///     A data reader decodes multiple batches concurrently; therefore
+///     the implementations must be thread-safe.
+class MLIO_API buffer_provider
+    : public intrusive_ref_counter<buffer_provider> {
+public:
+    buffer_provider() noexcept = default;
+
+    buffer_provider(buffer_provider const &) = delete;
+
+    buffer_provider(buffer_provider &&) = delete;
+
+    virtual ~buffer_provider();
+
+public:
+    buffer_provider &
+    operator=(buffer_provider const &) = delete;
+
+    buffer_provider &
+    operator=(buffer_provider &&) = delete;
+
+public:
+    /// Returns the array into which the specified feature of a batch
+    /// should be decoded, or a null pointer if the data reader should
+    /// allocate the array on its own.
+    ///
+    /// @param desc
+    ///     The descriptor of the feature. Features of type string and
+    ///     sparse features are never requested.
+    /// @param batch_size
+    ///     The number of rows of the batch including the padding.
+    ///
+    /// @remark
+    ///     The returned array must reside in the main memory, have the
+    ///     data type of the feature, and hold exactly as many elements
+    ///     as the tensor of the batch; otherwise an exception is thrown.
+    ///     The data reader does not clear the array; the rows past the
+    ///     last instance of a padded batch are left untouched.
+    std::unique_ptr<device_array>
+    acquire_array(feature_desc const &desc, std::size_t batch_size);
+
+private:
+    virtual std::unique_ptr<device_array>
+    acquire_array_core(feature_desc const &desc, std::size_t batch_size) = 0;
+};
+
+/// Wraps a memory region owned by the caller into a @ref device_array.
+///
+/// @param data
+///     A pointer to the first element of the region.
+/// @param size
+///     The number of elements in the region.
+/// @param on_release
+///     An optional function that gets called once the array, and hence
+///     the tensor built on it, is destructed. Can be used to hand the
+///     region back to its owner.
+///
+/// @remark
+///     Arrays of type string are not supported.
+MLIO_API std::unique_ptr<device_array>
+wrap_external_array(data_type dt,
+                    void *data,
+                    std::size_t size,
+                    std::function<void()> on_release = {});
+
+/// @}
+
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#if !__has_include(<coroutine>) || !defined(__cpp_impl_coroutine)
+#    error "mlio/coroutine.h requires a compiler with C++20 coroutines."
+#endif
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "mlio/data_reader.h"
+#include "mlio/example.h"
+#include "mlio/intrusive_ptr.h"
+
+namespace mlio {
+inline namespace v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents an awaitable that reads the next @ref example from a
+/// @ref data_reader without blocking the awaiting coroutine's thread.
+///
+/// @remark
+///     If no example is available yet, the coroutine is resumed on a
+///     background thread of the reader. Event loops that require their
+///     coroutines to run on a particular thread should post back to it
+///     after the resumption.
+class read_example_awaitable {
+public:
+    explicit read_example_awaitable(data_reader &rdr) noexcept : reader_{&rdr}
+    {}
+
+    read_example_awaitable(read_example_awaitable const &) = delete;
+
+    read_example_awaitable(read_example_awaitable &&) = delete;
+
+    ~read_example_awaitable() = default;
+
+public:
+    read_example_awaitable &
+    operator=(read_example_awaitable const &) = delete;
+
+    read_example_awaitable &
+    operator=(read_example_awaitable &&) = delete;
+
+public:
+    bool
+    await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool
+    await_suspend(std::coroutine_handle<> handle)
+    {
+        handle_ = handle;
+
+        reader_->read_example_async(
+            [this](intrusive_ptr<example> exm, std::exception_ptr ex) {
+                example_ = std::move(exm);
+
+                exception_ = std::move(ex);
+
+                // If the read has completed before the coroutine got
+                // suspended, await_suspend() resumes it instead.
+                if (completed_.exchange(true, std::memory_order_acq_rel)) {
+                    handle_.resume();
+                }
+            });
+
+        return !completed_.exchange(true, std::memory_order_acq_rel);
+    }
+
+    intrusive_ptr<example>
+    await_resume()
+    {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+        return std::move(example_);
+    }
+
+private:
+    data_reader *reader_;
+    std::coroutine_handle<> handle_{};
+    intrusive_ptr<example> example_{};
+    std::exception_ptr exception_{};
+    std::atomic_bool completed_{};
+};
+
+/// Returns an awaitable that reads the next @ref example from the
+/// specified @ref data_reader. The result is null once the end of the
+/// dataset is reached, so the examples can be iterated with:
+///
+/// @code
+/// while (auto exm = co_await mlio::read_example_co(rdr)) {
+///     ...
+/// }
+/// @endcode
+inline read_example_awaitable
+read_example_co(data_reader &rdr) noexcept
+{
+    return read_example_awaitable{rdr};
+}
+
+/// @}
+
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/csv_reader.h"
+#include "mlio/data_type.h"
+#include "mlio/example_decoder.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/parser.h"
+#include "mlio/schema.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents an @ref example_decoder for CSV rows.
+///
+/// Each record passed to @ref decode() holds a single row; a trailing
+/// line terminator is ignored.
+class MLIO_API csv_decoder final : public example_decoder {
+public:
+    /// @param prm
+    ///     The CSV parameters. Since there is no dataset to infer the
+    ///     schema from, @ref csv_params::column_names must be specified
+    ///     and every column must have a data type either through @ref
+    ///     csv_params::default_data_type or the per-column overrides.
+    /// @param batch_size
+    ///     The typical number of rows per @ref decode() call.
+    ///
+    /// @remark
+    ///     Use @ref csv_reader::make_decoder() to construct a decoder
+    ///     with the schema of an existing dataset.
+    explicit csv_decoder(csv_params prm, std::size_t batch_size = 1);
+
+    csv_decoder(csv_decoder const &) = delete;
+
+    csv_decoder(csv_decoder &&) = delete;
+
+    ~csv_decoder() final;
+
+public:
+    csv_decoder &
+    operator=(csv_decoder const &) = delete;
+
+    csv_decoder &
+    operator=(csv_decoder &&) = delete;
+
+private:
+    MLIO_HIDDEN void
+    init_column_types();
+
+    MLIO_HIDDEN void
+    init_parsers_and_schema();
+
+    MLIO_HIDDEN bool
+    should_skip(std::size_t index, std::string const &name) const noexcept;
+
+    MLIO_HIDDEN bool
+    decode_row(memory_span row,
+               std::vector<intrusive_ptr<tensor>> &tensors,
+               std::size_t row_idx) const;
+
+    MLIO_HIDDEN std::vector<intrusive_ptr<tensor>>
+    make_tensors(std::size_t batch_size) const;
+
+public:
+    decode_result
+    decode(stdx::span<memory_span const> records) const final;
+
+    schema const &
+    get_schema() const noexcept final
+    {
+        return *schema_;
+    }
+
+    std::size_t
+    batch_size() const noexcept final
+    {
+        return batch_size_;
+    }
+
+private:
+    csv_params params_;
+    std::size_t batch_size_;
+    std::vector<data_type> column_types_{};
+    std::vector<int> skipped_columns_{};
+    std::vector<parser> column_parsers_{};
+    intrusive_ptr<schema> schema_{};
+    intrusive_ptr<detail::array_pool> pool_;
+};
+
+/// @}
+
+}  // namespace v1
+}  // namespace mlio
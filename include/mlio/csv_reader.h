@@ -148,8 +148,14 @@ private:
     make_tensors(std::size_t batch_size) const;
 
 public:
-    void
-    reset() noexcept final;
+    /// Constructs a @ref csv_decoder that decodes rows with the column
+    /// names and data types of the dataset.
+    ///
+    /// @remark
+    ///     If the schema of the dataset has not been inferred yet, this
+    ///     function peeks the first example of the dataset.
+    intrusive_ptr<csv_decoder>
+    make_decoder();
 
 private:
     csv_params params_;
@@ -158,7 +164,6 @@ private:
     std::vector<int> skipped_columns_{};
     std::vector<parser> column_parsers_{};
     intrusive_ptr<schema> schema_{};
-    bool should_read_header = true;
 };
 
 /// @}
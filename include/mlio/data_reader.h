@@ -15,16 +15,23 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
 #include <optional>
 #include <vector>
 
+#include "mlio/buffer_provider.h"
 #include "mlio/config.h"
 #include "mlio/data_stores/data_store.h"
 #include "mlio/fwd.h"
 #include "mlio/intrusive_ptr.h"
 #include "mlio/intrusive_ref_counter.h"
+#include "mlio/shard_coordinator.h"
+#include "mlio/span.h"
 
 namespace mlio {
 inline namespace v1 {
@@ -52,12 +59,53 @@ enum class last_batch_handling {
 
 /// Specifies how a batch that contains erroneous data should be
 /// handled.
+///
+/// @remark
+///     Unless set to @ref bad_batch_handling::error, a corrupt record
+///     that cannot be split from the rest of its @ref data_store does
+///     not fail the reader; the rest of the data store is skipped.
 enum class bad_batch_handling {
     error,  ///< Throw an exception.
     skip,   ///< Skip the batch.
     warn    ///< Skip the batch and log a warning message.
 };
 
+/// Specifies how a dataset should be split into shards.
+enum class sharding_strategy {
+    /// Read the whole dataset and keep every num_shards-th @ref
+    /// instance starting from the shard index.
+    instances,
+    /// Assign whole @ref data_store "data stores" to shards such that
+    /// the total size of the data stores of each shard is balanced.
+    data_stores,
+    /// Split each @ref data_store into num_shards byte ranges and read
+    /// only the records that begin in the range of the shard.
+    ///
+    /// @remark
+    ///     Data stores that cannot be seeked, such as compressed files,
+    ///     are still read from the beginning; records outside of the
+    ///     range are discarded.
+    byte_ranges
+};
+
+/// Specifies the scheduling priority of the background threads of a
+/// @ref data_reader relative to other work in the process.
+enum class task_priority {
+    low,     ///< Yield the cores to other work of higher priority.
+    normal,  ///< Share the cores equally with other work.
+    high     ///< Take precedence over other work of lower priority.
+};
+
+/// Represents a function that transforms a decoded @ref example. It
+/// returns either the transformed example, which can be the specified
+/// example modified in place, or null if the example should be skipped.
+///
+/// @remark
+///     The function is called concurrently from the background threads
+///     of the reader, so it must be thread-safe.
+using example_transform =
+    std::function<intrusive_ptr<example>(intrusive_ptr<example>)>;
+
 /// Contains the parameters that are common to all @ref data_reader
 /// "data readers".
 struct MLIO_API data_reader_params {
@@ -65,31 +113,142 @@ struct MLIO_API data_reader_params {
     /// dataset to read from.
     std::vector<intrusive_ptr<data_store>> dataset{};
     /// A number indicating how many @ref instance "data instances"
-    /// should be packed into a single @ref example.
+    /// should be packed into a single @ref example. If @ref
+    /// batch_size_bytes is specified, this is the maximum number of
+    /// data instances in a batch.
     std::size_t batch_size{};
+    /// The total cost, by default the payload size in bytes, of the
+    /// @ref instance "data instances" to pack into a single @ref
+    /// example. If specified, a batch is closed as soon as the cost of
+    /// its data instances reaches this budget, so it can exceed the
+    /// budget by at most the cost of one data instance.
+    ///
+    /// @remark
+    ///     The size of the batch dimension of the tensors varies from
+    ///     batch to batch; the @ref schema reports @ref batch_size as
+    ///     the upper bound. It cannot be combined with @ref
+    ///     last_batch_handling::pad.
+    std::optional<std::size_t> batch_size_bytes{};
+    /// The function that returns the cost of a data instance against
+    /// @ref batch_size_bytes. If not specified, the size of the raw
+    /// data of the instance is used.
+    std::function<std::size_t(instance const &)> instance_cost_fn{};
     /// The number of batches to prefetch in background to accelerate
-    /// reading. If zero, defaults to the number of processor cores.
+    /// reading. If zero, defaults to @ref max_concurrency.
     std::size_t num_prefetched_batches{};
     /// The number of parallel batch reads. If not specified, it equals
     /// to @ref num_prefetched_batches. In case a large number of
     /// batches should be prefetched, this parameter can be used to
     /// avoid thread oversubscription.
     std::size_t num_parallel_reads{};
+    /// The maximum total size, in bytes, of the batches that are being
+    /// decoded or are waiting in the prefetch queue. Once the budget is
+    /// exceeded, no more batches are read until the caller consumes
+    /// some of the prefetched @ref example "examples". At least one
+    /// batch is always prefetched, so a single batch larger than the
+    /// budget does not stall the reader.
+    ///
+    /// @remark
+    ///     The budget is applied on top of @ref num_prefetched_batches
+    ///     and can overshoot by at most the size of one batch.
+    std::optional<std::size_t> max_prefetch_bytes{};
+    /// A boolean value indicating whether the reader should tune its
+    /// prefetch depth, its number of parallel batch reads, and its
+    /// choice between serial and parallel decoding of a batch at
+    /// runtime based on how long the caller waits for examples and how
+    /// long batches take to decode.
+    ///
+    /// @remark
+    ///     If specified, @ref num_prefetched_batches and @ref
+    ///     num_parallel_reads are used as the initial values and are
+    ///     increased as long as the caller is starved, up to twice the
+    ///     number of threads of the reader. The tuner does not take
+    ///     memory into account; specify @ref max_prefetch_bytes to
+    ///     bound the memory used by the prefetched batches.
+    bool autotune = false;
+    /// A boolean value indicating whether the reader should start
+    /// reading the dataset in the background as soon as it is
+    /// constructed rather than on the first read. Opening the first
+    /// @ref data_store, inferring the schema, and building the
+    /// pipeline then overlap with the work the caller does before its
+    /// first read, which reduces the latency of the first @ref
+    /// example.
+    bool eager_start = false;
+    /// The function to apply to each decoded @ref example. It runs in
+    /// parallel on the background threads of the reader right after
+    /// decoding, so it scales with the number of cores and overlaps
+    /// with reading. See mlio/transforms.h for built-in transforms.
+    example_transform transform{};
+    /// The @ref buffer_provider that supplies the memory into which the
+    /// dense features of each batch are decoded. If not specified, the
+    /// reader allocates new arrays for every batch.
+    intrusive_ptr<buffer_provider> output_buffers{};
+    /// The maximum number of threads, including the background thread
+    /// of the reader, that can decode batches concurrently. The reader
+    /// runs in its own thread arena, so it does not compete with other
+    /// readers for the same worker threads. If zero, defaults to the
+    /// number of processor cores available to the process, which
+    /// accounts for the CPU quota and the cpuset of its cgroup.
+    std::size_t max_concurrency{};
+    /// The processor cores the background threads of the reader should
+    /// be pinned to. If empty, the threads can run on any core.
+    ///
+    /// @remark
+    ///     Thread affinity is only supported on Linux.
+    std::vector<std::size_t> cpu_affinity{};
+    /// See @ref task_priority.
+    task_priority priority = task_priority::normal;
     /// See @ref last_batch_handling.
     last_batch_handling last_batch_hnd = last_batch_handling::none;
     /// See @ref bad_batch_handling.
     bad_batch_handling bad_batch_hnd = bad_batch_handling::error;
+    /// The number of bad records that are described in a warning if
+    /// @ref bad_batch_hnd is @ref bad_batch_handling::warn. Beyond
+    /// that only one in every @ref bad_record_log_interval bad records
+    /// is described.
+    std::size_t bad_record_log_limit = 10;
+    /// See @ref bad_record_log_limit. If zero, no more warnings are
+    /// logged once the limit is reached.
+    std::size_t bad_record_log_interval = 1000;
     /// The number of @ref instance "data instances" to skip from the
     /// beginning of the dataset.
     std::size_t num_instances_to_skip{};
     /// The number of @ref instance "data instances" to read. The rest
     /// of the dataset will be ignored.
     std::optional<std::size_t> num_instances_to_read{};
+    /// The number of times the dataset should be read. If zero, the
+    /// dataset is read repeatedly until the reader is reset.
+    ///
+    /// Unlike calling @ref data_reader::reset() at the end of each
+    /// epoch, the background threads roll straight into the next epoch
+    /// (reshuffling the dataset if @ref reshuffle_each_epoch is set)
+    /// while the examples of the previous epoch are still being
+    /// consumed. The epoch boundaries are indicated by @ref
+    /// example::epoch and @ref example::end_of_epoch.
+    std::size_t num_epochs = 1;
     /// The index of the shard to read.
     std::size_t shard_index{};
     /// The number of shards the dataset should be split into. The
     /// reader will only read 1/num_shards of the dataset.
     std::size_t num_shards{};
+    /// See @ref sharding_strategy.
+    sharding_strategy shard_strategy = sharding_strategy::instances;
+    /// The @ref shard_coordinator to request the work items from. If
+    /// specified, the reader asks the coordinator for the next data
+    /// store or data store range to read once it is done with the
+    /// previous one instead of reading a static shard.
+    ///
+    /// @remark
+    ///     @ref num_shards must not be greater than one, and the state
+    ///     of the reader cannot be saved. The epochs of the readers
+    ///     sharing a coordinator are counted by their @ref
+    ///     data_reader::reset() calls.
+    intrusive_ptr<shard_coordinator> coordinator{};
+    /// The size, in bytes, of the work items handed out by the @ref
+    /// coordinator. If zero, each data store is a work item on its
+    /// own; otherwise the data stores with a known size are split into
+    /// ranges of this size.
+    std::size_t work_item_size{};
     /// A boolean value indicating whether to shuffle the @ref instance
     /// "data instances" while reading from the dataset.
     bool shuffle_instances = false;
@@ -97,9 +256,38 @@ struct MLIO_API data_reader_params {
     /// sample from. The selected data instances will be replaced with
     /// new data instances read from the dataset.
     ///
-    /// A value of zero means perfect shuffling and requires loading the
-    /// whole dataset into memory first.
+    /// A value of zero means perfect shuffling. The dataset is read
+    /// once to determine the location of each instance; instances of
+    /// memory-mapped data stores are then read lazily in permuted
+    /// order, while the rest have to be loaded into memory first.
     std::size_t shuffle_window{};
+    /// The total payload size, in bytes, of the @ref instance "data
+    /// instances" to buffer and sample from. If specified, the shuffle
+    /// window is sized in bytes and @ref shuffle_window is ignored.
+    ///
+    /// @remark
+    ///     Regardless of how the window is sized, the payloads of the
+    ///     buffered instances are copied into a compact memory block
+    ///     once their source chunks are only sparsely referenced. This
+    ///     bounds the memory pinned by the buffer to roughly twice the
+    ///     size of the buffered payloads.
+    std::optional<std::size_t> shuffle_window_bytes{};
+    /// A boolean value indicating whether to read the @ref data_store
+    /// "data stores" of the dataset in a random order. Combined with a
+    /// small @ref shuffle_window, this gives an approximate shuffle at
+    /// a fraction of the memory cost of a large shuffle window.
+    bool shuffle_data_stores = false;
+    /// The number of records in each block of a data store that has a
+    /// @ref record_index. If greater than zero, such data stores are
+    /// split into blocks that are read in a random order. The block size
+    /// is rounded up to a multiple of the stride of the index.
+    ///
+    /// @remark
+    ///     Both @ref shuffle_data_stores and this parameter use @ref
+    ///     shuffle_seed and @ref reshuffle_each_epoch, and apply even if
+    ///     @ref shuffle_instances is false. If the dataset is sharded by
+    ///     instances, @ref shuffle_seed must be specified.
+    std::size_t shuffle_block_size{};
     /// The seed that will be used for initializing the sampling
     /// distribution. If not specified, a random seed will be generated
     /// internally
@@ -116,8 +304,82 @@ struct MLIO_API data_reader_params {
     ///     advance, the ratio will be used as an approximation for the
     ///     actual amount of data to read.
     std::optional<float> subsample_ratio{};
+    /// A boolean value indicating whether to use the @ref record_index
+    /// of each data store, if available, to seek directly to the next
+    /// record to read instead of reading and discarding the records
+    /// that are skipped.
+    ///
+    /// @remark
+    ///     An index can be built with @ref
+    ///     parallel_data_reader::make_record_index().
+    bool use_record_index = false;
+    /// A boolean value indicating whether the reader should keep track
+    /// of its position so that it can be saved with @ref
+    /// data_reader::save_state().
+    ///
+    /// @remark
+    ///     The position is captured after each batch is read; if the
+    ///     instances are shuffled with a window, this includes the
+    ///     locations of all buffered instances.
+    bool enable_checkpointing = false;
 };
 
+/// Contains the statistics of a @ref data_store read by a @ref
+/// data_reader.
+struct MLIO_API data_store_statistics {
+    /// The number of records read from the data store.
+    std::size_t num_records_read{};
+    /// The total size of the records read from the data store.
+    std::size_t num_bytes_read{};
+};
+
+/// Contains the statistics of the stages of a @ref data_reader.
+///
+/// @remark
+///     The reader and decode stages run in background threads, so the
+///     times might add up to more than the wall-clock time.
+struct MLIO_API data_reader_statistics {
+    /// The statistics of each @ref data_store in the order of the
+    /// dataset.
+    std::vector<data_store_statistics> data_stores{};
+    /// The time spent reading from the underlying data stores.
+    std::chrono::nanoseconds stream_read_time{};
+    /// The time spent splitting the read data into records and, if
+    /// requested, shuffling them.
+    std::chrono::nanoseconds record_split_time{};
+    /// The time spent assembling batches from the records, excluding
+    /// the time spent reading the records.
+    std::chrono::nanoseconds batch_assembly_time{};
+    /// The time spent decoding batches into @ref example "examples".
+    std::chrono::nanoseconds decode_time{};
+    /// The time spent running the user-defined transform on the decoded
+    /// @ref example "examples". See @ref data_reader_params::transform.
+    std::chrono::nanoseconds transform_time{};
+    /// The time the caller of @ref data_reader::read_example() has
+    /// spent waiting for an @ref example to become available.
+    std::chrono::nanoseconds wait_time{};
+    /// The number of @ref example "examples" that have been decoded
+    /// but not read yet.
+    std::size_t num_queued_examples{};
+    /// The number of batches read from the dataset.
+    std::size_t num_batches_read{};
+    /// The number of batches that could not be decoded and have been
+    /// skipped. See @ref bad_batch_handling.
+    std::size_t num_bad_batches{};
+    /// The number of records that could not be decoded, including the
+    /// corrupt records that ended the reading of a @ref data_store.
+    std::size_t num_bad_records{};
+    /// The number of incomplete last batches that have been dropped.
+    /// See @ref last_batch_handling.
+    std::size_t num_dropped_batches{};
+};
+
+/// Represents a function that is called when an asynchronous read
+/// completes. It receives either the @ref example read, which is null
+/// if the end of the dataset is reached, or the exception thrown.
+using read_callback =
+    std::function<void(intrusive_ptr<example>, std::exception_ptr)>;
+
 /// Represents an interface for classes that read @ref example "examples"
 /// from a dataset in a particular data format.
 class MLIO_API data_reader : public intrusive_ref_counter<data_reader> {
@@ -151,12 +413,67 @@ public:
     virtual intrusive_ptr<example> const &
     peek_example() = 0;
 
+    /// Reads the next @ref example without blocking the calling thread
+    /// and invokes the specified callback with the result.
+    ///
+    /// @remark
+    ///     If an example is already available, the callback is invoked
+    ///     on the calling thread before the function returns; otherwise
+    ///     it is invoked on a background thread of the reader and
+    ///     should return quickly and must not throw.
+    ///
+    /// @remark
+    ///     Only one read, synchronous or asynchronous, can be pending
+    ///     at a time.
+    ///
+    /// @remark
+    ///     The default implementation calls @ref read_example() on the
+    ///     calling thread.
+    virtual void
+    read_example_async(read_callback callback);
+
+    /// Reads the next @ref example without blocking the calling thread.
+    ///
+    /// @return
+    ///     A future that becomes ready once the example is available.
+    std::future<intrusive_ptr<example>>
+    read_example_async();
+
     /// Resets the state of the reader. Calling @ref read_example()
     /// the next time will start reading from the beginning of the
     /// dataset.
     virtual void
     reset() noexcept = 0;
 
+    /// Returns the position of the reader as an opaque byte sequence.
+    /// The position corresponds to the last @ref example returned by
+    /// @ref read_example().
+    ///
+    /// @remark
+    ///     The position can only be saved if @ref
+    ///     data_reader_params::enable_checkpointing is set.
+    virtual std::vector<std::byte>
+    save_state() const;
+
+    /// Moves the reader to a position previously returned by @ref
+    /// save_state(). The reader seeks directly to the saved position
+    /// instead of reading the dataset from its beginning.
+    ///
+    /// @remark
+    ///     The reader should be constructed with the same parameters as
+    ///     the one that has saved the state.
+    virtual void
+    restore_state(memory_span state);
+
+    /// Returns the statistics of the stages of the reader since it has
+    /// been constructed. The statistics are collected without locking
+    /// and are cheap enough to be always on.
+    ///
+    /// @remark
+    ///     The default implementation returns an empty object.
+    virtual data_reader_statistics
+    statistics() const;
+
 public:
     /// Gets the number of bytes read from the dataset.
     ///
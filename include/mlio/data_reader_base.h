@@ -19,6 +19,7 @@
 #include "mlio/data_reader.h"
 #include "mlio/example.h"
 #include "mlio/intrusive_ptr.h"
+#include "mlio/span.h"
 
 namespace mlio {
 inline namespace v1 {
@@ -38,12 +39,20 @@ public:
     intrusive_ptr<example> const &
     peek_example() final;
 
+    void
+    restore_state(memory_span state) final;
+
 private:
     /// When implemented in a derived class, returns the next @ref
     /// example read from the dataset.
     virtual intrusive_ptr<example>
     read_example_core() = 0;
 
+    /// When implemented in a derived class, moves the reader to the
+    /// specified position.
+    virtual void
+    restore_state_core(memory_span state);
+
 public:
     data_reader_params const &
     params() const noexcept
@@ -52,6 +61,14 @@ public:
     }
 
 protected:
+    /// Gets a boolean value indicating whether an @ref example has been
+    /// peeked but not read yet.
+    bool
+    has_peeked_example() const noexcept
+    {
+        return peeked_example_ != nullptr;
+    }
+
     /// Gets the effective @ref bad_batch_handling value based on the
     /// current log level.
     bad_batch_handling
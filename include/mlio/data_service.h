@@ -0,0 +1,176 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+#include "mlio/fanout_data_reader.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+
+namespace mlio {
+inline namespace v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Serves the @ref example "examples" of a @ref data_reader to @ref
+/// data_service_reader "data service readers" running in other
+/// processes on the same host.
+///
+/// The server decodes the dataset once and hands the examples to its
+/// clients through @ref shared_memory_channel "shared memory channels",
+/// so the clients do not have to run decode pipelines on their own.
+/// Each client is assigned a consumer handle of the shared reader as
+/// returned by @ref make_fanout_readers(); the fanout policy decides
+/// whether the clients get disjoint subsets of the dataset or the same
+/// stream.
+///
+/// @remark
+///     A client that disconnects gives up its handle for the rest of
+///     the epoch; a new client can take it over.
+///
+/// @remark
+///     The data service is only supported on POSIX platforms.
+class MLIO_API data_service_server {
+    struct client_list;
+
+public:
+    /// @param pathname
+    ///     The pathname of the Unix domain socket to listen on.
+    /// @param rdr
+    ///     The data reader whose examples to serve.
+    /// @param num_clients
+    ///     The maximum number of clients that can be connected at the
+    ///     same time.
+    /// @param policy
+    ///     See @ref fanout_policy.
+    /// @param channel_capacity
+    ///     The size, in bytes, of the shared memory ring buffer of each
+    ///     client. It must be large enough to hold the largest example.
+    explicit data_service_server(
+        std::string pathname,
+        intrusive_ptr<data_reader> rdr,
+        std::size_t num_clients,
+        fanout_policy policy = fanout_policy::work_stealing,
+        std::size_t channel_capacity = 0x400'0000);  // 64 MiB
+
+    data_service_server(data_service_server const &) = delete;
+
+    data_service_server(data_service_server &&) = delete;
+
+    ~data_service_server();
+
+public:
+    data_service_server &
+    operator=(data_service_server const &) = delete;
+
+    data_service_server &
+    operator=(data_service_server &&) = delete;
+
+public:
+    /// Accepts and serves connections until @ref stop() is called.
+    void
+    serve();
+
+    /// Stops the server and closes all connections. Can be called from
+    /// any thread.
+    void
+    stop();
+
+private:
+    MLIO_HIDDEN void
+    serve_client(int fd);
+
+private:
+    std::size_t channel_capacity_;
+    std::unique_ptr<client_list> clients_;
+    std::unique_ptr<detail::socket_server> server_{};
+};
+
+/// Represents a @ref data_reader that reads the @ref example "examples"
+/// served by a @ref data_service_server.
+///
+/// @remark
+///     As the dataset is read by the server, @ref statistics() only
+///     reports the time the client has spent waiting for examples and
+///     @ref num_bytes_read() returns zero.
+class MLIO_API data_service_reader final : public data_reader {
+public:
+    /// @param pathname
+    ///     The pathname of the Unix domain socket of the server.
+    explicit data_service_reader(std::string pathname);
+
+    data_service_reader(data_service_reader const &) = delete;
+
+    data_service_reader(data_service_reader &&) = delete;
+
+    ~data_service_reader() final;
+
+public:
+    data_service_reader &
+    operator=(data_service_reader const &) = delete;
+
+    data_service_reader &
+    operator=(data_service_reader &&) = delete;
+
+public:
+    intrusive_ptr<example>
+    read_example() final;
+
+    intrusive_ptr<example> const &
+    peek_example() final;
+
+    void
+    reset() noexcept final;
+
+    data_reader_statistics
+    statistics() const final;
+
+private:
+    MLIO_HIDDEN intrusive_ptr<example>
+    read_example_core();
+
+    MLIO_HIDDEN std::string
+    send_request(std::string const &req, int *passed_fd = nullptr);
+
+public:
+    std::size_t
+    num_bytes_read() const noexcept final
+    {
+        return 0;
+    }
+
+private:
+    std::string pathname_;
+    int fd_ = -1;
+    std::string buffer_{};
+    intrusive_ptr<shared_memory_channel> channel_{};
+    intrusive_ptr<example> peeked_example_{};
+    bool is_exhausted_{};
+    bool is_reset_pending_{};
+    std::chrono::nanoseconds wait_time_{};
+};
+
+/// @}
+
+}  // namespace v1
+}  // namespace mlio
@@ -15,14 +15,17 @@
 
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <iostream>
+#include <optional>
 #include <string>
 
 #include "mlio/config.h"
 #include "mlio/fwd.h"
 #include "mlio/intrusive_ptr.h"
 #include "mlio/intrusive_ref_counter.h"
+#include "mlio/record_readers/record_index.h"
 
 namespace mlio {
 inline namespace v1 {
@@ -57,6 +60,26 @@ public:
     repr() const = 0;
 
 public:
+    /// Returns the size of the data store in bytes, if it can be
+    /// determined without opening the data store.
+    ///
+    /// @remark
+    ///     The returned value is only used as a hint, for instance to
+    ///     balance the data stores across shards. It must be given in
+    ///     the units of the positions of the stream returned by @ref
+    ///     open_read(); a data store that is decompressed while being
+    ///     read should return an empty value.
+    virtual std::optional<std::size_t>
+    size_hint() const;
+
+    /// Returns the @ref record_index of the data store, if one has been
+    /// saved alongside the data store and is not stale.
+    ///
+    /// @remark
+    ///     The default implementation returns an empty value.
+    virtual std::optional<record_index>
+    load_record_index() const;
+
     /// Returns a unique identifier for the data store.
     virtual std::string const &
     id() const noexcept = 0;
@@ -15,6 +15,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <optional>
 #include <string>
 
 #include "mlio/config.h"
@@ -22,6 +25,7 @@
 #include "mlio/data_stores/data_store.h"
 #include "mlio/fwd.h"
 #include "mlio/intrusive_ptr.h"
+#include "mlio/record_readers/record_index.h"
 
 namespace mlio {
 inline namespace v1 {
@@ -51,6 +55,15 @@ public:
     repr() const final;
 
 public:
+    std::optional<std::size_t>
+    size_hint() const final;
+
+    /// @remark
+    ///     The index is looked up at the pathname returned by @ref
+    ///     get_record_index_pathname().
+    std::optional<record_index>
+    load_record_index() const final;
+
     std::string const &
     id() const noexcept final
     {
@@ -61,6 +74,9 @@ private:
     std::string pathname_;
     bool mmap_;
     compression compression_;
+    // The index is loaded once per epoch; the staleness is reported
+    // only once.
+    mutable std::atomic_bool stale_index_reported_{};
 };
 
 /// @}
@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <optional>
 #include <string>
 
 #include "mlio/config.h"
@@ -43,6 +45,9 @@ public:
     repr() const final;
 
 public:
+    std::optional<std::size_t>
+    size_hint() const final;
+
     std::string const &
     id() const noexcept final
     {
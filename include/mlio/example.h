@@ -82,6 +82,19 @@ public:
     ///     evenly divisible by the batch size.
     std::size_t padding{};
 
+    /// The zero-based index of the epoch in which the example has been
+    /// read. See @ref data_reader_params::num_epochs.
+    std::size_t epoch{};
+
+    /// A boolean value indicating whether the example is the last one
+    /// of its epoch.
+    ///
+    /// @remark
+    ///     If the last batch of an epoch cannot be decoded, or is skipped
+    ///     by the @ref data_reader_params::transform, no example of that
+    ///     epoch has this flag set.
+    bool end_of_epoch{};
+
 private:
     intrusive_ptr<schema> schema_;
     std::vector<intrusive_ptr<tensor>> features_;
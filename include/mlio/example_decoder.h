@@ -0,0 +1,106 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mlio/config.h"
+#include "mlio/example.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+#include "mlio/schema.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Specifies the outcome of a @ref example_decoder::decode() call.
+enum class decode_status {
+    /// All records have been decoded.
+    ok,
+    /// A record is malformed or does not conform to the schema of the
+    /// decoder.
+    invalid_record,
+};
+
+/// Holds the result of a @ref example_decoder::decode() call.
+struct MLIO_API decode_result {
+    decode_status status = decode_status::ok;
+    /// The decoded example, or a null pointer if @ref status is not
+    /// @ref decode_status::ok.
+    intrusive_ptr<example> exm{};
+    /// The index of the record that failed to decode.
+    std::size_t record_index{};
+};
+
+/// Represents an abstract decoder that converts a set of records into
+/// an @ref example on the calling thread.
+///
+/// Unlike a @ref data_reader, a decoder has no background threads,
+/// queues, or per-dataset state which makes it suitable for decoding
+/// a handful of records per request in online inference.
+///
+/// @remark
+///     The member functions of a decoder are thread-safe and can be
+///     called concurrently.
+class MLIO_API example_decoder
+    : public intrusive_ref_counter<example_decoder> {
+public:
+    example_decoder() noexcept = default;
+
+    example_decoder(example_decoder const &) = delete;
+
+    example_decoder(example_decoder &&) = delete;
+
+    virtual ~example_decoder();
+
+public:
+    example_decoder &
+    operator=(example_decoder const &) = delete;
+
+    example_decoder &
+    operator=(example_decoder &&) = delete;
+
+public:
+    /// Decodes the specified records into an example whose batch size
+    /// equals the number of records.
+    ///
+    /// @remark
+    ///     A record that cannot be decoded is reported through the
+    ///     status of the returned @ref decode_result instead of an
+    ///     exception.
+    virtual decode_result
+    decode(stdx::span<memory_span const> records) const = 0;
+
+    /// Returns the schema of the examples returned by @ref decode()
+    /// when called with @ref batch_size() records.
+    virtual schema const &
+    get_schema() const noexcept = 0;
+
+    /// Returns the number of records per call for which the decoder
+    /// reuses its precomputed schema. Examples of any other size get
+    /// their own copy of the schema.
+    virtual std::size_t
+    batch_size() const noexcept = 0;
+};
+
+/// @}
+
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+#include "mlio/intrusive_ptr.h"
+
+namespace mlio {
+inline namespace v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Specifies how the @ref example "examples" of a shared @ref
+/// data_reader are distributed among its consumers.
+enum class fanout_policy {
+    /// Hand the examples to the consumers in turn. Each consumer gets
+    /// a deterministic subset of the dataset, but a consumer that falls
+    /// behind stalls the others once its queue is full.
+    round_robin,
+    /// Hand each example to the consumer that asks for it first. The
+    /// subset read by each consumer depends on its pace.
+    work_stealing,
+    /// Hand every example to all consumers. A consumer that falls
+    /// behind stalls the others once its queue is full.
+    broadcast
+};
+
+/// Returns the specified number of consumer handles that share the
+/// specified @ref data_reader. Each handle is a @ref data_reader on
+/// its own that returns a distinct subset, or with @ref
+/// fanout_policy::broadcast all, of the @ref example "examples" read by
+/// the shared reader, so the threads and file handles of the shared
+/// reader are not multiplied by the number of consumers.
+///
+/// @param rdr
+///     The data reader to share. It should not be used directly once
+///     shared.
+/// @param num_consumers
+///     The number of consumer handles to return.
+/// @param policy
+///     See @ref fanout_policy.
+/// @param max_queue_size
+///     The maximum number of examples buffered for a consumer that is
+///     not reading when its turn comes. Not used with @ref
+///     fanout_policy::work_stealing.
+///
+/// @remark
+///     The handles can be used concurrently from different threads,
+///     but each handle should be used by a single thread at a time.
+///
+/// @remark
+///     Calling @ref data_reader::reset() on a handle moves it to the
+///     next epoch; the shared reader is reset once all handles have
+///     been reset, and the handles that are ahead block in @ref
+///     data_reader::read_example() until then.
+MLIO_API std::vector<intrusive_ptr<data_reader>>
+make_fanout_readers(intrusive_ptr<data_reader> rdr,
+                    std::size_t num_consumers,
+                    fanout_policy policy = fanout_policy::round_robin,
+                    std::size_t max_queue_size = 1);
+
+/// @}
+
+}  // namespace v1
+}  // namespace mlio
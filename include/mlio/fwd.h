@@ -19,22 +19,35 @@ namespace mlio {
 inline namespace v1 {
 namespace detail {
 
+class array_pool;
+class autotuner;
+class bad_record_reporter;
 class chunk_reader;
 class coo_tensor_builder;
 class iconv_desc;
 class instance_batch_reader;
 class instance_reader;
+class pipeline_statistics;
+class shared_memory_record;
+struct shared_memory_header;
+class socket_server;
+class state_reader;
+class state_writer;
+class task_executor;
 class zlib_inflater;
 
 }  // namespace detail
 
+class buffer_provider;
 class coo_tensor;
 class csr_tensor;
+class csv_decoder;
 class data_store;
 class data_store;
 class dense_tensor;
 class example;
 class example;
+class example_decoder;
 class feature_desc;
 class input_stream;
 class input_stream;
@@ -47,6 +60,8 @@ class mutable_memory_block;
 class record;
 class record_reader;
 class record_reader;
+class schema;
+class shared_memory_channel;
 class tensor;
 class tensor;
 class tensor_visitor;
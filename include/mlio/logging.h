@@ -36,6 +36,16 @@ using log_message_handler = std::function<void(log_level, std::string_view)>;
 MLIO_API log_message_handler
 set_log_message_handler(log_message_handler hdl) noexcept;
 
+/// Handles the pending log messages and stops the background thread
+/// that passes them to the logging handler. The messages logged
+/// afterwards are handled synchronously.
+///
+/// Call this function before unloading a handler that cannot be
+/// called during process exit, such as one implemented in an
+/// interpreted language.
+MLIO_API void
+stop_async_logging() noexcept;
+
 MLIO_API void
 set_log_level(log_level lvl) noexcept;
 
@@ -74,6 +74,13 @@ public:
     }
 
 public:
+    /// Gets the @ref memory_block that the slice references.
+    intrusive_ptr<memory_block> const &
+    block() const noexcept
+    {
+        return block_;
+    }
+
     memory_block::pointer
     data() const noexcept
     {
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+
+namespace mlio {
+inline namespace v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Specifies the unit a @ref mixture_reader samples from its sources.
+enum class mixture_granularity {
+    /// Each @ref example is read as is from a single source.
+    batch,
+    /// Each row of an @ref example is drawn from a source on its own.
+    /// The sources must have the same features.
+    instance
+};
+
+/// Specifies how a @ref mixture_reader handles a source that has no
+/// more @ref example "examples".
+enum class exhaustion_policy {
+    /// Stop reading once any of the sources is exhausted. This keeps
+    /// the mixing ratios intact until the end of the epoch.
+    stop,
+    /// Keep reading from the remaining sources with their weights
+    /// renormalized.
+    drop_source,
+    /// Reset the exhausted source and keep reading from it. The
+    /// mixture never ends unless a source turns out to be empty.
+    restart_source
+};
+
+/// Represents a @ref data_reader that mixes the @ref example "examples"
+/// of several data readers according to sampling weights.
+///
+/// The sources are read in the calling thread, so they should prefetch
+/// their examples in the background (e.g. a @ref parallel_data_reader).
+///
+/// @remark
+///     With @ref mixture_granularity::instance, only dense tensors in
+///     row-major order are supported, and the rows are copied into new
+///     tensors. The padding of the source examples is discarded.
+class MLIO_API mixture_reader final : public data_reader {
+    struct source {
+        intrusive_ptr<data_reader> reader{};
+        double weight{};
+        bool is_active{};
+        // The current example of the source and its next row; only
+        // used with mixture_granularity::instance.
+        intrusive_ptr<example> exm{};
+        std::size_t row_idx{};
+        std::size_t num_rows{};
+    };
+
+    // A run of consecutive rows of an example.
+    struct row_range {
+        intrusive_ptr<example> exm{};
+        std::size_t begin{};
+        std::size_t end{};
+    };
+
+public:
+    /// @param readers
+    ///     The data readers to mix. They should not be used directly
+    ///     once mixed.
+    /// @param weights
+    ///     The sampling weight of each data reader. The weights do not
+    ///     have to sum up to one.
+    /// @param granularity
+    ///     See @ref mixture_granularity.
+    /// @param batch_size
+    ///     The number of rows in the batch dimension of the returned
+    ///     examples. Only used, and required, with @ref
+    ///     mixture_granularity::instance.
+    /// @param exhaustion
+    ///     See @ref exhaustion_policy.
+    /// @param seed
+    ///     The seed of the random number generator. If not specified,
+    ///     a random seed will be generated internally.
+    /// @param last_batch_hnd
+    ///     See @ref last_batch_handling. Only used with @ref
+    ///     mixture_granularity::instance.
+    explicit mixture_reader(
+        std::vector<intrusive_ptr<data_reader>> readers,
+        std::vector<double> const &weights,
+        mixture_granularity granularity = mixture_granularity::batch,
+        std::size_t batch_size = 0,
+        exhaustion_policy exhaustion = exhaustion_policy::stop,
+        std::optional<std::uint_fast64_t> seed = {},
+        last_batch_handling last_batch_hnd = last_batch_handling::none);
+
+    mixture_reader(mixture_reader const &) = delete;
+
+    mixture_reader(mixture_reader &&) = delete;
+
+    ~mixture_reader() final;
+
+public:
+    mixture_reader &
+    operator=(mixture_reader const &) = delete;
+
+    mixture_reader &
+    operator=(mixture_reader &&) = delete;
+
+public:
+    intrusive_ptr<example>
+    read_example() final;
+
+    intrusive_ptr<example> const &
+    peek_example() final;
+
+    /// @remark
+    ///     Resets all sources and restarts the random number generator
+    ///     with the same seed.
+    void
+    reset() noexcept final;
+
+    /// @remark
+    ///     The statistics of the sources are summed up; the data stores
+    ///     are listed in the order of the sources.
+    data_reader_statistics
+    statistics() const final;
+
+private:
+    MLIO_HIDDEN intrusive_ptr<example>
+    read_example_core();
+
+    MLIO_HIDDEN intrusive_ptr<example>
+    read_batch();
+
+    MLIO_HIDDEN intrusive_ptr<example>
+    read_rows();
+
+    MLIO_HIDDEN source *
+    draw_source();
+
+    MLIO_HIDDEN intrusive_ptr<example>
+    read_source_example(source &src);
+
+    MLIO_HIDDEN bool
+    fill_source_rows(source &src);
+
+    MLIO_HIDDEN void
+    deactivate(source &src);
+
+    MLIO_HIDDEN intrusive_ptr<example>
+    make_copy(std::vector<row_range> const &ranges,
+              std::size_t num_rows,
+              std::size_t batch_size);
+
+    MLIO_HIDDEN void
+    update_distribution();
+
+public:
+    std::size_t
+    num_bytes_read() const noexcept final;
+
+private:
+    std::vector<source> sources_;
+    mixture_granularity granularity_;
+    std::size_t batch_size_;
+    exhaustion_policy exhaustion_;
+    last_batch_handling last_batch_hnd_;
+    bool is_exhausted_{};
+    intrusive_ptr<example> peeked_example_{};
+    std::random_device rd_{};
+    std::uint_fast64_t seed_{rd_()};
+    std::mt19937_64 mt_{seed_};
+    // Draws among the active sources; indexed by active_sources_.
+    std::discrete_distribution<std::size_t> dist_{};
+    std::vector<std::size_t> active_sources_{};
+    intrusive_ptr<schema const> last_source_schema_{};
+    intrusive_ptr<schema> last_schema_{};
+    std::size_t last_batch_size_{};
+};
+
+/// @}
+
+}  // namespace v1
+}  // namespace mlio
@@ -15,18 +15,25 @@
 
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <deque>
 #include <exception>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "mlio/config.h"
 #include "mlio/data_reader.h"
 #include "mlio/data_reader_base.h"
 #include "mlio/fwd.h"
 #include "mlio/intrusive_ptr.h"
+#include "mlio/record_readers/record_index.h"
+#include "mlio/span.h"
 
 namespace mlio {
 inline namespace v1 {
@@ -39,8 +46,17 @@ inline namespace v1 {
 class MLIO_API parallel_data_reader : public data_reader_base {
     enum class state { not_started, running, stopped, faulted };
 
+    struct batch_msg;
     struct graph_data;
 
+    // An example along with the position of the reader right after the
+    // batch of the example has been read.
+    struct queued_example {
+        intrusive_ptr<example> exm{};
+        std::shared_ptr<detail::state_writer const> state{};
+        std::size_t num_bytes{};
+    };
+
 protected:
     explicit parallel_data_reader(data_reader_params &&prm);
 
@@ -76,9 +92,54 @@ private:
     MLIO_HIDDEN void
     init_graph();
 
+    MLIO_HIDDEN std::optional<batch_msg>
+    read_batch();
+
     MLIO_HIDDEN void
     ensure_schema_inferred();
 
+    MLIO_HIDDEN std::shared_ptr<detail::state_writer const>
+    capture_state() const;
+
+    MLIO_HIDDEN void
+    commit_state(std::shared_ptr<detail::state_writer const> &&snapshot);
+
+    MLIO_HIDDEN bool
+    try_acquire_prefetch_budget();
+
+    MLIO_HIDDEN bool
+    has_prefetch_budget() const noexcept;
+
+    MLIO_HIDDEN void
+    resume_source();
+
+    MLIO_HIDDEN void
+    release_throttled_source() noexcept;
+
+    MLIO_HIDDEN void
+    cancel_graph() noexcept;
+
+    MLIO_HIDDEN void
+    add_prefetch_bytes(std::size_t num_bytes);
+
+    MLIO_HIDDEN void
+    remove_prefetch_bytes(std::size_t num_bytes);
+
+    MLIO_HIDDEN void
+    end_batch_flight();
+
+    MLIO_HIDDEN void
+    tune(std::chrono::nanoseconds wait_time);
+
+    MLIO_HIDDEN std::size_t
+    max_queue_size() const noexcept;
+
+    MLIO_HIDDEN void
+    complete_async_read(queued_example &&qe, read_callback const &callback);
+
+    MLIO_HIDDEN void
+    restore_state_core(memory_span bits) final;
+
     /// When implemented in a derived class, infers the schema of the
     /// dataset from the specified data instance.
     ///
@@ -95,10 +156,71 @@ private:
     decode(instance_batch const &batch) const = 0;
 
 public:
+    using data_reader::read_example_async;
+
+    /// @remark
+    ///     If no example is available yet, the callback is invoked on
+    ///     the pipeline thread as soon as the next batch is decoded.
+    void
+    read_example_async(read_callback callback) final;
+
     void
     reset() noexcept override;
 
+    std::vector<std::byte>
+    save_state() const final;
+
+    /// Builds a @ref record_index for the specified data store. The
+    /// records of the index correspond one-to-one to the @ref instance
+    /// "data instances" read from the data store.
+    ///
+    /// @param ds
+    ///     The data store to index.
+    /// @param stride
+    ///     The number of records between two indexed records.
+    ///
+    /// @remark
+    ///     The index should be saved with @ref save_record_index() to
+    ///     the pathname returned by @ref get_record_index_pathname() to
+    ///     be picked up when @ref data_reader_params::use_record_index
+    ///     is set.
+    record_index
+    make_record_index(data_store const &ds, std::size_t stride);
+
 protected:
+    /// Indicates whether a batch with the specified number of values
+    /// should be decoded in parallel. Derived classes should split the
+    /// decoding of a batch into tasks only if this function returns
+    /// true; otherwise the threading overhead outweighs the benefit.
+    ///
+    /// @remark
+    ///     If @ref data_reader_params::autotune is set, the decision
+    ///     also takes into account how many other batches are being
+    ///     decoded at the same time.
+    bool
+    should_decode_in_parallel(std::size_t num_values) const noexcept;
+
+    /// Counts a data instance that cannot be decoded. Returns true if
+    /// the instance should be described by a call to @ref
+    /// report_bad_instance(); otherwise the derived class should skip
+    /// formatting a description. See @ref
+    /// data_reader_params::bad_record_log_limit.
+    bool
+    add_bad_instance() const noexcept;
+
+    /// Throws an @ref invalid_instance_error with the specified
+    /// description or logs it asynchronously, depending on the
+    /// effective @ref bad_batch_handling.
+    void
+    report_bad_instance(std::string msg) const;
+
+    /// Starts reading the dataset in the background if @ref
+    /// data_reader_params::eager_start is set. This function should be
+    /// called at the end of the constructor of the derived class once
+    /// its virtual functions can be called from a background thread.
+    void
+    start_eagerly();
+
     /// Stops the background threads. This function must be called in
     /// the destructor of the derived class to ensure that all
     /// resources are properly disposed.
@@ -109,18 +231,36 @@ public:
     std::size_t
     num_bytes_read() const noexcept final;
 
+    data_reader_statistics
+    statistics() const final;
+
 private:
     data_reader_params params_;
+    std::unique_ptr<detail::pipeline_statistics> stats_;
+    std::unique_ptr<detail::bad_record_reporter> bad_record_reporter_;
     std::unique_ptr<detail::instance_reader> reader_;
     std::unique_ptr<detail::instance_batch_reader> batch_reader_;
     state state_{};
+    std::size_t epoch_{};
+    std::size_t num_prefetched_batches_{};
+    std::unique_ptr<detail::task_executor> executor_;
+    std::unique_ptr<detail::autotuner> autotuner_{};
     std::unique_ptr<graph_data> graph_;
     std::thread thrd_{};
-    std::deque<intrusive_ptr<example>> fill_queue_{};
-    std::deque<intrusive_ptr<example>> read_queue_{};
-    std::mutex queue_mutex_;
+    std::deque<queued_example> fill_queue_{};
+    std::deque<queued_example> read_queue_{};
+    std::shared_ptr<detail::state_writer const> last_state_{};
+    std::shared_ptr<detail::state_writer const> prev_state_{};
+    mutable std::mutex queue_mutex_;
     std::condition_variable fill_cond_{};
     std::condition_variable read_cond_{};
+    read_callback pending_callback_{};
+    std::size_t num_prefetch_bytes_{};
+    std::size_t num_batches_in_flight_{};
+    std::mutex prefetch_mutex_;
+    // Indicates whether the source has stopped for lack of prefetch
+    // budget and has to be activated again.
+    bool source_throttled_{};
     std::exception_ptr exception_ptr_{};
     bool schema_inferred_{};
 };
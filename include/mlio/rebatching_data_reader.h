@@ -0,0 +1,128 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+
+namespace mlio {
+inline namespace v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents a @ref data_reader that regroups the @ref example
+/// "examples" of another data reader into batches of a different size.
+///
+/// This allows decoding a dataset in large batches, which is more
+/// efficient, while serving smaller ones. If a batch falls within a
+/// single source example, its tensors are views into the tensors of the
+/// source example and no data is copied; otherwise the rows of the
+/// source examples are concatenated with one copy per source example
+/// and feature.
+///
+/// @remark
+///     Only dense tensors are supported. The padding of the source
+///     examples is discarded.
+class MLIO_API rebatching_data_reader final : public data_reader {
+    // A range of rows in the batch dimension of an example.
+    struct row_range {
+        intrusive_ptr<example> exm{};
+        std::size_t begin{};
+        std::size_t end{};
+    };
+
+public:
+    /// @param rdr
+    ///     The data reader whose examples should be regrouped.
+    /// @param batch_size
+    ///     The number of rows in the batch dimension of the returned
+    ///     examples.
+    /// @param last_batch_hnd
+    ///     See @ref last_batch_handling.
+    explicit rebatching_data_reader(
+        intrusive_ptr<data_reader> rdr,
+        std::size_t batch_size,
+        last_batch_handling last_batch_hnd = last_batch_handling::none);
+
+    rebatching_data_reader(rebatching_data_reader const &) = delete;
+
+    rebatching_data_reader(rebatching_data_reader &&) = delete;
+
+    ~rebatching_data_reader() final;
+
+public:
+    rebatching_data_reader &
+    operator=(rebatching_data_reader const &) = delete;
+
+    rebatching_data_reader &
+    operator=(rebatching_data_reader &&) = delete;
+
+public:
+    intrusive_ptr<example>
+    read_example() final;
+
+    intrusive_ptr<example> const &
+    peek_example() final;
+
+    void
+    reset() noexcept final;
+
+    data_reader_statistics
+    statistics() const final;
+
+private:
+    MLIO_HIDDEN intrusive_ptr<example>
+    read_example_core();
+
+    MLIO_HIDDEN void
+    fill_pending_rows();
+
+    MLIO_HIDDEN intrusive_ptr<example>
+    make_view(row_range const &rng) const;
+
+    MLIO_HIDDEN intrusive_ptr<example>
+    make_copy(std::size_t num_rows, std::size_t batch_size);
+
+    MLIO_HIDDEN intrusive_ptr<schema>
+    make_schema(schema const &source, std::size_t batch_size) const;
+
+public:
+    std::size_t
+    num_bytes_read() const noexcept final;
+
+private:
+    intrusive_ptr<data_reader> reader_;
+    std::size_t batch_size_;
+    last_batch_handling last_batch_hnd_;
+    std::deque<row_range> pending_rows_{};
+    std::size_t num_pending_rows_{};
+    bool is_exhausted_{};
+    intrusive_ptr<example> peeked_example_{};
+    mutable intrusive_ptr<schema const> last_source_schema_{};
+    mutable intrusive_ptr<schema> last_schema_{};
+    mutable std::size_t last_batch_size_{};
+};
+
+/// @}
+
+}  // namespace v1
+}  // namespace mlio
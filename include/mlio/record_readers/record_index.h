@@ -0,0 +1,121 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+
+namespace mlio {
+inline namespace v1 {
+
+/// @addtogroup records Records
+/// @{
+
+/// Represents an index of the byte positions of the records of a data
+/// store.
+///
+/// The index holds the position of every stride-th record, which is
+/// enough to skip to an arbitrary record by seeking to the closest
+/// indexed record and reading at most stride - 1 records.
+class MLIO_API record_index {
+public:
+    explicit record_index(std::size_t stride,
+                          std::vector<std::size_t> positions,
+                          std::size_t num_records,
+                          std::optional<std::size_t> data_size = {});
+
+public:
+    /// Returns the index and the byte position of the closest indexed
+    /// record that is at or before the specified record.
+    std::pair<std::size_t, std::size_t>
+    lookup(std::size_t record_idx) const noexcept;
+
+public:
+    /// Gets the number of records between two indexed records.
+    std::size_t
+    stride() const noexcept
+    {
+        return stride_;
+    }
+
+    /// Gets the byte positions of the indexed records.
+    std::vector<std::size_t> const &
+    positions() const noexcept
+    {
+        return positions_;
+    }
+
+    /// Gets the total number of records in the data store.
+    std::size_t
+    num_records() const noexcept
+    {
+        return num_records_;
+    }
+
+    /// Gets the size of the data store at the time the index was
+    /// built. Used to detect stale indices.
+    std::optional<std::size_t>
+    data_size() const noexcept
+    {
+        return data_size_;
+    }
+
+private:
+    std::size_t stride_;
+    std::vector<std::size_t> positions_;
+    std::size_t num_records_;
+    std::optional<std::size_t> data_size_;
+};
+
+/// Builds a @ref record_index by reading all remaining records from
+/// the specified record reader.
+///
+/// @param rdr
+///     The record reader. The record at its current position is
+///     treated as the first record of the index.
+/// @param stride
+///     The number of records between two indexed records.
+/// @param data_size
+///     The size of the data store, if known, to store in the index.
+MLIO_API record_index
+make_record_index(record_reader &rdr,
+                  std::size_t stride,
+                  std::optional<std::size_t> data_size = {});
+
+/// Saves the specified @ref record_index to a file.
+MLIO_API void
+save_record_index(record_index const &idx, std::string const &pathname);
+
+/// Loads a @ref record_index from a file.
+MLIO_API record_index
+load_record_index(std::string const &pathname);
+
+/// Returns the pathname of the record index sidecar of the specified
+/// file.
+MLIO_API std::string
+get_record_index_pathname(std::string_view pathname);
+
+/// @}
+
+}  // namespace v1
+}  // namespace mlio
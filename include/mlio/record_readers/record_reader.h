@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <optional>
 
 #include "mlio/config.h"
@@ -50,6 +52,43 @@ public:
 
     virtual std::optional<record> const &
     peek_record() = 0;
+
+    /// Moves the reader to the specified byte position of the
+    /// underlying stream.
+    ///
+    /// @param position
+    ///     A position that points to the beginning of a record such as
+    ///     a value previously returned by @ref position().
+    virtual void
+    seek(std::size_t position) = 0;
+
+    /// Moves the reader to the first record that begins at or after
+    /// the specified byte position of the underlying stream.
+    virtual void
+    seek_to_record_boundary(std::size_t position) = 0;
+
+public:
+    /// Gets the byte position of the next record in the underlying
+    /// stream.
+    virtual std::size_t
+    position() const = 0;
+
+    virtual bool
+    seekable() const noexcept = 0;
+
+    /// Gets a value indicating whether the records are read without
+    /// copying them from the underlying stream, which makes seeking to
+    /// an arbitrary record inexpensive.
+    virtual bool
+    supports_zero_copy() const noexcept = 0;
+
+    /// Gets the total time spent reading from the underlying stream,
+    /// excluding the time spent splitting the read data into records.
+    ///
+    /// @remark
+    ///     The default implementation returns zero.
+    virtual std::chrono::nanoseconds
+    read_time() const noexcept;
 };
 
 /// @}
@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <optional>
 
 #include "mlio/config.h"
@@ -35,6 +36,12 @@ public:
     std::optional<record> const &
     peek_record() final;
 
+    void
+    seek(std::size_t position) final;
+
+    void
+    seek_to_record_boundary(std::size_t position) final;
+
 private:
     std::optional<record>
     read_record_internal();
@@ -42,8 +49,22 @@ private:
     virtual std::optional<record>
     read_record_core() = 0;
 
+    virtual void
+    seek_core(std::size_t position) = 0;
+
+    virtual void
+    seek_to_record_boundary_core(std::size_t position) = 0;
+
+    virtual std::size_t
+    position_core() const = 0;
+
+public:
+    std::size_t
+    position() const final;
+
 private:
     std::optional<record> peeked_record_{};
+    std::size_t peeked_position_{};
 };
 
 /// @}
@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <memory>
 #include <optional>
@@ -55,6 +56,18 @@ private:
     MLIO_HIDDEN std::optional<record>
     read_record_core() final;
 
+    MLIO_HIDDEN void
+    seek_core(std::size_t position) final;
+
+    MLIO_HIDDEN void
+    seek_to_record_boundary_core(std::size_t position) final;
+
+    MLIO_HIDDEN std::size_t
+    position_core() const final
+    {
+        return position_;
+    }
+
     /// When implemented in a derived class, tries to decode a record
     /// from the specified chunk.
     ///
@@ -67,7 +80,42 @@ private:
     virtual std::optional<record>
     decode_record(memory_slice &chunk, bool ignore_leftover) = 0;
 
+    /// When implemented in a derived class, discards the bits of the
+    /// specified chunk that precede the first record beginning after
+    /// the first byte of the chunk.
+    ///
+    /// @param chunk
+    ///     A memory slice that starts at @ref position().
+    /// @param ignore_leftover
+    ///     A boolean value indicating whether more bits can be read
+    ///     from the underlying @ref input_stream.
+    ///
+    /// @return
+    ///     A boolean value indicating whether a record boundary has
+    ///     been found. If false, the reader should be called again with
+    ///     the leftover bits and the next chunk.
+    ///
+    /// @remark
+    ///     The default implementation throws @ref not_supported_error.
+    virtual bool
+    skip_to_next_record(memory_slice &chunk, bool ignore_leftover);
+
+    MLIO_HIDDEN void
+    read_next_chunk();
+
 public:
+    bool
+    seekable() const noexcept final;
+
+    bool
+    supports_zero_copy() const noexcept final;
+
+    std::chrono::nanoseconds
+    read_time() const noexcept final
+    {
+        return read_time_;
+    }
+
     /// Gets the expected size of records read from the underlying @ref
     /// input_stream.
     std::size_t
@@ -82,6 +130,8 @@ public:
 private:
     std::unique_ptr<detail::chunk_reader> chunk_reader_;
     memory_slice chunk_{};
+    std::size_t position_{};
+    std::chrono::nanoseconds read_time_{};
 };
 
 /// @}
@@ -34,6 +34,12 @@ class MLIO_API text_record_reader : public stream_record_reader {
 protected:
     explicit text_record_reader(intrusive_ptr<input_stream> strm);
 
+    /// @remark
+    ///     The default implementation treats a new-line character as the
+    ///     record boundary.
+    bool
+    skip_to_next_record(memory_slice &chunk, bool ignore_leftover) override;
+
 private:
     MLIO_HIDDEN std::optional<record>
     decode_record(memory_slice &chunk, bool ignore_leftover) final;
@@ -21,6 +21,7 @@
 #include "mlio/intrusive_ptr.h"
 #include "mlio/parallel_data_reader.h"
 #include "mlio/schema.h"
+#include "mlio/span.h"
 
 namespace aialgs {
 namespace data {
@@ -42,6 +43,7 @@ inline namespace v1 {
 class MLIO_API recordio_protobuf_reader final : public parallel_data_reader {
     class decoder;
     class decoder_state;
+    class sync_decoder;
 
 public:
     explicit recordio_protobuf_reader(data_reader_params prm);
@@ -88,7 +90,17 @@ private:
     decode(instance_batch const &batch) const final;
 
     MLIO_HIDDEN static aialgs::data::Record const *
-    parse_proto(instance const &ins);
+    parse_proto(memory_span bits);
+
+public:
+    /// Constructs an @ref example_decoder that decodes RecordIO-protobuf
+    /// messages with the schema of the dataset.
+    ///
+    /// @remark
+    ///     If the schema of the dataset has not been inferred yet, this
+    ///     function peeks the first example of the dataset.
+    intrusive_ptr<example_decoder>
+    make_decoder();
 
 private:
     intrusive_ptr<schema> schema_{};
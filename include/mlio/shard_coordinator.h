@@ -0,0 +1,226 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+
+namespace mlio {
+inline namespace v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents an interface for services that hand out the work items
+/// of a dataset to data readers dynamically.
+///
+/// A work item is a data store or a range of a data store. All readers
+/// sharing a coordinator must use the same dataset so that they agree
+/// on the list of work items; the coordinator only deals with their
+/// indices. As each reader asks for its next work item once it is done
+/// with the previous one, fast readers take over the work of slow ones
+/// and the length of an epoch is set by the average reader rather than
+/// the slowest one.
+class MLIO_API shard_coordinator
+    : public intrusive_ref_counter<shard_coordinator> {
+public:
+    shard_coordinator() noexcept = default;
+
+    shard_coordinator(shard_coordinator const &) = delete;
+
+    shard_coordinator(shard_coordinator &&) = delete;
+
+    virtual ~shard_coordinator();
+
+public:
+    shard_coordinator &
+    operator=(shard_coordinator const &) = delete;
+
+    shard_coordinator &
+    operator=(shard_coordinator &&) = delete;
+
+public:
+    /// Returns the index of the next work item of the specified epoch
+    /// that has not been handed out yet, or an empty value if all work
+    /// items of the epoch have been handed out.
+    ///
+    /// @param epoch
+    ///     The epoch, starting from zero, of the caller.
+    /// @param num_items
+    ///     The number of work items in the dataset of the caller.
+    virtual std::optional<std::size_t>
+    acquire_work_item(std::size_t epoch, std::size_t num_items) = 0;
+
+    /// Marks the specified work item of the specified epoch as read.
+    /// Marking a work item more than once has no effect, so a request
+    /// can be safely retried.
+    virtual void
+    complete_work_item(std::size_t epoch, std::size_t item_idx) = 0;
+};
+
+/// Represents a @ref shard_coordinator that hands out the work items
+/// to the data readers of the current process.
+class MLIO_API local_shard_coordinator final : public shard_coordinator {
+    struct epoch_state {
+        std::size_t num_items{};
+        std::size_t next_item_idx{};
+        std::vector<bool> is_completed{};
+        std::size_t num_completed_items{};
+    };
+
+public:
+    local_shard_coordinator() noexcept = default;
+
+    local_shard_coordinator(local_shard_coordinator const &) = delete;
+
+    local_shard_coordinator(local_shard_coordinator &&) = delete;
+
+    ~local_shard_coordinator() final;
+
+public:
+    local_shard_coordinator &
+    operator=(local_shard_coordinator const &) = delete;
+
+    local_shard_coordinator &
+    operator=(local_shard_coordinator &&) = delete;
+
+public:
+    std::optional<std::size_t>
+    acquire_work_item(std::size_t epoch, std::size_t num_items) final;
+
+    void
+    complete_work_item(std::size_t epoch, std::size_t item_idx) final;
+
+    /// Returns a boolean value indicating whether all work items of the
+    /// specified epoch have been read.
+    bool
+    is_epoch_complete(std::size_t epoch) const;
+
+private:
+    mutable std::mutex mutex_{};
+    std::map<std::size_t, epoch_state> epochs_{};
+};
+
+/// Represents a @ref shard_coordinator that forwards the requests to a
+/// @ref shard_coordinator_server over a Unix domain socket.
+///
+/// @remark
+///     The connection is established on the first request and is
+///     shared by all data readers using this instance.
+class MLIO_API socket_shard_coordinator final : public shard_coordinator {
+public:
+    /// @param pathname
+    ///     The pathname of the Unix domain socket of the server.
+    explicit socket_shard_coordinator(std::string pathname);
+
+    socket_shard_coordinator(socket_shard_coordinator const &) = delete;
+
+    socket_shard_coordinator(socket_shard_coordinator &&) = delete;
+
+    ~socket_shard_coordinator() final;
+
+public:
+    socket_shard_coordinator &
+    operator=(socket_shard_coordinator const &) = delete;
+
+    socket_shard_coordinator &
+    operator=(socket_shard_coordinator &&) = delete;
+
+public:
+    std::optional<std::size_t>
+    acquire_work_item(std::size_t epoch, std::size_t num_items) final;
+
+    void
+    complete_work_item(std::size_t epoch, std::size_t item_idx) final;
+
+private:
+    MLIO_HIDDEN std::string
+    send_request(std::string const &req);
+
+private:
+    std::string pathname_;
+    std::mutex mutex_{};
+    int fd_ = -1;
+    std::string buffer_{};
+};
+
+/// Serves a @ref shard_coordinator to other processes over a Unix
+/// domain socket.
+///
+/// The protocol is line-based. A client sends "acquire <epoch>
+/// <num_items>" or "complete <epoch> <item_idx>"; the server responds
+/// with "item <item_idx>", "none", "ok", or "error <message>".
+class MLIO_API shard_coordinator_server {
+public:
+    /// @param pathname
+    ///     The pathname of the Unix domain socket to listen on. An
+    ///     existing socket file is replaced.
+    /// @param coordinator
+    ///     The coordinator to serve. If null, a @ref
+    ///     local_shard_coordinator is used.
+    explicit shard_coordinator_server(
+        std::string pathname,
+        intrusive_ptr<shard_coordinator> coordinator = {});
+
+    shard_coordinator_server(shard_coordinator_server const &) = delete;
+
+    shard_coordinator_server(shard_coordinator_server &&) = delete;
+
+    ~shard_coordinator_server();
+
+public:
+    shard_coordinator_server &
+    operator=(shard_coordinator_server const &) = delete;
+
+    shard_coordinator_server &
+    operator=(shard_coordinator_server &&) = delete;
+
+public:
+    /// Accepts and serves connections until @ref stop() is called.
+    void
+    serve();
+
+    /// Stops the server and closes all connections. Can be called from
+    /// any thread.
+    void
+    stop();
+
+private:
+    MLIO_HIDDEN void
+    serve_connection(int fd);
+
+    MLIO_HIDDEN std::string
+    handle_request(std::string const &req);
+
+private:
+    intrusive_ptr<shard_coordinator> coordinator_;
+    std::unique_ptr<detail::socket_server> server_{};
+};
+
+/// @}
+
+}  // namespace v1
+}  // namespace mlio
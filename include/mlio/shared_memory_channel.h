@@ -0,0 +1,178 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+
+namespace mlio {
+inline namespace v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents a ring buffer in shared memory through which a producer
+/// process can hand @ref example "examples" to a consumer process.
+///
+/// The sender copies the tensors of an example into the ring buffer
+/// along with a small descriptor of their types and shapes. The
+/// receiver maps the same pages and reconstructs the tensors on top of
+/// them without copying or deserializing the data; the space of an
+/// example is given back to the sender once all of its tensors are
+/// destroyed in the receiving process.
+///
+/// A channel is shared either by creating it before calling fork(), or
+/// by passing its @ref fd() to another process and opening it there
+/// via @ref open().
+///
+/// @remark
+///     A channel supports a single sending and a single receiving
+///     process. Only numeric features can be sent.
+///
+/// @remark
+///     If the peer process exits without closing the channel, a call
+///     blocked on it notices within about a second and the channel is
+///     closed. On Linux this requires both processes to share a PID
+///     namespace. A peer is only known to the channel once it has
+///     called @ref send() or @ref receive(); if it exits before that,
+///     a blocked call returns only once @ref close() is called, for
+///     instance by the parent after it has reaped its child process.
+///
+/// @remark
+///     As the space of the ring buffer is reused in order, holding on
+///     to a received example also holds the space of all examples
+///     received after it. Clone the tensors of an example that should
+///     be kept around.
+///
+/// @remark
+///     Shared memory channels are only supported on POSIX platforms.
+class MLIO_API shared_memory_channel final
+    : public intrusive_ref_counter<shared_memory_channel> {
+    friend class detail::shared_memory_record;
+
+public:
+    /// Creates a new channel.
+    ///
+    /// @param capacity
+    ///     The size, in bytes, of the ring buffer. It must be large
+    ///     enough to hold the largest example that will be sent.
+    explicit shared_memory_channel(std::size_t capacity);
+
+    shared_memory_channel(shared_memory_channel const &) = delete;
+
+    shared_memory_channel(shared_memory_channel &&) = delete;
+
+    ~shared_memory_channel();
+
+public:
+    shared_memory_channel &
+    operator=(shared_memory_channel const &) = delete;
+
+    shared_memory_channel &
+    operator=(shared_memory_channel &&) = delete;
+
+public:
+    /// Opens the channel referred to by the specified file descriptor
+    /// that was obtained from @ref fd() in another process. The
+    /// descriptor is duplicated and can be closed afterwards.
+    static intrusive_ptr<shared_memory_channel>
+    open(int fd);
+
+private:
+    MLIO_HIDDEN
+    shared_memory_channel(int fd, std::size_t capacity);
+
+public:
+    /// Copies the specified example into the ring buffer. Blocks until
+    /// enough space is available.
+    void
+    send(example const &exm);
+
+    /// Returns the next example sent through the channel. Blocks until
+    /// one is available.
+    ///
+    /// @return
+    ///     The received example, or null if the channel has been closed
+    ///     and all examples sent before have been received.
+    intrusive_ptr<example>
+    receive();
+
+    /// Closes the channel. Pending and future calls to @ref receive()
+    /// return null once the remaining examples are received, and calls
+    /// to @ref send() fail.
+    void
+    close() noexcept;
+
+private:
+    MLIO_HIDDEN void
+    map_memory();
+
+    MLIO_HIDDEN void
+    unmap_memory() noexcept;
+
+    MLIO_HIDDEN std::byte *
+    reserve(std::size_t size);
+
+    MLIO_HIDDEN void
+    commit(std::size_t size);
+
+    MLIO_HIDDEN std::byte *
+    acquire(std::uint64_t &pos);
+
+    MLIO_HIDDEN intrusive_ptr<schema>
+    read_schema(std::byte const *&ptr);
+
+    MLIO_HIDDEN void
+    release(std::uint64_t pos) noexcept;
+
+    MLIO_HIDDEN bool
+    reclaim_space() noexcept;
+
+public:
+    /// Returns the file descriptor of the shared memory.
+    int
+    fd() const noexcept
+    {
+        return fd_;
+    }
+
+    /// Returns the size, in bytes, of the ring buffer.
+    std::size_t
+    capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+private:
+    int fd_ = -1;
+    std::size_t capacity_{};
+    std::size_t map_size_{};
+    detail::shared_memory_header *header_{};
+    std::byte *data_{};
+    std::vector<std::byte> schema_bytes_{};
+    intrusive_ptr<schema> schema_{};
+};
+
+/// @}
+
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+
+namespace mlio {
+inline namespace v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Returns a transform that applies the specified transforms in order.
+/// If any of them skips the @ref example, the remaining ones are not
+/// applied.
+MLIO_API example_transform
+compose_transforms(std::vector<example_transform> transforms);
+
+/// Returns a transform that standardizes the values of a feature as
+/// (x - mean) / stddev.
+///
+/// @remark
+///     The values are updated in place and converted back to the data
+///     type of the feature. For integer features the values are rounded
+///     and clamped to the range of the type. For sparse features only
+///     the stored values are updated.
+MLIO_API example_transform
+make_standardize_transform(std::string feature_name,
+                           double mean,
+                           double stddev);
+
+/// Returns a transform that clips the values of a feature to the range
+/// [min_value, max_value].
+MLIO_API example_transform
+make_clip_transform(std::string feature_name,
+                    double min_value,
+                    double max_value);
+
+/// Returns a transform that replaces the values of a feature, typically
+/// a label, found in the specified mapping. The values not found in the
+/// mapping are left as is.
+MLIO_API example_transform
+make_remap_transform(std::string feature_name,
+                     std::unordered_map<double, double> mapping);
+
+/// @}
+
+}  // namespace v1
+}  // namespace mlio
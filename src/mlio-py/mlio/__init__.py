@@ -17,80 +17,142 @@ import mlio.core
 
 from mlio.core import\
     BadBatchHandling,\
+    BufferProvider,\
     Compression,\
     CooTensor,\
     CorruptFooterError,\
     CorruptHeaderError,\
     CorruptRecordError,\
+    compose_transforms,\
+    CsvDecoder,\
     CsvReader,\
     DataReader,\
     DataReaderError,\
+    DataReaderStatistics,\
+    DataServiceReader,\
+    DataServiceServer,\
     DataStore,\
+    DataStoreStatistics,\
     DataType,\
+    DecodeResult,\
+    DecodeStatus,\
     DenseTensor,\
     Device,\
     DeviceArray,\
     DeviceKind,\
     Example,\
+    ExampleDecoder,\
+    ExhaustionPolicy,\
+    FanoutPolicy,\
     FeatureDesc,\
     File,\
+    get_record_index_pathname,\
     InflateError,\
     InMemoryStore,\
     InputStream,\
     InvalidInstanceError,\
     LastBatchHandling,\
+    LocalShardCoordinator,\
     list_files,\
+    load_record_index,\
     LogLevel,\
+    make_clip_transform,\
+    make_fanout_readers,\
+    make_record_index,\
+    make_remap_transform,\
+    make_standardize_transform,\
     MemorySlice,\
+    MixtureGranularity,\
+    MixtureReader,\
     NotSupportedError,\
     ParquetRecordReader,\
     Record,\
+    RebatchingDataReader,\
+    RecordIndex,\
     RecordIOProtobufReader,\
     RecordKind,\
     RecordReader,\
     SageMakerPipe,\
+    save_record_index,\
     Schema,\
     SchemaError,\
+    ShardCoordinator,\
+    ShardCoordinatorServer,\
+    ShardingStrategy,\
+    SharedMemoryChannel,\
+    SocketShardCoordinator,\
     StreamError,\
+    TaskPriority,\
     Tensor
 
 __all__ = [
     'BadBatchHandling',
+    'BufferProvider',
     'Compression',
     'CooTensor',
     'CorruptFooterError',
     'CorruptHeaderError',
     'CorruptRecordError',
+    'compose_transforms',
+    'CsvDecoder',
     'CsvReader',
     'DataReader',
     'DataReaderError',
+    'DataReaderStatistics',
+    'DataServiceReader',
+    'DataServiceServer',
     'DataStore',
+    'DataStoreStatistics',
     'DataType',
+    'DecodeResult',
+    'DecodeStatus',
     'DenseTensor',
     'Device',
     'DeviceArray',
     'DeviceKind',
     'Example',
+    'ExampleDecoder',
+    'ExhaustionPolicy',
+    'FanoutPolicy',
     'FeatureDesc',
     'File',
+    'get_record_index_pathname',
     'InflateError',
     'InMemoryStore',
     'InputStream',
     'InvalidInstanceError',
     'LastBatchHandling',
+    'LocalShardCoordinator',
     'list_files',
+    'load_record_index',
     'LogLevel',
+    'make_clip_transform',
+    'make_fanout_readers',
+    'make_record_index',
+    'make_remap_transform',
+    'make_standardize_transform',
     'MemorySlice',
+    'MixtureGranularity',
+    'MixtureReader',
     'NotSupportedError',
     'ParquetRecordReader',
     'Record',
+    'RebatchingDataReader',
+    'RecordIndex',
     'RecordIOProtobufReader',
     'RecordKind',
     'RecordReader',
     'SageMakerPipe',
+    'save_record_index',
     'Schema',
     'SchemaError',
+    'ShardCoordinator',
+    'ShardCoordinatorServer',
+    'ShardingStrategy',
+    'SharedMemoryChannel',
+    'SocketShardCoordinator',
     'StreamError',
+    'TaskPriority',
     'Tensor']
 
 _logger = logging.getLogger("mlio")
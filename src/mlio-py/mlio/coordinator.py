@@ -0,0 +1,64 @@
+# Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"). You
+# may not use this file except in compliance with the License. A copy of
+# the License is located at
+#
+#      http://aws.amazon.com/apache2.0/
+#
+# or in the "license" file accompanying this file. This file is
+# distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+# ANY KIND, either express or implied. See the License for the specific
+# language governing permissions and limitations under the License.
+
+"""
+Runs a shard coordinator as a standalone process.
+
+The data readers of the worker processes connect to it by passing
+``SocketShardCoordinator(pathname)`` as their ``coordinator``:
+
+    python -m mlio.coordinator /tmp/mlio-coordinator.sock
+"""
+
+import argparse
+import signal
+import threading
+
+from mlio.core import ShardCoordinatorServer
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(
+        description="Hands out the work items of a dataset to the data "
+                    "readers of several processes.")
+    parser.add_argument("pathname",
+                        help="The pathname of the Unix domain socket to "
+                             "listen on.")
+
+    args = parser.parse_args(argv)
+
+    server = ShardCoordinatorServer(args.pathname)
+
+    # The server blocks in native code, so it runs in a background thread
+    # while the main thread waits for a termination signal.
+    thread = threading.Thread(target=server.serve)
+    thread.start()
+
+    stop_event = threading.Event()
+
+    def handle_signal(signum, frame):
+        stop_event.set()
+
+    signal.signal(signal.SIGINT, handle_signal)
+    signal.signal(signal.SIGTERM, handle_signal)
+
+    while not stop_event.wait(1.0) and thread.is_alive():
+        pass
+
+    server.stop()
+
+    thread.join()
+
+
+if __name__ == "__main__":
+    main()
@@ -15,9 +15,16 @@
 
 #include "core/module.h"
 
+#include <pybind11/chrono.h>
 #include <pybind11/stl_bind.h>
 
+#include <cstddef>
+#include <cstring>
 #include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace py = pybind11;
 
@@ -100,23 +107,189 @@ py_data_reader::num_bytes_read() const noexcept
     }
 }
 
+template<mlio::data_type dt>
+struct element_size_op {
+    std::size_t
+    operator()() const noexcept
+    {
+        return sizeof(mlio::data_type_t<dt>);
+    }
+};
+
+// Represents a device array that wraps a writable Python buffer.
+class py_buffer_array final : public mlio::device_array {
+public:
+    explicit py_buffer_array(mlio::data_type dt, py::handle const &obj)
+        : data_type_{dt}
+    {
+        int flags = PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS;
+        if (::PyObject_GetBuffer(obj.ptr(), &buffer_, flags) != 0) {
+            throw py::error_already_set();
+        }
+
+        std::size_t elem_size = mlio::dispatch<element_size_op>(dt);
+
+        auto len = static_cast<std::size_t>(buffer_.len);
+        if (len % elem_size != 0) {
+            ::PyBuffer_Release(&buffer_);
+
+            throw std::invalid_argument{
+                "The size of the buffer is not a multiple of the size of "
+                "the data type of the feature."};
+        }
+
+        size_ = len / elem_size;
+    }
+
+    py_buffer_array(py_buffer_array const &) = delete;
+
+    py_buffer_array(py_buffer_array &&) = delete;
+
+    ~py_buffer_array() final;
+
+public:
+    py_buffer_array &
+    operator=(py_buffer_array const &) = delete;
+
+    py_buffer_array &
+    operator=(py_buffer_array &&) = delete;
+
+public:
+    std::unique_ptr<mlio::device_array>
+    clone() const final
+    {
+        auto arr = mlio::make_cpu_array(data_type_, size_);
+
+        std::memcpy(arr->data(), buffer_.buf, as_size(buffer_.len));
+
+        return arr;
+    }
+
+public:
+    void *
+    data() noexcept final
+    {
+        return buffer_.buf;
+    }
+
+    void const *
+    data() const noexcept final
+    {
+        return buffer_.buf;
+    }
+
+    std::size_t
+    size() const noexcept final
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool
+    empty() const noexcept final
+    {
+        return size_ == 0;
+    }
+
+    mlio::data_type
+    dtype() const noexcept final
+    {
+        return data_type_;
+    }
+
+    mlio::device
+    get_device() const noexcept final
+    {
+        return mlio::device{mlio::device_kind::cpu()};
+    }
+
+private:
+    static std::size_t
+    as_size(Py_ssize_t len) noexcept
+    {
+        return static_cast<std::size_t>(len);
+    }
+
+private:
+    mlio::data_type data_type_;
+    Py_buffer buffer_{};
+    std::size_t size_{};
+};
+
+py_buffer_array::~py_buffer_array()
+{
+    // The tensor might be destructed on a background thread of the
+    // reader.
+    py::gil_scoped_acquire acq_gil;
+
+    ::PyBuffer_Release(&buffer_);
+}
+
+class py_buffer_provider : public mlio::buffer_provider {
+private:
+    std::unique_ptr<mlio::device_array>
+    acquire_array_core(mlio::feature_desc const &desc,
+                       std::size_t batch_size) final;
+};
+
+std::unique_ptr<mlio::device_array>
+py_buffer_provider::acquire_array_core(mlio::feature_desc const &desc,
+                                       std::size_t batch_size)
+{
+    py::gil_scoped_acquire acq_gil;
+
+    py::function fn = py::get_overload(
+        static_cast<mlio::buffer_provider const *>(this), "acquire_buffer");
+    if (!fn) {
+        throw std::logic_error{
+            "The buffer provider does not implement acquire_buffer()."};
+    }
+
+    // Pass a copy so that the Python object can outlive the schema.
+    py::object buf = fn(mlio::feature_desc{desc}, batch_size);
+    if (buf.is_none()) {
+        return nullptr;
+    }
+
+    return std::make_unique<py_buffer_array>(desc.dtype(), buf);
+}
+
 mlio::intrusive_ptr<mlio::csv_reader>
 make_csv_reader(
     std::vector<mlio::intrusive_ptr<mlio::data_store>> dataset,
     std::size_t batch_size,
+    std::optional<std::size_t> batch_size_bytes,
     std::size_t num_prefetched_batches,
     std::size_t num_parallel_reads,
+    std::optional<std::size_t> max_prefetch_bytes,
+    bool autotune,
+    bool eager_start,
+    mlio::example_transform transform,
+    mlio::intrusive_ptr<mlio::buffer_provider> output_buffers,
+    std::size_t max_concurrency,
+    std::vector<std::size_t> cpu_affinity,
+    mlio::task_priority priority,
     mlio::last_batch_handling last_batch_hnd,
     mlio::bad_batch_handling bad_batch_hnd,
+    std::size_t bad_record_log_limit,
+    std::size_t bad_record_log_interval,
     std::size_t num_instances_to_skip,
     std::optional<std::size_t> num_instances_to_read,
+    std::size_t num_epochs,
     std::size_t shard_index,
     std::size_t num_shards,
+    mlio::sharding_strategy shard_strategy,
+    mlio::intrusive_ptr<mlio::shard_coordinator> coordinator,
+    std::size_t work_item_size,
     bool shuffle_instances,
     std::size_t shuffle_window,
+    std::optional<std::size_t> shuffle_window_bytes,
+    bool shuffle_data_stores,
+    std::size_t shuffle_block_size,
     std::optional<std::size_t> shuffle_seed,
     bool reshuffle_each_epoch,
     std::optional<float> subsample_ratio,
+    bool use_record_index,
+    bool enable_checkpointing,
     std::vector<std::string> column_names,
     std::string name_prefix,
     std::unordered_set<std::string> use_columns,
@@ -138,19 +311,39 @@ make_csv_reader(
 
     rdr_prm.dataset = std::move(dataset);
     rdr_prm.batch_size = batch_size;
+    rdr_prm.batch_size_bytes = batch_size_bytes;
     rdr_prm.num_prefetched_batches = num_prefetched_batches;
     rdr_prm.num_parallel_reads = num_parallel_reads;
+    rdr_prm.max_prefetch_bytes = max_prefetch_bytes;
+    rdr_prm.autotune = autotune;
+    rdr_prm.eager_start = eager_start;
+    rdr_prm.transform = std::move(transform);
+    rdr_prm.output_buffers = std::move(output_buffers);
+    rdr_prm.max_concurrency = max_concurrency;
+    rdr_prm.cpu_affinity = std::move(cpu_affinity);
+    rdr_prm.priority = priority;
     rdr_prm.last_batch_hnd = last_batch_hnd;
     rdr_prm.bad_batch_hnd = bad_batch_hnd;
+    rdr_prm.bad_record_log_limit = bad_record_log_limit;
+    rdr_prm.bad_record_log_interval = bad_record_log_interval;
     rdr_prm.num_instances_to_skip = num_instances_to_skip;
     rdr_prm.num_instances_to_read = num_instances_to_read;  // NOLINT
+    rdr_prm.num_epochs = num_epochs;
     rdr_prm.shard_index = shard_index;
     rdr_prm.num_shards = num_shards;
+    rdr_prm.shard_strategy = shard_strategy;
+    rdr_prm.coordinator = std::move(coordinator);
+    rdr_prm.work_item_size = work_item_size;
     rdr_prm.shuffle_instances = shuffle_instances;
     rdr_prm.shuffle_window = shuffle_window;
+    rdr_prm.shuffle_window_bytes = shuffle_window_bytes;
+    rdr_prm.shuffle_data_stores = shuffle_data_stores;
+    rdr_prm.shuffle_block_size = shuffle_block_size;
     rdr_prm.shuffle_seed = shuffle_seed;  // NOLINT
     rdr_prm.reshuffle_each_epoch = reshuffle_each_epoch;
     rdr_prm.subsample_ratio = std::move(subsample_ratio);
+    rdr_prm.use_record_index = use_record_index;
+    rdr_prm.enable_checkpointing = enable_checkpointing;
 
     mlio::csv_params csv_prm{};
 
@@ -181,42 +374,129 @@ mlio::intrusive_ptr<mlio::recordio_protobuf_reader>
 make_recordio_protobuf_reader(
     std::vector<mlio::intrusive_ptr<mlio::data_store>> dataset,
     std::size_t batch_size,
+    std::optional<std::size_t> batch_size_bytes,
     std::size_t num_prefetched_batches,
     std::size_t num_parallel_reads,
+    std::optional<std::size_t> max_prefetch_bytes,
+    bool autotune,
+    bool eager_start,
+    mlio::example_transform transform,
+    mlio::intrusive_ptr<mlio::buffer_provider> output_buffers,
+    std::size_t max_concurrency,
+    std::vector<std::size_t> cpu_affinity,
+    mlio::task_priority priority,
     mlio::last_batch_handling last_batch_hnd,
     mlio::bad_batch_handling bad_batch_hnd,
+    std::size_t bad_record_log_limit,
+    std::size_t bad_record_log_interval,
     std::size_t num_instances_to_skip,
     std::optional<std::size_t> num_instances_to_read,
+    std::size_t num_epochs,
     std::size_t shard_index,
     std::size_t num_shards,
+    mlio::sharding_strategy shard_strategy,
+    mlio::intrusive_ptr<mlio::shard_coordinator> coordinator,
+    std::size_t work_item_size,
     bool shuffle_instances,
     std::size_t shuffle_window,
+    std::optional<std::size_t> shuffle_window_bytes,
+    bool shuffle_data_stores,
+    std::size_t shuffle_block_size,
     std::optional<std::size_t> shuffle_seed,
     bool reshuffle_each_epoch,
-    std::optional<float> subsample_ratio)
+    std::optional<float> subsample_ratio,
+    bool use_record_index,
+    bool enable_checkpointing)
 {
     mlio::data_reader_params rdr_prm{};
 
     rdr_prm.dataset = std::move(dataset);
     rdr_prm.batch_size = batch_size;
+    rdr_prm.batch_size_bytes = batch_size_bytes;
     rdr_prm.num_prefetched_batches = num_prefetched_batches;
     rdr_prm.num_parallel_reads = num_parallel_reads;
+    rdr_prm.max_prefetch_bytes = max_prefetch_bytes;
+    rdr_prm.autotune = autotune;
+    rdr_prm.eager_start = eager_start;
+    rdr_prm.transform = std::move(transform);
+    rdr_prm.output_buffers = std::move(output_buffers);
+    rdr_prm.max_concurrency = max_concurrency;
+    rdr_prm.cpu_affinity = std::move(cpu_affinity);
+    rdr_prm.priority = priority;
     rdr_prm.last_batch_hnd = last_batch_hnd;
     rdr_prm.bad_batch_hnd = bad_batch_hnd;
+    rdr_prm.bad_record_log_limit = bad_record_log_limit;
+    rdr_prm.bad_record_log_interval = bad_record_log_interval;
     rdr_prm.num_instances_to_skip = num_instances_to_skip;
     rdr_prm.num_instances_to_read = num_instances_to_read;  // NOLINT
+    rdr_prm.num_epochs = num_epochs;
     rdr_prm.shard_index = shard_index;
     rdr_prm.num_shards = num_shards;
+    rdr_prm.shard_strategy = shard_strategy;
+    rdr_prm.coordinator = std::move(coordinator);
+    rdr_prm.work_item_size = work_item_size;
     rdr_prm.shuffle_instances = shuffle_instances;
     rdr_prm.shuffle_window = shuffle_window;
+    rdr_prm.shuffle_window_bytes = shuffle_window_bytes;
+    rdr_prm.shuffle_data_stores = shuffle_data_stores;
+    rdr_prm.shuffle_block_size = shuffle_block_size;
     rdr_prm.shuffle_seed = shuffle_seed;  // NOLINT
     rdr_prm.reshuffle_each_epoch = reshuffle_each_epoch;
     rdr_prm.subsample_ratio = std::move(subsample_ratio);
+    rdr_prm.use_record_index = use_record_index;
+    rdr_prm.enable_checkpointing = enable_checkpointing;
 
     return mlio::make_intrusive<mlio::recordio_protobuf_reader>(
         std::move(rdr_prm));
 }
 
+py::bytes
+save_state(mlio::data_reader const &rdr)
+{
+    std::vector<std::byte> bits{};
+    {
+        py::gil_scoped_release rel_gil{};
+
+        bits = rdr.save_state();
+    }
+
+    return py::bytes(reinterpret_cast<char const *>(bits.data()), bits.size());
+}
+
+void
+restore_state(mlio::data_reader &rdr, py::bytes const &state)
+{
+    std::string bits = state;
+
+    py::gil_scoped_release rel_gil{};
+
+    rdr.restore_state(mlio::memory_span{
+        reinterpret_cast<std::byte const *>(bits.data()), bits.size()});
+}
+
+mlio::decode_result
+decode_records(mlio::example_decoder const &dc,
+               std::vector<py::buffer> const &records)
+{
+    std::vector<py::buffer_info> infos{};
+    infos.reserve(records.size());
+
+    std::vector<mlio::memory_span> spans{};
+    spans.reserve(records.size());
+
+    for (py::buffer const &rec : records) {
+        py::buffer_info &info = infos.emplace_back(rec.request());
+
+        auto size = static_cast<std::size_t>(info.size * info.itemsize);
+
+        spans.emplace_back(static_cast<std::byte const *>(info.ptr), size);
+    }
+
+    py::gil_scoped_release rel_gil{};
+
+    return dc.decode(spans);
+}
+
 }  // namespace
 }  // namespace detail
 
@@ -254,6 +534,249 @@ register_data_readers(py::module &m)
                mlio::bad_batch_handling::warn,
                "Skip the batch and log a warning message.");
 
+    py::enum_<mlio::sharding_strategy>(
+        m,
+        "ShardingStrategy",
+        "Specifies how a dataset should be split into shards.")
+        .value("INSTANCES",
+               mlio::sharding_strategy::instances,
+               "Read the whole dataset and keep every num_shards-th data "
+               "instance starting from the shard index.")
+        .value("DATA_STORES",
+               mlio::sharding_strategy::data_stores,
+               "Assign whole data stores to shards such that the total size "
+               "of the data stores of each shard is balanced.")
+        .value("BYTE_RANGES",
+               mlio::sharding_strategy::byte_ranges,
+               "Split each data store into num_shards byte ranges and read "
+               "only the records that begin in the range of the shard.");
+
+    py::enum_<mlio::task_priority>(
+        m,
+        "TaskPriority",
+        "Specifies the scheduling priority of the background threads of a "
+        "data reader relative to other work in the process.")
+        .value("LOW",
+               mlio::task_priority::low,
+               "Yield the cores to other work of higher priority.")
+        .value("NORMAL",
+               mlio::task_priority::normal,
+               "Share the cores equally with other work.")
+        .value("HIGH",
+               mlio::task_priority::high,
+               "Take precedence over other work of lower priority.");
+
+    py::enum_<mlio::fanout_policy>(
+        m,
+        "FanoutPolicy",
+        "Specifies how the examples of a shared data reader are "
+        "distributed among its consumers.")
+        .value("ROUND_ROBIN",
+               mlio::fanout_policy::round_robin,
+               "Hand the examples to the consumers in turn.")
+        .value("WORK_STEALING",
+               mlio::fanout_policy::work_stealing,
+               "Hand each example to the consumer that asks for it first.")
+        .value("BROADCAST",
+               mlio::fanout_policy::broadcast,
+               "Hand every example to all consumers.");
+
+    py::enum_<mlio::mixture_granularity>(
+        m,
+        "MixtureGranularity",
+        "Specifies the unit a ``MixtureReader`` samples from its sources.")
+        .value("BATCH",
+               mlio::mixture_granularity::batch,
+               "Read each example as is from a single source.")
+        .value("INSTANCE",
+               mlio::mixture_granularity::instance,
+               "Draw each row of an example from a source on its own.");
+
+    py::enum_<mlio::exhaustion_policy>(
+        m,
+        "ExhaustionPolicy",
+        "Specifies how a ``MixtureReader`` handles an exhausted source.")
+        .value("STOP",
+               mlio::exhaustion_policy::stop,
+               "Stop reading once any of the sources is exhausted.")
+        .value("DROP_SOURCE",
+               mlio::exhaustion_policy::drop_source,
+               "Keep reading from the remaining sources.")
+        .value("RESTART_SOURCE",
+               mlio::exhaustion_policy::restart_source,
+               "Reset the exhausted source and keep reading from it.");
+
+    py::class_<mlio::buffer_provider,
+               detail::py_buffer_provider,
+               mlio::intrusive_ptr<mlio::buffer_provider>>(
+        m,
+        "BufferProvider",
+        R"(
+        Represents an interface for supplying the memory into which a data
+        reader decodes the dense features of a batch.
+
+        Subclasses implement ``acquire_buffer(desc, batch_size)`` which
+        receives the ``FeatureDesc`` of a feature and the number of rows
+        of the batch, and returns either a writable, C-contiguous object
+        supporting the buffer protocol with exactly as many elements of
+        the feature's data type as the batch tensor, or None to let the
+        reader allocate the array on its own. The returned object is kept
+        alive as long as the tensor decoded into it. The method is called
+        from the background threads of the reader with the GIL held.
+        )")
+        .def(py::init<>());
+
+    py::class_<mlio::shard_coordinator,
+               mlio::intrusive_ptr<mlio::shard_coordinator>>(
+        m,
+        "ShardCoordinator",
+        "Represents an interface for services that hand out the work items "
+        "of a dataset to data readers dynamically.")
+        .def("acquire_work_item",
+             &mlio::shard_coordinator::acquire_work_item,
+             "epoch"_a,
+             "num_items"_a)
+        .def("complete_work_item",
+             &mlio::shard_coordinator::complete_work_item,
+             "epoch"_a,
+             "item_idx"_a);
+
+    py::class_<mlio::local_shard_coordinator,
+               mlio::shard_coordinator,
+               mlio::intrusive_ptr<mlio::local_shard_coordinator>>(
+        m,
+        "LocalShardCoordinator",
+        "Represents a shard coordinator that hands out the work items to "
+        "the data readers of the current process.")
+        .def(py::init<>())
+        .def("is_epoch_complete",
+             &mlio::local_shard_coordinator::is_epoch_complete,
+             "epoch"_a);
+
+    py::class_<mlio::socket_shard_coordinator,
+               mlio::shard_coordinator,
+               mlio::intrusive_ptr<mlio::socket_shard_coordinator>>(
+        m,
+        "SocketShardCoordinator",
+        "Represents a shard coordinator that forwards the requests to a "
+        "``ShardCoordinatorServer`` over a Unix domain socket.")
+        .def(py::init<std::string>(), "pathname"_a);
+
+    py::class_<mlio::shard_coordinator_server>(
+        m,
+        "ShardCoordinatorServer",
+        "Serves a shard coordinator to other processes over a Unix domain "
+        "socket.")
+        .def(py::init<std::string,
+                      mlio::intrusive_ptr<mlio::shard_coordinator>>(),
+             "pathname"_a,
+             "coordinator"_a = nullptr)
+        .def("serve",
+             &mlio::shard_coordinator_server::serve,
+             py::call_guard<py::gil_scoped_release>(),
+             "Accepts and serves connections until ``stop()`` is called.")
+        .def("stop",
+             &mlio::shard_coordinator_server::stop,
+             py::call_guard<py::gil_scoped_release>(),
+             "Stops the server and closes all connections.");
+
+    py::class_<mlio::shared_memory_channel,
+               mlio::intrusive_ptr<mlio::shared_memory_channel>>(
+        m,
+        "SharedMemoryChannel",
+        R"(
+        Represents a ring buffer in shared memory through which a worker
+        process can hand examples to another process without pickling.
+
+        The receiver reconstructs the tensors on top of the shared pages
+        without copying them. Create the channel before forking, or pass
+        its ``fd`` to the other process and use ``SharedMemoryChannel.open``.
+        )")
+        .def(py::init<std::size_t>(),
+             "capacity"_a,
+             R"(
+            Parameters
+            ----------
+            capacity : int
+                The size, in bytes, of the ring buffer. It must be large
+                enough to hold the largest example that will be sent.
+            )")
+        .def_static("open",
+                    &mlio::shared_memory_channel::open,
+                    "fd"_a,
+                    "Opens the channel referred to by the specified file "
+                    "descriptor.")
+        .def("send",
+             &mlio::shared_memory_channel::send,
+             py::call_guard<py::gil_scoped_release>(),
+             "example"_a,
+             "Copies the specified example into the ring buffer.")
+        .def("receive",
+             &mlio::shared_memory_channel::receive,
+             py::call_guard<py::gil_scoped_release>(),
+             "Returns the next example, or None if the channel has been "
+             "closed.")
+        .def("close",
+             &mlio::shared_memory_channel::close,
+             "Closes the channel.")
+        .def_property_readonly("fd", &mlio::shared_memory_channel::fd)
+        .def_property_readonly("capacity",
+                               &mlio::shared_memory_channel::capacity);
+
+    py::enum_<mlio::decode_status>(
+        m, "DecodeStatus", "Specifies the outcome of a decode call.")
+        .value(
+            "OK", mlio::decode_status::ok, "All records have been decoded.")
+        .value("INVALID_RECORD",
+               mlio::decode_status::invalid_record,
+               "A record is malformed or does not conform to the schema.");
+
+    py::class_<mlio::decode_result>(
+        m, "DecodeResult", "Holds the result of a decode call.")
+        .def_readonly("status", &mlio::decode_result::status)
+        .def_readonly("example",
+                      &mlio::decode_result::exm,
+                      "The decoded example, or None if the status is not "
+                      "``OK``.")
+        .def_readonly("record_index",
+                      &mlio::decode_result::record_index,
+                      "The index of the record that failed to decode.");
+
+    py::class_<mlio::example_decoder,
+               mlio::intrusive_ptr<mlio::example_decoder>>(
+        m,
+        "ExampleDecoder",
+        R"(
+        Decodes a set of records into an example on the calling thread.
+
+        Unlike a data reader, a decoder has no background threads or
+        queues which makes it suitable for online inference. Use the
+        ``make_decoder()`` method of a reader to construct one.
+        )")
+        .def("decode",
+             &detail::decode_records,
+             "records"_a,
+             R"(
+            Decodes the specified records.
+
+            Parameters
+            ----------
+            records : list of buffers
+                The records to decode; for CSV, one row per record.
+            )")
+        .def_property_readonly("schema",
+                               &mlio::example_decoder::get_schema,
+                               py::return_value_policy::reference_internal)
+        .def_property_readonly("batch_size",
+                               &mlio::example_decoder::batch_size);
+
+    py::class_<mlio::csv_decoder,
+               mlio::example_decoder,
+               mlio::intrusive_ptr<mlio::csv_decoder>>(
+        m,
+        "CsvDecoder",
+        "Represents an ``ExampleDecoder`` for CSV rows.");
+
     py::class_<detail::py_data_iterator>(m, "DataIterator")
         .def("__iter__",
              [](detail::py_data_iterator &it) -> detail::py_data_iterator & {
@@ -261,6 +784,55 @@ register_data_readers(py::module &m)
              })
         .def("__next__", &detail::py_data_iterator::next);
 
+    py::class_<mlio::data_store_statistics>(
+        m,
+        "DataStoreStatistics",
+        "Holds the number of records and bytes read from a data store.")
+        .def_readonly("num_records_read",
+                      &mlio::data_store_statistics::num_records_read)
+        .def_readonly("num_bytes_read",
+                      &mlio::data_store_statistics::num_bytes_read);
+
+    py::class_<mlio::data_reader_statistics>(
+        m,
+        "DataReaderStatistics",
+        "Holds the cumulative time spent in each stage of the pipeline of "
+        "a data reader along with its throughput counters.")
+        .def_readonly("data_stores",
+                      &mlio::data_reader_statistics::data_stores,
+                      "The statistics of each data store of the dataset.")
+        .def_readonly("stream_read_time",
+                      &mlio::data_reader_statistics::stream_read_time,
+                      "The time spent reading chunks from the data stores.")
+        .def_readonly("record_split_time",
+                      &mlio::data_reader_statistics::record_split_time,
+                      "The time spent splitting chunks into records.")
+        .def_readonly("batch_assembly_time",
+                      &mlio::data_reader_statistics::batch_assembly_time,
+                      "The time spent assembling instance batches.")
+        .def_readonly("decode_time",
+                      &mlio::data_reader_statistics::decode_time,
+                      "The time spent decoding batches, summed across "
+                      "threads.")
+        .def_readonly("transform_time",
+                      &mlio::data_reader_statistics::transform_time,
+                      "The time spent running the transform, summed across "
+                      "threads.")
+        .def_readonly("wait_time",
+                      &mlio::data_reader_statistics::wait_time,
+                      "The time the consumer has spent waiting for an "
+                      "example.")
+        .def_readonly("num_queued_examples",
+                      &mlio::data_reader_statistics::num_queued_examples)
+        .def_readonly("num_batches_read",
+                      &mlio::data_reader_statistics::num_batches_read)
+        .def_readonly("num_bad_batches",
+                      &mlio::data_reader_statistics::num_bad_batches)
+        .def_readonly("num_bad_records",
+                      &mlio::data_reader_statistics::num_bad_records)
+        .def_readonly("num_dropped_batches",
+                      &mlio::data_reader_statistics::num_dropped_batches);
+
     py::class_<mlio::data_reader,
                detail::py_data_reader,
                mlio::intrusive_ptr<mlio::data_reader>>(
@@ -283,6 +855,21 @@ register_data_readers(py::module &m)
              &mlio::data_reader::reset,
              "Resets the state of the reader. Calling ``read_example()`` the "
              "next time will start reading from the beginning of the dataset.")
+        .def("save_state",
+             &detail::save_state,
+             "Returns the position of the reader as an opaque ``bytes`` "
+             "object. The position corresponds to the last ``example`` "
+             "returned by ``read_example()``.")
+        .def("restore_state",
+             &detail::restore_state,
+             "state"_a,
+             "Moves the reader to a position previously returned by "
+             "``save_state()`` without reading the dataset from its "
+             "beginning.")
+        .def("statistics",
+             &mlio::data_reader::statistics,
+             "Returns a snapshot of the per-stage timings and counters of "
+             "the reader.")
         .def("__iter__",
              [](py::object &rdr) {
                  return detail::py_data_iterator(
@@ -305,22 +892,52 @@ register_data_readers(py::module &m)
         m,
         "CsvReader",
         "Represents a ``data_reader`` for reading CSV datasets.")
+        .def("make_record_index",
+             &mlio::parallel_data_reader::make_record_index,
+             "store"_a,
+             "stride"_a = 1024,
+             py::call_guard<py::gil_scoped_release>(),
+             "Build a ``RecordIndex`` for the specified data store.")
+        .def("make_decoder",
+             &mlio::csv_reader::make_decoder,
+             py::call_guard<py::gil_scoped_release>(),
+             "Constructs a ``CsvDecoder`` with the columns of the dataset.")
         .def(py::init<>(&detail::make_csv_reader),
              "dataset"_a,
              "batch_size"_a,
+             "batch_size_bytes"_a = std::nullopt,
              "num_prefetched_batches"_a = 0,
              "num_parallel_reads"_a = 0,
+             "max_prefetch_bytes"_a = std::nullopt,
+             "autotune"_a = false,
+             "eager_start"_a = false,
+             "transform"_a = nullptr,
+             "output_buffers"_a = nullptr,
+             "max_concurrency"_a = 0,
+             "cpu_affinity"_a = std::vector<std::size_t>{},
+             "priority"_a = mlio::task_priority::normal,
              "last_batch_handling"_a = mlio::last_batch_handling::none,
              "bad_batch_handling"_a = mlio::bad_batch_handling::error,
+             "bad_record_log_limit"_a = 10,
+             "bad_record_log_interval"_a = 1000,
              "num_instances_to_skip"_a = 0,
              "num_instances_to_read"_a = std::nullopt,
+             "num_epochs"_a = 1,
              "shard_index"_a = 0,
              "num_shards"_a = 0,
+             "sharding_strategy"_a = mlio::sharding_strategy::instances,
+             "coordinator"_a = nullptr,
+             "work_item_size"_a = 0,
              "shuffle_instances"_a = false,
              "shuffle_window"_a = 0,
+             "shuffle_window_bytes"_a = std::nullopt,
+             "shuffle_data_stores"_a = false,
+             "shuffle_block_size"_a = 0,
              "shuffle_seed"_a = std::nullopt,
              "reshuffle_each_epoch"_a = false,
              "subsample_ratio"_a = std::nullopt,
+             "use_record_index"_a = false,
+             "enable_checkpointing"_a = false,
              "column_names"_a = std::vector<std::string>{},
              "name_prefix"_a = "",
              "use_columns"_a = std::unordered_set<std::string>{},
@@ -347,37 +964,117 @@ register_data_readers(py::module &m)
                 dataset to read from.
             batch_size : int
                 A number indicating how many data instances should be packed
-                into a single ``example``.
+                into a single ``example``. If `batch_size_bytes` is specified,
+                this is the maximum number of data instances in a batch.
+            batch_size_bytes : int, optional
+                The total payload size, in bytes, of the data instances to
+                pack into a single ``example``. If specified, a batch is
+                closed as soon as the size of its data instances reaches this
+                budget and the batch dimension varies from batch to batch.
+                Cannot be combined with ``LastBatchHandling.PAD``.
             num_prefetched_batches : int, optional
                 The number of batches to prefetch in background to accelerate
-                reading. If zero, default to the number of processor cores.
+                reading. If zero, defaults to ``max_concurrency``.
             num_parallel_reads : int, optional
                 The number of parallel batch reads. If not specified, it equals
                 to `num_prefetched_batche`. In case a large number of batches
                 should be prefetched, this parameter can be used to avoid
                 thread oversubscription.
+            max_prefetch_bytes : int, optional
+                The maximum total size, in bytes, of the batches that are
+                being decoded or are waiting to be read. Once exceeded, the
+                reader stops reading ahead until some of the prefetched
+                examples are consumed.
+            autotune : bool, optional
+                A boolean value indicating whether to tune the number of
+                prefetched batches, the number of parallel reads, and the
+                decoding parallelism at runtime based on how long the
+                caller waits for examples. The tuner does not take memory
+                into account; specify `max_prefetch_bytes` to bound the
+                memory used by the prefetched batches.
+            eager_start : bool, optional
+                A boolean value indicating whether to start reading the
+                dataset in background as soon as the reader is constructed
+                rather than on the first read.
+            transform : callable, optional
+                A function that takes a decoded ``Example`` and returns the
+                transformed example, or None to skip it. It runs in parallel
+                on the background threads of the reader. Built-in
+                transforms such as ``make_standardize_transform`` run
+                without holding the GIL; a Python function holds it while
+                running.
+            output_buffers : BufferProvider, optional
+                The provider of the buffers into which the dense features
+                of each batch are decoded. If None, the reader allocates
+                new arrays for every batch.
+            max_concurrency : int, optional
+                The maximum number of threads that can decode batches
+                concurrently. The reader runs in its own thread arena. If
+                zero, defaults to the number of processor cores available
+                to the process, including the limits of its cgroup.
+            cpu_affinity : list of ints, optional
+                The processor cores the background threads of the reader
+                should be pinned to. Only supported on Linux.
+            priority : TaskPriority
+                See ``TaskPriority``.
             last_batch_handling : LastBatchHandling
                 See ``LastBatchHandling``.
             bad_batch_handling : BadBatchHandling
                 See ``BadBatchHandling``.
+            bad_record_log_limit : int
+                The number of bad records that are described in a warning
+                if `bad_batch_handling` is ``WARN``. Beyond that only one
+                in every `bad_record_log_interval` bad records is
+                described.
+            bad_record_log_interval : int
+                See `bad_record_log_limit`. If zero, no more warnings are
+                logged once the limit is reached.
             num_instances_to_skip : int, optional
                 The number of data instances to skip from the beginning of the
                 dataset.
             num_instances_to_read : int, optional
                 A boolean value indicating whether to shuffle the data instances
                 while reading from the dataset.
+            num_epochs : int, optional
+                The number of times the dataset should be read. If zero, the
+                dataset is read repeatedly. The reader rolls into the next
+                epoch without stopping its background threads; see
+                `Example.epoch` and `Example.end_of_epoch`.
             shard_index : int, optional
                 The index of the shard to read.
             num_shards : int, optional
                 The number of shards the dataset should be split into. The
                 reader will only read 1/num_shards of the dataset.
+            sharding_strategy : ShardingStrategy
+                See ``ShardingStrategy``.
+            coordinator : ShardCoordinator, optional
+                The coordinator to request the data stores or data store
+                ranges to read from, one at a time, instead of reading a
+                static shard.
+            work_item_size : int, optional
+                The size, in bytes, of the data store ranges handed out by
+                the coordinator. If zero, whole data stores are handed out.
             shuffle_instances : bool
                 The number of data instances to buffer and sample from. The
                 selected data instances will be replaced with new data instances
                 read from the dataset.
 
-                A value of zero means perfect shuffling and requires loading the
-                whole dataset into memory first.
+                A value of zero means perfect shuffling. Instances of
+                memory-mapped data stores are read lazily in permuted order,
+                while the rest have to be loaded into memory first.
+            shuffle_window_bytes : int, optional
+                The total payload size, in bytes, of the data instances to
+                buffer and sample from. If specified, the shuffle window is
+                sized in bytes and `shuffle_window` is ignored.
+            shuffle_data_stores : bool, optional
+                A boolean value indicating whether to read the data stores
+                in a random order. Combined with a small `shuffle_window`,
+                this gives an approximate shuffle at a fraction of the
+                memory cost of a large shuffle window.
+            shuffle_block_size : int, optional
+                The number of records in each block of a data store that
+                has a record index. If greater than zero, such data stores
+                are split into blocks that are read in a random order.
             shuffle_window : int
                 The seed that will be used for initializing the sampling
                 distribution. If not specified, a random seed will be generated
@@ -393,6 +1090,15 @@ register_data_readers(py::module &m)
                 Note that, as the size of a dataset is not always known in
                 advance, the ratio will be used as an approximation for the
                 actual amount of data to read.
+            use_record_index : bool, optional
+                A boolean value indicating whether to use the record index of
+                each data store, if available, to seek directly to the next
+                record to read instead of reading and discarding the records
+                that are skipped.
+            enable_checkpointing : bool, optional
+                A boolean value indicating whether the reader should keep
+                track of its position so that it can be saved with
+                `save_state()`.
             header_row_index : int, optional
                 The index of the row that should be treated as the header of the
                 dataset. If specified, the column names will be inferred from
@@ -461,22 +1167,53 @@ register_data_readers(py::module &m)
                mlio::data_reader,
                mlio::intrusive_ptr<mlio::recordio_protobuf_reader>>(
         m, "RecordIOProtobufReader")
+        .def("make_record_index",
+             &mlio::parallel_data_reader::make_record_index,
+             "store"_a,
+             "stride"_a = 1024,
+             py::call_guard<py::gil_scoped_release>(),
+             "Build a ``RecordIndex`` for the specified data store.")
+        .def("make_decoder",
+             &mlio::recordio_protobuf_reader::make_decoder,
+             py::call_guard<py::gil_scoped_release>(),
+             "Constructs an ``ExampleDecoder`` with the schema of the "
+             "dataset.")
         .def(py::init<>(&detail::make_recordio_protobuf_reader),
              "dataset"_a,
              "batch_size"_a,
+             "batch_size_bytes"_a = std::nullopt,
              "num_prefetched_batches"_a = 0,
              "num_parallel_reads"_a = 0,
+             "max_prefetch_bytes"_a = std::nullopt,
+             "autotune"_a = false,
+             "eager_start"_a = false,
+             "transform"_a = nullptr,
+             "output_buffers"_a = nullptr,
+             "max_concurrency"_a = 0,
+             "cpu_affinity"_a = std::vector<std::size_t>{},
+             "priority"_a = mlio::task_priority::normal,
              "last_batch_handling"_a = mlio::last_batch_handling::none,
              "bad_batch_handling"_a = mlio::bad_batch_handling::error,
+             "bad_record_log_limit"_a = 10,
+             "bad_record_log_interval"_a = 1000,
              "num_instances_to_skip"_a = 0,
              "num_instances_to_read"_a = std::nullopt,
+             "num_epochs"_a = 1,
              "shard_index"_a = 0,
              "num_shards"_a = 0,
+             "sharding_strategy"_a = mlio::sharding_strategy::instances,
+             "coordinator"_a = nullptr,
+             "work_item_size"_a = 0,
              "shuffle_instances"_a = false,
              "shuffle_window"_a = 0,
+             "shuffle_window_bytes"_a = std::nullopt,
+             "shuffle_data_stores"_a = false,
+             "shuffle_block_size"_a = 0,
              "shuffle_seed"_a = std::nullopt,
              "reshuffle_each_epoch"_a = false,
              "subsample_ratio"_a = std::nullopt,
+             "use_record_index"_a = false,
+             "enable_checkpointing"_a = false,
              R"(
             Parameters
             ----------
@@ -485,37 +1222,117 @@ register_data_readers(py::module &m)
                 dataset to read from.
             batch_size : int
                 A number indicating how many data instances should be packed
-                into a single ``example``.
+                into a single ``example``. If `batch_size_bytes` is specified,
+                this is the maximum number of data instances in a batch.
+            batch_size_bytes : int, optional
+                The total payload size, in bytes, of the data instances to
+                pack into a single ``example``. If specified, a batch is
+                closed as soon as the size of its data instances reaches this
+                budget and the batch dimension varies from batch to batch.
+                Cannot be combined with ``LastBatchHandling.PAD``.
             num_prefetched_batches : int, optional
                 The number of batches to prefetch in background to accelerate
-                reading. If zero, default to the number of processor cores.
+                reading. If zero, defaults to ``max_concurrency``.
             num_parallel_reads : int, optional
                 The number of parallel batch reads. If not specified, it equals
                 to `num_prefetched_batche`. In case a large number of batches
                 should be prefetched, this parameter can be used to avoid
                 thread oversubscription.
+            max_prefetch_bytes : int, optional
+                The maximum total size, in bytes, of the batches that are
+                being decoded or are waiting to be read. Once exceeded, the
+                reader stops reading ahead until some of the prefetched
+                examples are consumed.
+            autotune : bool, optional
+                A boolean value indicating whether to tune the number of
+                prefetched batches, the number of parallel reads, and the
+                decoding parallelism at runtime based on how long the
+                caller waits for examples. The tuner does not take memory
+                into account; specify `max_prefetch_bytes` to bound the
+                memory used by the prefetched batches.
+            eager_start : bool, optional
+                A boolean value indicating whether to start reading the
+                dataset in background as soon as the reader is constructed
+                rather than on the first read.
+            transform : callable, optional
+                A function that takes a decoded ``Example`` and returns the
+                transformed example, or None to skip it. It runs in parallel
+                on the background threads of the reader. Built-in
+                transforms such as ``make_standardize_transform`` run
+                without holding the GIL; a Python function holds it while
+                running.
+            output_buffers : BufferProvider, optional
+                The provider of the buffers into which the dense features
+                of each batch are decoded. If None, the reader allocates
+                new arrays for every batch.
+            max_concurrency : int, optional
+                The maximum number of threads that can decode batches
+                concurrently. The reader runs in its own thread arena. If
+                zero, defaults to the number of processor cores available
+                to the process, including the limits of its cgroup.
+            cpu_affinity : list of ints, optional
+                The processor cores the background threads of the reader
+                should be pinned to. Only supported on Linux.
+            priority : TaskPriority
+                See ``TaskPriority``.
             last_batch_handling : LastBatchHandling
                 See ``LastBatchHandling``.
             bad_batch_handling : BadBatchHandling
                 See ``BadBatchHandling``.
+            bad_record_log_limit : int
+                The number of bad records that are described in a warning
+                if `bad_batch_handling` is ``WARN``. Beyond that only one
+                in every `bad_record_log_interval` bad records is
+                described.
+            bad_record_log_interval : int
+                See `bad_record_log_limit`. If zero, no more warnings are
+                logged once the limit is reached.
             num_instances_to_skip : int, optional
                 The number of data instances to skip from the beginning of the
                 dataset.
             num_instances_to_read : int, optional
                 A boolean value indicating whether to shuffle the data instances
                 while reading from the dataset.
+            num_epochs : int, optional
+                The number of times the dataset should be read. If zero, the
+                dataset is read repeatedly. The reader rolls into the next
+                epoch without stopping its background threads; see
+                `Example.epoch` and `Example.end_of_epoch`.
             shard_index : int, optional
                 The index of the shard to read.
             num_shards : int, optional
                 The number of shards the dataset should be split into. The
                 reader will only read 1/num_shards of the dataset.
+            sharding_strategy : ShardingStrategy
+                See ``ShardingStrategy``.
+            coordinator : ShardCoordinator, optional
+                The coordinator to request the data stores or data store
+                ranges to read from, one at a time, instead of reading a
+                static shard.
+            work_item_size : int, optional
+                The size, in bytes, of the data store ranges handed out by
+                the coordinator. If zero, whole data stores are handed out.
             shuffle_instances : bool
                 The number of data instances to buffer and sample from. The
                 selected data instances will be replaced with new data instances
                 read from the dataset.
 
-                A value of zero means perfect shuffling and requires loading the
-                whole dataset into memory first.
+                A value of zero means perfect shuffling. Instances of
+                memory-mapped data stores are read lazily in permuted order,
+                while the rest have to be loaded into memory first.
+            shuffle_window_bytes : int, optional
+                The total payload size, in bytes, of the data instances to
+                buffer and sample from. If specified, the shuffle window is
+                sized in bytes and `shuffle_window` is ignored.
+            shuffle_data_stores : bool, optional
+                A boolean value indicating whether to read the data stores
+                in a random order. Combined with a small `shuffle_window`,
+                this gives an approximate shuffle at a fraction of the
+                memory cost of a large shuffle window.
+            shuffle_block_size : int, optional
+                The number of records in each block of a data store that
+                has a record index. If greater than zero, such data stores
+                are split into blocks that are read in a random order.
             shuffle_window : int
                 The seed that will be used for initializing the sampling
                 distribution. If not specified, a random seed will be generated
@@ -531,7 +1348,235 @@ register_data_readers(py::module &m)
                 Note that, as the size of a dataset is not always known in
                 advance, the ratio will be used as an approximation for the
                 actual amount of data to read.
+            use_record_index : bool, optional
+                A boolean value indicating whether to use the record index of
+                each data store, if available, to seek directly to the next
+                record to read instead of reading and discarding the records
+                that are skipped.
+            enable_checkpointing : bool, optional
+                A boolean value indicating whether the reader should keep
+                track of its position so that it can be saved with
+                `save_state()`.
             )");
-}
+
+    py::class_<mlio::rebatching_data_reader,
+               mlio::data_reader,
+               mlio::intrusive_ptr<mlio::rebatching_data_reader>>(
+        m,
+        "RebatchingDataReader",
+        "Represents a ``data_reader`` that regroups the examples of another "
+        "data reader into batches of a different size.")
+        .def(py::init<mlio::intrusive_ptr<mlio::data_reader>,
+                      std::size_t,
+                      mlio::last_batch_handling>(),
+             "reader"_a,
+             "batch_size"_a,
+             "last_batch_handling"_a = mlio::last_batch_handling::none,
+             R"(
+            Parameters
+            ----------
+            reader : DataReader
+                The data reader whose examples should be regrouped.
+            batch_size : int
+                The number of rows in the batch dimension of the returned
+                examples. If a batch falls within a single source example,
+                its tensors are views into the source tensors and no data
+                is copied.
+            last_batch_handling : LastBatchHandling
+                See ``LastBatchHandling``.
+            )");
+
+    py::class_<mlio::mixture_reader,
+               mlio::data_reader,
+               mlio::intrusive_ptr<mlio::mixture_reader>>(
+        m,
+        "MixtureReader",
+        "Represents a ``data_reader`` that mixes the examples of several "
+        "data readers according to sampling weights.")
+        .def(py::init<std::vector<mlio::intrusive_ptr<mlio::data_reader>>,
+                      std::vector<double> const &,
+                      mlio::mixture_granularity,
+                      std::size_t,
+                      mlio::exhaustion_policy,
+                      std::optional<std::uint_fast64_t>,
+                      mlio::last_batch_handling>(),
+             "readers"_a,
+             "weights"_a,
+             "granularity"_a = mlio::mixture_granularity::batch,
+             "batch_size"_a = 0,
+             "exhaustion_policy"_a = mlio::exhaustion_policy::stop,
+             "seed"_a = std::nullopt,
+             "last_batch_handling"_a = mlio::last_batch_handling::none,
+             R"(
+            Parameters
+            ----------
+            readers : list of DataReader
+                The data readers to mix. They should not be used directly
+                once mixed.
+            weights : list of float
+                The sampling weight of each data reader.
+            granularity : MixtureGranularity
+                See ``MixtureGranularity``.
+            batch_size : int, optional
+                The number of rows in the batch dimension of the returned
+                examples. Required with ``MixtureGranularity.INSTANCE``.
+            exhaustion_policy : ExhaustionPolicy
+                See ``ExhaustionPolicy``.
+            seed : int, optional
+                The seed of the random number generator. If not specified,
+                a random seed will be generated internally.
+            last_batch_handling : LastBatchHandling
+                See ``LastBatchHandling``.
+            )");
+
+    py::class_<mlio::data_service_server>(
+        m,
+        "DataServiceServer",
+        "Serves the examples of a data reader to ``DataServiceReader`` "
+        "clients in other processes on the same host.")
+        .def(py::init<std::string,
+                      mlio::intrusive_ptr<mlio::data_reader>,
+                      std::size_t,
+                      mlio::fanout_policy,
+                      std::size_t>(),
+             "pathname"_a,
+             "reader"_a,
+             "num_clients"_a,
+             "policy"_a = mlio::fanout_policy::work_stealing,
+             "channel_capacity"_a = 0x400'0000,
+             R"(
+            Parameters
+            ----------
+            pathname : str
+                The pathname of the Unix domain socket to listen on.
+            reader : DataReader
+                The data reader whose examples to serve.
+            num_clients : int
+                The maximum number of clients that can be connected at the
+                same time.
+            policy : FanoutPolicy
+                Whether the clients get disjoint subsets of the dataset or
+                the same stream. See ``FanoutPolicy``.
+            channel_capacity : int, optional
+                The size, in bytes, of the shared memory ring buffer of
+                each client.
+            )")
+        .def("serve",
+             &mlio::data_service_server::serve,
+             py::call_guard<py::gil_scoped_release>(),
+             "Accepts and serves connections until ``stop()`` is called.")
+        .def("stop",
+             &mlio::data_service_server::stop,
+             py::call_guard<py::gil_scoped_release>(),
+             "Stops the server and closes all connections.");
+
+    py::class_<mlio::data_service_reader,
+               mlio::data_reader,
+               mlio::intrusive_ptr<mlio::data_service_reader>>(
+        m,
+        "DataServiceReader",
+        "Represents a ``DataReader`` that reads the examples served by a "
+        "``DataServiceServer``.")
+        .def(py::init<std::string>(),
+             "pathname"_a,
+             R"(
+            Parameters
+            ----------
+            pathname : str
+                The pathname of the Unix domain socket of the server.
+            )");
+
+    m.def("make_fanout_readers",
+          &mlio::make_fanout_readers,
+          "reader"_a,
+          "num_consumers"_a,
+          "policy"_a = mlio::fanout_policy::round_robin,
+          "max_queue_size"_a = 1,
+          R"(
+        Returns consumer handles that share a single data reader.
+
+        Each handle is a ``DataReader`` that returns a distinct subset, or
+        with ``FanoutPolicy.BROADCAST`` all, of the examples read by the
+        shared reader, so that several consumers can read from one decode
+        pipeline.
+
+        Parameters
+        ----------
+        reader : DataReader
+            The data reader to share. It should not be used directly once
+            shared.
+        num_consumers : int
+            The number of consumer handles to return.
+        policy : FanoutPolicy
+            See ``FanoutPolicy``.
+        max_queue_size : int, optional
+            The maximum number of examples buffered for a consumer that is
+            not reading when its turn comes.
+        )");
+
+    m.def("compose_transforms",
+          &mlio::compose_transforms,
+          "transforms"_a,
+          R"(
+        Returns a transform that applies the specified transforms in order.
+
+        Parameters
+        ----------
+        transforms : list of callables
+            The transforms to apply. If one of them skips an example, the
+            remaining ones are not called.
+        )");
+
+    m.def("make_standardize_transform",
+          &mlio::make_standardize_transform,
+          "feature_name"_a,
+          "mean"_a,
+          "stddev"_a,
+          R"(
+        Returns a transform that standardizes the values of a feature.
+
+        Parameters
+        ----------
+        feature_name : str
+            The name of the numeric feature to standardize.
+        mean : float
+            The mean to subtract from each value.
+        stddev : float
+            The standard deviation to divide each value by.
+        )");
+
+    m.def("make_clip_transform",
+          &mlio::make_clip_transform,
+          "feature_name"_a,
+          "min_value"_a,
+          "max_value"_a,
+          R"(
+        Returns a transform that clips the values of a feature.
+
+        Parameters
+        ----------
+        feature_name : str
+            The name of the numeric feature to clip.
+        min_value : float
+            The lower bound of the values.
+        max_value : float
+            The upper bound of the values.
+        )");
+
+    m.def("make_remap_transform",
+          &mlio::make_remap_transform,
+          "feature_name"_a,
+          "mapping"_a,
+          R"(
+        Returns a transform that maps the values of a feature to new values.
+
+        Parameters
+        ----------
+        feature_name : str
+            The name of the numeric feature to remap.
+        mapping : dict
+            The mapping from old to new values. Values not in the mapping
+            are kept as is.
+        )");
 
 }  // namespace mliopy
@@ -105,7 +105,15 @@ register_example(py::module &m)
             zero-initialized. This is typically the case for the last
             batch read from a dataset if the size of the dataset is not
             evenly divisible by the batch size.
-            )");
+            )")
+        .def_readwrite("epoch",
+                       &mlio::example::epoch,
+                       "Gets the zero-based index of the epoch in which the "
+                       "example has been read.")
+        .def_readwrite("end_of_epoch",
+                       &mlio::example::end_of_epoch,
+                       "Gets a boolean value indicating whether the example "
+                       "is the last one of its epoch.");
 }
 
 }  // namespace mliopy
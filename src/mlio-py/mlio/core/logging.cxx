@@ -87,6 +87,13 @@ register_logging(py::module &m)
           "Sets the logging handler.");
 
     m.def("clear_log_message_handler", []() {
+        {
+            // The background thread needs the GIL to call the handler.
+            py::gil_scoped_release rel_gil{};
+
+            mlio::stop_async_logging();
+        }
+
         mlio::set_log_message_handler(nullptr);
     });
 
@@ -92,6 +92,16 @@ register_record_readers(py::module &m)
         .def("peek_record",
              &mlio::record_reader::peek_record,
              py::call_guard<py::gil_scoped_release>())
+        .def("seek",
+             &mlio::record_reader::seek,
+             "position"_a,
+             py::call_guard<py::gil_scoped_release>())
+        .def("seek_to_record_boundary",
+             &mlio::record_reader::seek_to_record_boundary,
+             "position"_a,
+             py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("position", &mlio::record_reader::position)
+        .def_property_readonly("seekable", &mlio::record_reader::seekable)
         .def("__iter__", [](py::object &rdr) {
             return detail::py_record_iterator(
                 rdr.cast<mlio::record_reader &>(), rdr);
@@ -104,6 +114,55 @@ register_record_readers(py::module &m)
         "ParquetRecordReader",
         "Represents a ``record_reader`` for reading Parquet records.")
         .def(py::init<mlio::intrusive_ptr<mlio::input_stream>>(), "strm"_a);
+
+    py::class_<mlio::record_index>(
+        m,
+        "RecordIndex",
+        "Represents an index of the byte positions of the records of a data "
+        "store.")
+        .def(py::init<std::size_t,
+                      std::vector<std::size_t>,
+                      std::size_t,
+                      std::optional<std::size_t>>(),
+             "stride"_a,
+             "positions"_a,
+             "num_records"_a,
+             "data_size"_a = std::nullopt)
+        .def("lookup",
+             &mlio::record_index::lookup,
+             "record_index"_a,
+             "Return the index and the byte position of the closest indexed "
+             "record that is at or before the specified record.")
+        .def_property_readonly("stride", &mlio::record_index::stride)
+        .def_property_readonly("positions", &mlio::record_index::positions)
+        .def_property_readonly("num_records", &mlio::record_index::num_records)
+        .def_property_readonly("data_size", &mlio::record_index::data_size);
+
+    m.def("make_record_index",
+          &mlio::make_record_index,
+          "reader"_a,
+          "stride"_a = 1024,
+          "data_size"_a = std::nullopt,
+          py::call_guard<py::gil_scoped_release>(),
+          "Build a ``RecordIndex`` by reading all remaining records from the "
+          "specified record reader.");
+
+    m.def("save_record_index",
+          &mlio::save_record_index,
+          "index"_a,
+          "pathname"_a,
+          "Save the specified ``RecordIndex`` to a file.");
+
+    m.def("load_record_index",
+          &mlio::load_record_index,
+          "pathname"_a,
+          "Load a ``RecordIndex`` from a file.");
+
+    m.def("get_record_index_pathname",
+          &mlio::get_record_index_pathname,
+          "pathname"_a,
+          "Return the pathname of the record index sidecar of the specified "
+          "file.");
 }
 
 }  // namespace mliopy
@@ -0,0 +1,129 @@
+# Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"). You
+# may not use this file except in compliance with the License. A copy of
+# the License is located at
+#
+#      http://aws.amazon.com/apache2.0/
+#
+# or in the "license" file accompanying this file. This file is
+# distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+# ANY KIND, either express or implied. See the License for the specific
+# language governing permissions and limitations under the License.
+
+"""
+Runs a data service as a standalone process.
+
+The service decodes a dataset once and serves the examples to the
+trainer processes on the same host, which read them through
+``DataServiceReader(pathname)``:
+
+    mlio-serve --format csv --batch-size 256 --num-clients 8 \\
+        /tmp/mlio-data.sock /data/train
+"""
+
+import argparse
+import signal
+import threading
+
+from mlio.core import\
+    CsvReader,\
+    DataServiceServer,\
+    FanoutPolicy,\
+    list_files,\
+    RecordIOProtobufReader
+
+
+def _make_reader(args):
+    dataset = list_files(args.pathnames, pattern=args.pattern)
+
+    kwargs = dict(dataset=dataset,
+                  batch_size=args.batch_size,
+                  num_prefetched_batches=args.num_prefetched_batches,
+                  num_parallel_reads=args.num_parallel_reads,
+                  num_epochs=args.num_epochs,
+                  shuffle_instances=args.shuffle_instances)
+
+    if args.format == "csv":
+        return CsvReader(**kwargs)
+    return RecordIOProtobufReader(**kwargs)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(
+        description="Decodes a dataset once and serves its examples to "
+                    "the data readers of several processes.")
+    parser.add_argument("pathname",
+                        help="The pathname of the Unix domain socket to "
+                             "listen on.")
+    parser.add_argument("pathnames",
+                        nargs="+",
+                        help="The files or directories to read.")
+    parser.add_argument("--format",
+                        choices=["csv", "recordio-protobuf"],
+                        default="csv",
+                        help="The format of the dataset.")
+    parser.add_argument("--pattern",
+                        default="",
+                        help="The glob pattern the files should match.")
+    parser.add_argument("--batch-size",
+                        type=int,
+                        required=True,
+                        help="The number of instances per example.")
+    parser.add_argument("--num-clients",
+                        type=int,
+                        required=True,
+                        help="The maximum number of connected clients.")
+    parser.add_argument("--policy",
+                        choices=["work-stealing", "round-robin",
+                                 "broadcast"],
+                        default="work-stealing",
+                        help="Whether the clients get disjoint subsets of "
+                             "the dataset or the same stream.")
+    parser.add_argument("--channel-capacity",
+                        type=int,
+                        default=0x400_0000,
+                        help="The size, in bytes, of the shared memory "
+                             "ring buffer of each client.")
+    parser.add_argument("--num-prefetched-batches", type=int, default=0)
+    parser.add_argument("--num-parallel-reads", type=int, default=0)
+    parser.add_argument("--num-epochs", type=int, default=1)
+    parser.add_argument("--shuffle-instances", action="store_true")
+
+    args = parser.parse_args(argv)
+
+    policy = {
+        "work-stealing": FanoutPolicy.WORK_STEALING,
+        "round-robin": FanoutPolicy.ROUND_ROBIN,
+        "broadcast": FanoutPolicy.BROADCAST,
+    }[args.policy]
+
+    server = DataServiceServer(args.pathname,
+                               _make_reader(args),
+                               args.num_clients,
+                               policy,
+                               args.channel_capacity)
+
+    # The server blocks in native code, so it runs in a background thread
+    # while the main thread waits for a termination signal.
+    thread = threading.Thread(target=server.serve)
+    thread.start()
+
+    stop_event = threading.Event()
+
+    def handle_signal(signum, frame):
+        stop_event.set()
+
+    signal.signal(signal.SIGINT, handle_signal)
+    signal.signal(signal.SIGTERM, handle_signal)
+
+    while not stop_event.wait(1.0) and thread.is_alive():
+        pass
+
+    server.stop()
+
+    thread.join()
+
+
+if __name__ == "__main__":
+    main()
@@ -83,6 +83,9 @@ setup(distclass=Distribution,
           'mxnet': ['mxnet>=1.4.1'],
           'pyarrow': ['pyarrow==0.15.1'],
       },
+      entry_points={
+          'console_scripts': ['mlio-serve=mlio.serve:main'],
+      },
       cmdclass={
           'install': install,
       })
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/array_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "mlio/cpu_array.h"
+#include "mlio/device.h"
+#include "mlio/intrusive_ptr.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+template<data_type dt>
+struct element_size_op {
+    std::size_t
+    operator()() const noexcept
+    {
+        return sizeof(data_type_t<dt>);
+    }
+};
+
+}  // namespace
+
+class array_pool::pooled_array final : public device_array {
+public:
+    explicit pooled_array(intrusive_ptr<array_pool> pool,
+                          buffer &&buf,
+                          data_type dt,
+                          std::size_t size) noexcept
+        : pool_{std::move(pool)}, buffer_{std::move(buf)}, data_type_{dt}
+        , size_{size}
+    {}
+
+    pooled_array(pooled_array const &) = delete;
+
+    pooled_array(pooled_array &&) = delete;
+
+    ~pooled_array() final
+    {
+        pool_->release(std::move(buffer_));
+    }
+
+public:
+    pooled_array &
+    operator=(pooled_array const &) = delete;
+
+    pooled_array &
+    operator=(pooled_array &&) = delete;
+
+public:
+    std::unique_ptr<device_array>
+    clone() const final
+    {
+        auto arr = make_cpu_array(data_type_, size_);
+
+        std::size_t num_bytes = size_ * dispatch<element_size_op>(data_type_);
+
+        std::copy_n(buffer_.data.get(), num_bytes, as_bytes(*arr));
+
+        return arr;
+    }
+
+public:
+    void *
+    data() noexcept final
+    {
+        return buffer_.data.get();
+    }
+
+    void const *
+    data() const noexcept final
+    {
+        return buffer_.data.get();
+    }
+
+    std::size_t
+    size() const noexcept final
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool
+    empty() const noexcept final
+    {
+        return size_ == 0;
+    }
+
+    data_type
+    dtype() const noexcept final
+    {
+        return data_type_;
+    }
+
+    device
+    get_device() const noexcept final
+    {
+        return device{device_kind::cpu()};
+    }
+
+private:
+    static std::byte *
+    as_bytes(device_array &arr) noexcept
+    {
+        return static_cast<std::byte *>(arr.data());
+    }
+
+private:
+    intrusive_ptr<array_pool> pool_;
+    buffer buffer_;
+    data_type data_type_;
+    std::size_t size_;
+};
+
+std::unique_ptr<device_array>
+array_pool::make_array(data_type dt, std::size_t size)
+{
+    if (dt == data_type::string) {
+        return make_cpu_array(dt, size);
+    }
+
+    buffer buf = acquire(size * dispatch<element_size_op>(dt));
+
+    return std::make_unique<pooled_array>(
+        intrusive_ptr<array_pool>{this}, std::move(buf), dt, size);
+}
+
+auto
+array_pool::acquire(std::size_t num_bytes) -> buffer
+{
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        // Pick the smallest buffer that fits; the decoders mostly ask
+        // for a handful of recurring sizes.
+        auto pos = buffers_.end();
+        for (auto it = buffers_.begin(); it < buffers_.end(); ++it) {
+            if (it->size >= num_bytes &&
+                (pos == buffers_.end() || it->size < pos->size)) {
+                pos = it;
+            }
+        }
+
+        if (pos != buffers_.end()) {
+            buffer buf = std::move(*pos);
+
+            buffers_.erase(pos);
+
+            return buf;
+        }
+    }
+
+    // Allocate at least one byte so that the data pointer of an empty
+    // array is never null.
+    std::size_t size = std::max(num_bytes, std::size_t{1});
+
+    return buffer{std::make_unique<std::byte[]>(size), size};
+}
+
+void
+array_pool::release(buffer &&buf) noexcept
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    if (buffers_.size() < max_num_buffers_) {
+        buffers_.emplace_back(std::move(buf));
+    }
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
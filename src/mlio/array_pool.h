@@ -0,0 +1,69 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "mlio/data_type.h"
+#include "mlio/device_array.h"
+#include "mlio/intrusive_ref_counter.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+// Allocates CPU arrays whose buffers are handed back to the pool once
+// the arrays are destructed, so that the decoders that produce many
+// small examples of the same shape do not hit the heap on every call.
+// The arrays keep the pool alive; it can safely be shared by multiple
+// threads.
+class array_pool final : public intrusive_ref_counter<array_pool> {
+    struct buffer {
+        std::unique_ptr<std::byte[]> data{};
+        std::size_t size{};
+    };
+
+    class pooled_array;
+
+public:
+    explicit array_pool(std::size_t max_num_buffers = 64) noexcept
+        : max_num_buffers_{max_num_buffers}
+    {}
+
+public:
+    // Arrays of strings are never pooled.
+    std::unique_ptr<device_array>
+    make_array(data_type dt, std::size_t size);
+
+private:
+    buffer
+    acquire(std::size_t num_bytes);
+
+    void
+    release(buffer &&buf) noexcept;
+
+private:
+    std::size_t max_num_buffers_;
+    std::mutex mutex_{};
+    std::vector<buffer> buffers_{};
+};
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
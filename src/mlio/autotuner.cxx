@@ -0,0 +1,132 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/autotuner.h"
+
+#include <algorithm>
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+// The minimum wall-clock time between two tuning decisions.
+constexpr std::chrono::milliseconds tuning_interval{100};
+
+// The consumer is considered starved if it waits for more than
+// 1/starvation_ratio of the time.
+constexpr std::int64_t starvation_ratio = 20;
+
+// Below this number of values the threading overhead of a parallel
+// decode outweighs its benefit regardless of how idle the arena is.
+constexpr std::size_t min_parallel_decode_values = 100'000;
+
+}  // namespace
+
+autotuner::autotuner(std::size_t max_concurrency,
+                     std::size_t num_prefetched_batches,
+                     std::size_t num_parallel_reads) noexcept
+    : max_concurrency_{std::max(max_concurrency, std::size_t{1})}
+    , max_num_prefetched_batches_{
+          std::max(num_prefetched_batches, 2 * max_concurrency_)}
+    , max_num_parallel_reads_{std::max(num_parallel_reads, max_concurrency_)}
+    , num_prefetched_batches_{std::max(num_prefetched_batches, std::size_t{1})}
+    , num_parallel_reads_{std::clamp(
+          num_parallel_reads, std::size_t{1}, num_prefetched_batches_.load())}
+    , interval_start_{clock::now()}
+{}
+
+bool
+autotuner::update(std::chrono::nanoseconds wait_time) noexcept
+{
+    interval_wait_time_ += wait_time;
+
+    clock::time_point now = clock::now();
+
+    auto elapsed = now - interval_start_;
+    if (elapsed < tuning_interval) {
+        return false;
+    }
+
+    bool starved = interval_wait_time_.count() * starvation_ratio >
+                   std::chrono::nanoseconds{elapsed}.count();
+
+    interval_start_ = now;
+
+    interval_wait_time_ = {};
+
+    if (!starved) {
+        return false;
+    }
+
+    bool changed = false;
+
+    std::size_t num_prefetched = num_prefetched_batches();
+    if (num_prefetched < max_num_prefetched_batches_) {
+        num_prefetched_batches_.store(++num_prefetched,
+                                      std::memory_order_relaxed);
+
+        changed = true;
+    }
+
+    std::size_t num_reads = num_parallel_reads();
+
+    std::int64_t read_time = avg_read_time_.load(std::memory_order_relaxed);
+    std::int64_t decode_time =
+        avg_decode_time_.load(std::memory_order_relaxed);
+
+    // If the decode stage converts batches more slowly than the source
+    // stage reads them, more batches should be decoded concurrently;
+    // otherwise the source stage is the bottleneck and more parallel
+    // reads would only oversubscribe the arena.
+    bool decode_bound =
+        decode_time > read_time * static_cast<std::int64_t>(num_reads);
+
+    if (decode_bound && num_reads < max_num_parallel_reads_ &&
+        num_reads < num_prefetched) {
+        num_parallel_reads_.store(++num_reads, std::memory_order_relaxed);
+
+        changed = true;
+    }
+
+    return changed;
+}
+
+void
+autotuner::reset() noexcept
+{
+    interval_start_ = clock::now();
+
+    interval_wait_time_ = {};
+
+    num_active_decodes_.store(0, std::memory_order_relaxed);
+}
+
+bool
+autotuner::should_decode_in_parallel(std::size_t num_values) const noexcept
+{
+    if (num_values < min_parallel_decode_values) {
+        return false;
+    }
+
+    std::size_t num_active =
+        num_active_decodes_.load(std::memory_order_relaxed);
+
+    return num_active * 2 <= max_concurrency_;
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+// Tunes the prefetch depth, the number of parallel batch reads, and the
+// choice between serial and parallel decoding of a data reader at
+// runtime.
+//
+// The tuner is a simple hill climber. At the end of each interval it
+// checks the fraction of time the consumer has spent waiting for
+// examples; if the consumer was starved, it compares the rate at which
+// the source stage reads batches with the rate at which the decode
+// stage can convert them and raises the number of parallel reads if
+// decoding is the bottleneck. The prefetch depth is raised in either
+// case to absorb the jitter of the slower stage. The limits are never
+// lowered, so the tuner settles once the consumer stops waiting.
+class autotuner {
+public:
+    using clock = std::chrono::steady_clock;
+
+public:
+    explicit autotuner(std::size_t max_concurrency,
+                       std::size_t num_prefetched_batches,
+                       std::size_t num_parallel_reads) noexcept;
+
+public:
+    // Called by the source stage after reading a batch.
+    void
+    add_batch_read_time(std::chrono::nanoseconds value) noexcept
+    {
+        update_average(avg_read_time_, value);
+    }
+
+    // Called concurrently by the decode stage.
+    void
+    begin_decode() noexcept
+    {
+        num_active_decodes_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void
+    end_decode(std::chrono::nanoseconds value) noexcept
+    {
+        num_active_decodes_.fetch_sub(1, std::memory_order_relaxed);
+
+        update_average(avg_decode_time_, value);
+    }
+
+    // Called by the consumer thread each time it has waited for the
+    // prefetch queue. Returns true if any of the limits have been
+    // raised.
+    bool
+    update(std::chrono::nanoseconds wait_time) noexcept;
+
+    // Restarts the current tuning interval. The tuned limits are kept
+    // across epochs.
+    void
+    reset() noexcept;
+
+    // Indicates whether a batch with the specified number of values
+    // should be decoded in parallel. A batch is only split into tasks
+    // if it is large enough and if at least half of the arena is idle;
+    // otherwise the other batches in flight already keep the cores
+    // busy.
+    bool
+    should_decode_in_parallel(std::size_t num_values) const noexcept;
+
+    std::size_t
+    num_prefetched_batches() const noexcept
+    {
+        return num_prefetched_batches_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t
+    num_parallel_reads() const noexcept
+    {
+        return num_parallel_reads_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t
+    max_num_parallel_reads() const noexcept
+    {
+        return max_num_parallel_reads_;
+    }
+
+private:
+    // Keeps an exponential moving average. Concurrent updates might be
+    // lost, which is acceptable for an estimate.
+    static void
+    update_average(std::atomic<std::int64_t> &avg,
+                   std::chrono::nanoseconds value) noexcept
+    {
+        std::int64_t old = avg.load(std::memory_order_relaxed);
+        if (old == 0) {
+            avg.store(value.count(), std::memory_order_relaxed);
+        }
+        else {
+            avg.store(old + (value.count() - old) / 8,
+                      std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::size_t max_concurrency_;
+    std::size_t max_num_prefetched_batches_;
+    std::size_t max_num_parallel_reads_;
+    std::atomic<std::size_t> num_prefetched_batches_;
+    std::atomic<std::size_t> num_parallel_reads_;
+    std::atomic<std::size_t> num_active_decodes_{};
+    std::atomic<std::int64_t> avg_read_time_{};
+    std::atomic<std::int64_t> avg_decode_time_{};
+    clock::time_point interval_start_;
+    std::chrono::nanoseconds interval_wait_time_{};
+};
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/bad_record_reporter.h"
+
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/logger.h"
+#include "mlio/pipeline_statistics.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+bool
+bad_record_reporter::add_bad_record() noexcept
+{
+    if (stats_ != nullptr) {
+        stats_->add_bad_record();
+    }
+
+    switch (hnd_) {
+    case bad_batch_handling::error:
+        return true;
+
+    case bad_batch_handling::skip:
+        return false;
+
+    case bad_batch_handling::warn:
+        break;
+    }
+
+    std::size_t idx = num_bad_records_.fetch_add(1, std::memory_order_relaxed);
+    if (idx < limit_) {
+        if (idx + 1 == limit_) {
+            limit_reached_ = true;
+        }
+        return true;
+    }
+
+    if (interval_ != 0 && (idx - limit_ + 1) % interval_ == 0) {
+        return true;
+    }
+
+    num_suppressed_.fetch_add(1, std::memory_order_relaxed);
+
+    return false;
+}
+
+void
+bad_record_reporter::report(std::string msg)
+{
+    if (hnd_ == bad_batch_handling::error) {
+        throw invalid_instance_error{msg};
+    }
+
+    std::size_t num_suppressed =
+        num_suppressed_.exchange(0, std::memory_order_relaxed);
+
+    if (num_suppressed > 0) {
+        msg += fmt::format(" {0:n} similar warning(s) have been suppressed.",
+                           num_suppressed);
+    }
+
+    if (limit_reached_.exchange(false)) {
+        if (interval_ == 0) {
+            msg += " No further bad records will be reported.";
+        }
+        else {
+            msg += fmt::format(
+                " Further bad records will be reported once in every {0:n}.",
+                interval_);
+        }
+    }
+
+    logger::warn_async(std::move(msg));
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
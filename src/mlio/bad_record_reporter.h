@@ -0,0 +1,77 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+#include "mlio/data_reader.h"
+#include "mlio/fwd.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+// Counts the records of a data reader that cannot be decoded and
+// decides which of them are worth a detailed description. The first
+// few bad records are always described; after that only a sample of
+// them, so that a dirty dataset does not spend its time formatting
+// and logging messages. The warnings are logged asynchronously. All
+// member functions can be called concurrently.
+class bad_record_reporter {
+public:
+    explicit bad_record_reporter(data_reader_params const &prm,
+                                 bad_batch_handling hnd,
+                                 pipeline_statistics *stats = nullptr) noexcept
+        : hnd_{hnd}
+        , limit_{prm.bad_record_log_limit}
+        , interval_{prm.bad_record_log_interval}
+        , stats_{stats}
+    {}
+
+public:
+    // Counts a bad record. Returns true if the caller should describe
+    // the record by calling report(), which is always the case if the
+    // bad batch handling is error, and only for a sample of the bad
+    // records if it is warn.
+    bool
+    add_bad_record() noexcept;
+
+    // Throws an invalid_instance_error with the specified description
+    // or logs it, depending on the bad batch handling.
+    void
+    report(std::string msg);
+
+    bad_batch_handling
+    handling() const noexcept
+    {
+        return hnd_;
+    }
+
+private:
+    bad_batch_handling hnd_;
+    std::size_t limit_;
+    std::size_t interval_;
+    pipeline_statistics *stats_;
+    std::atomic<std::size_t> num_bad_records_{};
+    std::atomic<std::size_t> num_suppressed_{};
+    std::atomic_bool limit_reached_{};
+};
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
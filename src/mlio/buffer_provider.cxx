@@ -0,0 +1,203 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/buffer_provider.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "mlio/cpu_array.h"
+#include "mlio/device.h"
+#include "mlio/schema.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+template<data_type dt>
+struct element_size_op {
+    std::size_t
+    operator()() const noexcept
+    {
+        return sizeof(data_type_t<dt>);
+    }
+};
+
+class external_array final : public device_array {
+public:
+    explicit external_array(data_type dt,
+                            void *data,
+                            std::size_t size,
+                            std::function<void()> &&on_release) noexcept
+        : data_type_{dt}
+        , data_{data}
+        , size_{size}
+        , on_release_{std::move(on_release)}
+    {}
+
+    external_array(external_array const &) = delete;
+
+    external_array(external_array &&) = delete;
+
+    ~external_array() final
+    {
+        if (on_release_) {
+            on_release_();
+        }
+    }
+
+public:
+    external_array &
+    operator=(external_array const &) = delete;
+
+    external_array &
+    operator=(external_array &&) = delete;
+
+public:
+    std::unique_ptr<device_array>
+    clone() const final
+    {
+        auto arr = make_cpu_array(data_type_, size_);
+
+        std::size_t num_bytes = size_ * dispatch<element_size_op>(data_type_);
+
+        std::copy_n(static_cast<std::byte const *>(data_),
+                    num_bytes,
+                    static_cast<std::byte *>(arr->data()));
+
+        return arr;
+    }
+
+public:
+    void *
+    data() noexcept final
+    {
+        return data_;
+    }
+
+    void const *
+    data() const noexcept final
+    {
+        return data_;
+    }
+
+    std::size_t
+    size() const noexcept final
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool
+    empty() const noexcept final
+    {
+        return size_ == 0;
+    }
+
+    data_type
+    dtype() const noexcept final
+    {
+        return data_type_;
+    }
+
+    device
+    get_device() const noexcept final
+    {
+        return device{device_kind::cpu()};
+    }
+
+private:
+    data_type data_type_;
+    void *data_;
+    std::size_t size_;
+    std::function<void()> on_release_;
+};
+
+}  // namespace
+}  // namespace detail
+
+buffer_provider::~buffer_provider() = default;
+
+std::unique_ptr<device_array>
+buffer_provider::acquire_array(feature_desc const &desc,
+                               std::size_t batch_size)
+{
+    // Strings are decoded into std::string objects that are of no use
+    // to a caller-provided buffer.
+    if (desc.sparse() || desc.dtype() == data_type::string) {
+        return nullptr;
+    }
+
+    std::unique_ptr<device_array> arr = acquire_array_core(desc, batch_size);
+    if (arr == nullptr) {
+        return nullptr;
+    }
+
+    if (arr->get_device().kind() != device_kind::cpu()) {
+        throw std::invalid_argument{fmt::format(
+            "The buffer provided for the feature '{0}' does not reside in "
+            "the main memory.",
+            desc.name())};
+    }
+
+    if (arr->dtype() != desc.dtype()) {
+        throw std::invalid_argument{fmt::format(
+            "The buffer provided for the feature '{0}' has the data type "
+            "{1}, while the expected data type is {2}.",
+            desc.name(),
+            arr->dtype(),
+            desc.dtype())};
+    }
+
+    std::size_t size = batch_size * as_size(desc.strides()[0]);
+    if (arr->size() != size) {
+        throw std::invalid_argument{fmt::format(
+            "The buffer provided for the feature '{0}' has {1:n} element(s), "
+            "while the expected number of elements is {2:n}.",
+            desc.name(),
+            arr->size(),
+            size)};
+    }
+
+    return arr;
+}
+
+std::unique_ptr<device_array>
+wrap_external_array(data_type dt,
+                    void *data,
+                    std::size_t size,
+                    std::function<void()> on_release)
+{
+    if (dt == data_type::string) {
+        throw std::invalid_argument{
+            "An array of strings cannot be wrapped as an external array."};
+    }
+
+    if (data == nullptr && size > 0) {
+        throw std::invalid_argument{
+            "The external array must not be null unless its size is zero."};
+    }
+
+    return std::make_unique<detail::external_array>(
+        dt, data, size, std::move(on_release));
+}
+
+}  // namespace v1
+}  // namespace mlio
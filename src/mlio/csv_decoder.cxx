@@ -0,0 +1,286 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/csv_decoder.h"
+
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "mlio/array_pool.h"
+#include "mlio/csv_record_tokenizer.h"
+#include "mlio/example.h"
+#include "mlio/tensor.h"
+#include "mlio/tensor_rows.h"
+
+using mlio::detail::csv_record_tokenizer;
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+bool
+ends_with(memory_span row, char c) noexcept
+{
+    return !row.empty() && *(row.end() - 1) == static_cast<std::byte>(c);
+}
+
+// Strips the line terminator, if any, from the specified row.
+memory_span
+trim_line_end(memory_span row) noexcept
+{
+    if (ends_with(row, '\n')) {
+        row = row.first(row.size() - 1);
+
+        if (ends_with(row, '\r')) {
+            row = row.first(row.size() - 1);
+        }
+    }
+    return row;
+}
+
+}  // namespace
+}  // namespace detail
+
+csv_decoder::csv_decoder(csv_params prm, std::size_t batch_size)
+    : params_{std::move(prm)}
+    , batch_size_{batch_size}
+    , pool_{make_intrusive<detail::array_pool>()}
+{
+    init_column_types();
+
+    init_parsers_and_schema();
+}
+
+csv_decoder::~csv_decoder() = default;
+
+void
+csv_decoder::init_column_types()
+{
+    std::vector<std::string> const &names = params_.column_names;
+    if (names.empty()) {
+        throw std::invalid_argument{
+            "The column names must be specified to decode CSV rows without "
+            "a dataset."};
+    }
+
+    auto idx_overrides = params_.column_types_by_index;
+
+    auto name_overrides = params_.column_types;
+
+    column_types_.reserve(names.size());
+
+    for (std::size_t idx = 0; idx < names.size(); idx++) {
+        std::optional<data_type> dt = params_.default_data_type;
+
+        // Same as in csv_reader, a type specified by name takes
+        // precedence over a type specified by index.
+        auto idx_type_pos = idx_overrides.find(idx);
+        if (idx_type_pos != idx_overrides.end()) {
+            dt = idx_type_pos->second;
+
+            idx_overrides.erase(idx_type_pos);
+        }
+
+        auto name_type_pos = name_overrides.find(names[idx]);
+        if (name_type_pos != name_overrides.end()) {
+            dt = name_type_pos->second;
+
+            name_overrides.erase(name_type_pos);
+        }
+
+        if (dt == std::nullopt) {
+            throw std::invalid_argument{fmt::format(
+                "The data type of the column '{0}' is not specified. Either a "
+                "default data type or a column type must be set.",
+                names[idx])};
+        }
+
+        column_types_.emplace_back(*dt);
+    }
+
+    if (!idx_overrides.empty()) {
+        std::vector<std::size_t> extra_inds;
+        extra_inds.reserve(idx_overrides.size());
+
+        for (auto &pr : idx_overrides) {
+            extra_inds.emplace_back(pr.first);
+        }
+
+        throw std::invalid_argument{fmt::format(
+            "The column types cannot be set. The following column indices "
+            "are out of range: {0}",
+            fmt::join(extra_inds, ", "))};
+    }
+
+    if (!name_overrides.empty()) {
+        std::vector<std::string> extra_names;
+        extra_names.reserve(name_overrides.size());
+
+        for (auto &pr : name_overrides) {
+            extra_names.emplace_back(pr.first);
+        }
+
+        throw std::invalid_argument{fmt::format(
+            "The column types cannot be set. The following columns are not "
+            "found in the column names: {0}",
+            fmt::join(extra_names, ", "))};
+    }
+}
+
+void
+csv_decoder::init_parsers_and_schema()
+{
+    std::vector<feature_desc> descs{};
+
+    std::size_t num_columns = column_types_.size();
+
+    for (std::size_t idx = 0; idx < num_columns; idx++) {
+        std::string const &name = params_.column_names[idx];
+
+        data_type dt = column_types_[idx];
+
+        if (should_skip(idx, name)) {
+            skipped_columns_.emplace_back(1);
+
+            column_parsers_.emplace_back(nullptr);
+        }
+        else {
+            skipped_columns_.emplace_back(0);
+
+            column_parsers_.emplace_back(make_parser(dt, params_.parser_prm));
+
+            descs.emplace_back(
+                feature_desc_builder{name, dt, {batch_size_}}.build());
+        }
+    }
+
+    schema_ = make_intrusive<schema>(std::move(descs));
+}
+
+bool
+csv_decoder::should_skip(std::size_t index, std::string const &name) const
+    noexcept
+{
+    auto &use_cols_idx = params_.use_columns_by_index;
+    if (!use_cols_idx.empty()) {
+        if (use_cols_idx.find(index) == use_cols_idx.end()) {
+            return true;
+        }
+    }
+
+    auto &use_cols_name = params_.use_columns;
+    if (!use_cols_name.empty()) {
+        if (use_cols_name.find(name) == use_cols_name.end()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+decode_result
+csv_decoder::decode(stdx::span<memory_span const> records) const
+{
+    std::size_t num_records = records.size();
+
+    auto tensors = make_tensors(num_records);
+
+    for (std::size_t row_idx = 0; row_idx < num_records; row_idx++) {
+        if (!decode_row(records[row_idx], tensors, row_idx)) {
+            return {decode_status::invalid_record, nullptr, row_idx};
+        }
+    }
+
+    intrusive_ptr<schema> shm = schema_;
+    if (num_records != batch_size_) {
+        shm = detail::make_batch_schema(*schema_, num_records);
+    }
+
+    auto exm = make_intrusive<example>(std::move(shm), std::move(tensors));
+
+    return {decode_status::ok, std::move(exm), 0};
+}
+
+bool
+csv_decoder::decode_row(memory_span row,
+                        std::vector<intrusive_ptr<tensor>> &tensors,
+                        std::size_t row_idx) const
+{
+    std::size_t num_columns = column_types_.size();
+
+    std::size_t col_idx = 0;
+
+    auto tsr_pos = tensors.begin();
+
+    csv_record_tokenizer tk{detail::trim_line_end(row), params_.delimiter};
+    while (tk.next()) {
+        // Make sure that the row has no extra fields.
+        if (col_idx == num_columns) {
+            return false;
+        }
+
+        if (skipped_columns_[col_idx] == 0) {
+            auto &dense_tsr = static_cast<dense_tensor &>(**tsr_pos);
+
+            parser const &prsr = column_parsers_[col_idx];
+
+            if (prsr(tk.value(), dense_tsr.data(), row_idx) !=
+                parse_result::ok) {
+                return false;
+            }
+
+            ++tsr_pos;
+        }
+
+        col_idx++;
+    }
+
+    // An unterminated quoted field is a malformed row as any other.
+    if (tk.corrupt()) {
+        return false;
+    }
+
+    return col_idx == num_columns;
+}
+
+std::vector<intrusive_ptr<tensor>>
+csv_decoder::make_tensors(std::size_t batch_size) const
+{
+    std::vector<intrusive_ptr<tensor>> tensors;
+    tensors.reserve(column_types_.size());
+
+    for (std::size_t idx = 0; idx < column_types_.size(); idx++) {
+        if (skipped_columns_[idx] != 0) {
+            continue;
+        }
+
+        auto shp = {batch_size};
+
+        auto arr = pool_->make_array(column_types_[idx], batch_size);
+
+        auto tsr = make_intrusive<dense_tensor>(shp, std::move(arr));
+
+        tensors.emplace_back(std::move(tsr));
+    }
+
+    return tensors;
+}
+
+}  // namespace v1
+}  // namespace mlio
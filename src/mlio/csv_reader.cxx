@@ -26,7 +26,9 @@
 #include <fmt/ostream.h>
 #include <tbb/tbb.h>
 
+#include "mlio/buffer_provider.h"
 #include "mlio/cpu_array.h"
+#include "mlio/csv_decoder.h"
 #include "mlio/csv_record_tokenizer.h"
 #include "mlio/data_reader.h"
 #include "mlio/data_reader_error.h"
@@ -34,7 +36,6 @@
 #include "mlio/example.h"
 #include "mlio/instance.h"
 #include "mlio/instance_batch.h"
-#include "mlio/logger.h"
 #include "mlio/memory/memory_slice.h"
 #include "mlio/record_readers/corrupt_record_error.h"
 #include "mlio/record_readers/csv_record_reader.h"
@@ -55,6 +56,8 @@ csv_reader::csv_reader(data_reader_params rdr_prm, csv_params csv_prm)
     : parallel_data_reader{std::move(rdr_prm)}, params_{std::move(csv_prm)}
 {
     column_names_ = params_.column_names;
+
+    start_eagerly();
 }
 
 csv_reader::~csv_reader()
@@ -70,18 +73,35 @@ csv_reader::make_record_reader(data_store const &ds)
     auto rdr = make_intrusive<csv_record_reader>(std::move(strm), params_);
 
     if (params_.header_row_index) {
+        // Rather than relying on the order in which the data stores are
+        // read, we check the identity of the data store; a shard might
+        // not read the first data store at all.
+        bool has_header = !params_.has_single_header ||
+                          &ds == params().dataset.front().get();
+
         // Check if the caller did not explicitly specified the column
         // names and requested us to infer them from the header.
         if (column_names_.empty()) {
-            read_names_from_header(ds, *rdr);
+            if (has_header) {
+                read_names_from_header(ds, *rdr);
+            }
+            else {
+                data_store const &hdr_ds = *params().dataset.front();
+
+                auto hdr_strm =
+                    make_utf8_stream(hdr_ds.open_read(), params_.encoding);
+
+                auto hdr_rdr = make_intrusive<csv_record_reader>(
+                    std::move(hdr_strm), params_);
+
+                read_names_from_header(hdr_ds, *hdr_rdr);
+            }
         }
-        else if (should_read_header || !params_.has_single_header) {
+        else if (has_header) {
             skip_to_header_row(*rdr);
 
             rdr->read_record();
         }
-
-        should_read_header = false;
     }
 
     return std::move(rdr);
@@ -109,6 +129,10 @@ csv_reader::read_names_from_header(data_store const &ds, record_reader &rdr)
             }
             column_names_.emplace_back(std::move(name));
         }
+
+        if (tk.corrupt()) {
+            throw corrupt_record_error{"EOF reached inside a quoted field."};
+        }
     }
     catch (corrupt_record_error const &) {
         std::throw_with_nested(schema_error{
@@ -163,6 +187,10 @@ csv_reader::infer_column_types(instance const &ins)
             }
             column_types_.emplace_back(dt);
         }
+
+        if (tk.corrupt()) {
+            throw corrupt_record_error{"EOF reached inside a quoted field."};
+        }
     }
     catch (corrupt_record_error const &) {
         std::throw_with_nested(schema_error{
@@ -340,8 +368,6 @@ csv_reader::decode(instance_batch const &batch) const
 {
     auto tensors = make_tensors(batch.size());
 
-    auto bbh = effective_bad_batch_handling();
-
     std::atomic_bool skip_batch{};
 
     std::size_t num_instances = batch.instances().size();
@@ -357,7 +383,7 @@ csv_reader::decode(instance_batch const &batch) const
 
     tbb::blocked_range<decltype(rng_beg)> range{rng_beg, rng_end};
 
-    auto worker = [this, &tensors, bbh, &skip_batch](auto &sub_range) {
+    auto worker = [this, &tensors, &skip_batch](auto &sub_range) {
         for (auto row_zip : sub_range) {
             std::size_t row_idx = std::get<0>(row_zip);
 
@@ -390,6 +416,8 @@ csv_reader::decode(instance_batch const &batch) const
 
             auto tsr_pos = tensors.begin();
 
+            bool is_bad = false;
+
             csv_record_tokenizer tk{ins.bits(), params_.delimiter};
             while (tk.next()) {
                 if (col_pos == col_end) {
@@ -417,7 +445,9 @@ csv_reader::decode(instance_batch const &batch) const
                     continue;
                 }
 
-                if (bbh != bad_batch_handling::skip) {
+                // The description is only formatted for the sample of
+                // bad rows that gets reported.
+                if (add_bad_instance()) {
                     std::string const &name = std::get<1>(*col_pos);
 
                     data_type dt = std::get<2>(*col_pos);
@@ -432,16 +462,34 @@ csv_reader::decode(instance_batch const &batch) const
                         dt,
                         tk.value());
 
-                    if (bbh == bad_batch_handling::error) {
-                        throw invalid_instance_error{msg};
-                    }
+                    report_bad_instance(std::move(msg));
+                }
+
+                is_bad = true;
+
+                break;
+            }
+
+            // Once a batch is skipped, its remaining rows are still
+            // checked so that every bad row gets counted.
+            if (is_bad) {
+                skip_batch = true;
 
-                    logger::warn(msg);
+                continue;
+            }
+
+            if (tk.corrupt()) {
+                if (add_bad_instance()) {
+                    report_bad_instance(fmt::format(
+                        "The row {1:n} in the data store {0} has a quoted "
+                        "field that is not terminated.",
+                        ins.get_data_store(),
+                        ins.index() + 1));
                 }
 
                 skip_batch = true;
 
-                return;
+                continue;
             }
 
             // Make sure we read all columns and there are no remaining
@@ -450,7 +498,7 @@ csv_reader::decode(instance_batch const &batch) const
                 continue;
             }
 
-            if (bbh != bad_batch_handling::skip) {
+            if (add_bad_instance()) {
                 std::size_t num_actual_cols = std::get<0>(*col_pos);
                 while (tk.next()) {
                     num_actual_cols++;
@@ -467,25 +515,18 @@ csv_reader::decode(instance_batch const &batch) const
                     num_actual_cols,
                     num_columns);
 
-                if (bbh == bad_batch_handling::error) {
-                    throw invalid_instance_error{msg};
-                }
-
-                logger::warn(msg);
+                report_bad_instance(std::move(msg));
             }
 
             skip_batch = true;
-
-            return;
         }
     };
 
-    constexpr std::size_t cut_off = 10'000'000;
-    if (column_names_.size() * num_instances < cut_off) {
-        worker(range);
+    if (should_decode_in_parallel(column_names_.size() * num_instances)) {
+        tbb::parallel_for(range, worker, tbb::auto_partitioner{});
     }
     else {
-        tbb::parallel_for(range, worker, tbb::auto_partitioner{});
+        worker(range);
     }
 
     if (skip_batch) {
@@ -499,6 +540,33 @@ csv_reader::decode(instance_batch const &batch) const
     return exm;
 }
 
+intrusive_ptr<csv_decoder>
+csv_reader::make_decoder()
+{
+    peek_example();
+
+    if (schema_ == nullptr) {
+        throw schema_error{
+            "The schema of the dataset cannot be inferred as the dataset "
+            "has no rows."};
+    }
+
+    csv_params prm = params_;
+
+    // The decoder has no header to read the names from and no row to
+    // infer the data types from; therefore we pass them explicitly.
+    prm.column_names = column_names_;
+
+    prm.column_types.clear();
+    prm.column_types_by_index.clear();
+
+    for (std::size_t idx = 0; idx < column_types_.size(); idx++) {
+        prm.column_types_by_index.emplace(idx, column_types_[idx]);
+    }
+
+    return make_intrusive<csv_decoder>(std::move(prm), params().batch_size);
+}
+
 std::vector<intrusive_ptr<tensor>>
 csv_reader::make_tensors(std::size_t batch_size) const
 {
@@ -514,6 +582,8 @@ csv_reader::make_tensors(std::size_t batch_size) const
     auto col_beg = tbb::make_zip_iterator(type_beg, skip_beg);
     auto col_end = tbb::make_zip_iterator(type_end, skip_end);
 
+    buffer_provider *prv = params().output_buffers.get();
+
     for (auto col_pos = col_beg; col_pos < col_end; ++col_pos) {
         if (std::get<1>(*col_pos) != 0) {
             continue;
@@ -523,7 +593,17 @@ csv_reader::make_tensors(std::size_t batch_size) const
 
         auto shp = {batch_size};
 
-        std::unique_ptr<device_array> arr = make_cpu_array(dt, batch_size);
+        // The descriptors of the schema are in the same order as the
+        // columns that are not skipped.
+        std::unique_ptr<device_array> arr{};
+        if (prv != nullptr) {
+            feature_desc const &desc = schema_->descriptors()[tensors.size()];
+
+            arr = prv->acquire_array(desc, batch_size);
+        }
+        if (arr == nullptr) {
+            arr = make_cpu_array(dt, batch_size);
+        }
 
         auto tsr = make_intrusive<dense_tensor>(shp, std::move(arr));
 
@@ -533,13 +613,5 @@ csv_reader::make_tensors(std::size_t batch_size) const
     return tensors;
 }
 
-void
-csv_reader::reset() noexcept
-{
-    parallel_data_reader::reset();
-
-    should_read_header = true;
-}
-
 }  // namespace v1
 }  // namespace mlio
@@ -18,7 +18,6 @@
 #include <cassert>
 
 #include "mlio/config.h"
-#include "mlio/record_readers/corrupt_record_error.h"
 
 namespace mlio {
 inline namespace v1 {
@@ -108,7 +107,15 @@ csv_record_tokenizer::next()
         break;
 
     case parser_state::in_quoted_field:
-        throw corrupt_record_error{"EOF reached inside a quoted field."};
+        // Reporting the error through the return value rather than an
+        // exception keeps the decoding of dirty datasets cheap.
+        state_ = parser_state::finished;
+
+        eof_ = true;
+
+        corrupt_ = true;
+
+        return false;
 
     case parser_state::finished:
         assert(false);
@@ -40,6 +40,9 @@ public:
     {}
 
 public:
+    // Moves to the next field of the record. Returns false at the end
+    // of the record or if the record ends inside a quoted field, in
+    // which case corrupt() returns true.
     bool
     next();
 
@@ -55,6 +58,12 @@ public:
         return eof_;
     }
 
+    bool
+    corrupt() const noexcept
+    {
+        return corrupt_;
+    }
+
 private:
     stdx::span<char const> text_;
     stdx::span<char const>::iterator pos_ = text_.begin();
@@ -62,6 +71,7 @@ private:
     char delimiter_;
     parser_state state_ = parser_state::new_field;
     bool eof_{};
+    bool corrupt_{};
 };
 
 }  // namespace detail
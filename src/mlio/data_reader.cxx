@@ -15,10 +15,73 @@
 
 #include "mlio/data_reader.h"
 
+#include <memory>
+#include <utility>
+
+#include "mlio/example.h"
+#include "mlio/not_supported_error.h"
+
 namespace mlio {
 inline namespace v1 {
 
 data_reader::~data_reader() = default;
 
+void
+data_reader::read_example_async(read_callback callback)
+{
+    intrusive_ptr<example> exm{};
+    try {
+        exm = read_example();
+    }
+    catch (...) {
+        callback(nullptr, std::current_exception());
+
+        return;
+    }
+
+    callback(std::move(exm), nullptr);
+}
+
+std::future<intrusive_ptr<example>>
+data_reader::read_example_async()
+{
+    // std::function requires a copyable target.
+    auto promise = std::make_shared<std::promise<intrusive_ptr<example>>>();
+
+    std::future<intrusive_ptr<example>> future = promise->get_future();
+
+    read_example_async(
+        [promise](intrusive_ptr<example> exm, std::exception_ptr const &ex) {
+            if (ex) {
+                promise->set_exception(ex);
+            }
+            else {
+                promise->set_value(std::move(exm));
+            }
+        });
+
+    return future;
+}
+
+std::vector<std::byte>
+data_reader::save_state() const
+{
+    throw not_supported_error{
+        "The data reader does not support saving its state."};
+}
+
+void
+data_reader::restore_state(memory_span)
+{
+    throw not_supported_error{
+        "The data reader does not support restoring its state."};
+}
+
+data_reader_statistics
+data_reader::statistics() const
+{
+    return {};
+}
+
 }  // namespace v1
 }  // namespace mlio
@@ -54,5 +54,19 @@ data_reader_base::peek_example()
     return peeked_example_;
 }
 
+void
+data_reader_base::restore_state(memory_span state)
+{
+    peeked_example_ = nullptr;
+
+    restore_state_core(state);
+}
+
+void
+data_reader_base::restore_state_core(memory_span state)
+{
+    data_reader::restore_state(state);
+}
+
 }  // namespace v1
 }  // namespace mlio
@@ -20,5 +20,17 @@ inline namespace v1 {
 
 data_store::~data_store() = default;
 
+std::optional<std::size_t>
+data_store::size_hint() const
+{
+    return {};
+}
+
+std::optional<record_index>
+data_store::load_record_index() const
+{
+    return {};
+}
+
 }  // namespace v1
 }  // namespace mlio
@@ -15,6 +15,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <optional>
+#include <string>
 #include <string_view>
 
 #include "mlio/data_stores/compression.h"
@@ -26,6 +29,9 @@ namespace detail {
 compression
 infer_compression(std::string_view pathname) noexcept;
 
+std::optional<std::size_t>
+get_file_size(std::string const &pathname) noexcept;
+
 }  // namespace detail
 }  // namespace v1
 }  // namespace mlio
@@ -24,6 +24,7 @@
 #include "mlio/detail/pathname.h"
 #include "mlio/logger.h"
 #include "mlio/memory/file_mapped_memory_block.h"
+#include "mlio/record_readers/record_index.h"
 #include "mlio/streams/file_input_stream.h"
 #include "mlio/streams/input_stream.h"
 #include "mlio/streams/memory_input_stream.h"
@@ -61,6 +62,40 @@ file::open_read() const
     return make_inflate_stream(std::move(strm), compression_);
 }
 
+std::optional<std::size_t>
+file::size_hint() const
+{
+    // The size of a compressed file has no relation to the positions of
+    // the decompressed stream; we cannot split it into byte ranges.
+    if (compression_ != compression::none) {
+        return {};
+    }
+    return detail::get_file_size(pathname_);
+}
+
+std::optional<record_index>
+file::load_record_index() const
+{
+    std::string idx_pathname = get_record_index_pathname(pathname_);
+    if (detail::get_file_size(idx_pathname) == std::nullopt) {
+        return {};
+    }
+
+    record_index idx = mlio::load_record_index(idx_pathname);
+
+    if (idx.data_size() != size_hint()) {
+        if (!stale_index_reported_.exchange(true)) {
+            logger::warn(
+                "The record index '{0}' is stale and will be ignored.",
+                idx_pathname);
+        }
+
+        return {};
+    }
+
+    return idx;
+}
+
 std::string
 file::repr() const
 {
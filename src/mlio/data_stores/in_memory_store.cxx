@@ -53,6 +53,15 @@ in_memory_store::open_read() const
     return make_inflate_stream(std::move(strm), compression_);
 }
 
+std::optional<std::size_t>
+in_memory_store::size_hint() const
+{
+    if (compression_ != compression::none) {
+        return {};
+    }
+    return chunk_.size();
+}
+
 std::string
 in_memory_store::repr() const
 {
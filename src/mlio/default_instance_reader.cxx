@@ -16,8 +16,10 @@
 #include "mlio/default_instance_reader.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <exception>
 #include <iostream>
+#include <stdexcept>
 #include <system_error>
 #include <type_traits>
 #include <utility>
@@ -25,42 +27,94 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include "mlio/bad_record_reporter.h"
 #include "mlio/data_reader.h"
 #include "mlio/data_reader_error.h"
 #include "mlio/instance.h"
 #include "mlio/instance_batch.h"
+#include "mlio/logger.h"
 #include "mlio/memory/memory_slice.h"
 #include "mlio/not_supported_error.h"
+#include "mlio/pipeline_statistics.h"
 #include "mlio/record_readers/corrupt_record_error.h"
+#include "mlio/reader_state.h"
 #include "mlio/record_readers/record.h"
 #include "mlio/streams/stream_error.h"
+#include "mlio/util/cast.h"
 
 namespace mlio {
 inline namespace v1 {
 namespace detail {
 
 default_instance_reader::default_instance_reader(data_reader_params const &prm,
-                                                 record_reader_factory &&fct)
+                                                 record_reader_factory &&fct,
+                                                 pipeline_statistics *stats,
+                                                 bad_record_reporter *reporter)
     : params_{&prm}
     , record_reader_factory_{std::move(fct)}
-    , num_shards_{std::max(params_->num_shards, 1UL)}
-    , next_instance_idx_to_read_{params_->shard_index}
+    , stats_{stats}
+    , reporter_{reporter}
 {
-    if (params_->shard_index >= num_shards_) {
+    if (params_->shard_index >= std::max(params_->num_shards, 1UL)) {
         throw std::invalid_argument{
             "The shard index must be less than the number of shards."};
     }
 
-    store_iter_ = params_->dataset.begin();
+    if (params_->coordinator != nullptr && params_->num_shards > 1) {
+        throw std::invalid_argument{
+            "A dataset that is sharded by a coordinator cannot be split "
+            "into static shards."};
+    }
+
+    base_ranges_ = make_shard_ranges(*params_);
+
+    if (params_->shuffle_block_size > 0) {
+        base_ranges_ = split_into_record_blocks(
+            *params_, base_ranges_, params_->shuffle_block_size);
+    }
+
+    if (should_shuffle_ranges()) {
+        // Shards that split the dataset by instances must agree on the
+        // order of the data stores; otherwise they would overlap.
+        if (params_->shard_strategy == sharding_strategy::instances &&
+            params_->num_shards > 1 && params_->shuffle_seed == std::nullopt) {
+            throw std::invalid_argument{
+                "A shuffle seed must be specified to shuffle the data stores "
+                "of a dataset that is sharded by instances."};
+        }
+
+        if (params_->shuffle_seed != std::nullopt) {
+            seed_ = *params_->shuffle_seed;
+        }
+    }
+
+    order_ranges();
+
+    // Unless the dataset is sharded by instances, each shard reads all
+    // instances of its data store ranges.
+    if (params_->shard_strategy == sharding_strategy::instances) {
+        num_shards_ = std::max(params_->num_shards, 1UL);
+
+        first_instance_idx_ = params_->shard_index;
+    }
+    else {
+        num_shards_ = 1;
+
+        first_instance_idx_ = 0;
+    }
+
+    next_instance_idx_to_read_ = first_instance_idx_;
 }
 
 std::optional<instance>
 default_instance_reader::read_instance_core()
 {
-    if (should_stop_reading() || !skip_instances()) {
+    if (should_stop_reading()) {
         return {};
     }
 
+    skip_initial_instances();
+
     num_instances_read_++;
 
     return read_instance_internal();
@@ -77,18 +131,35 @@ default_instance_reader::should_stop_reading() const noexcept
     return false;
 }
 
-bool
-default_instance_reader::skip_instances()
+void
+default_instance_reader::skip_initial_instances() noexcept
 {
-    while (num_instances_skipped_ < params_->num_instances_to_skip) {
-        if (read_instance_internal() == std::nullopt) {
-            return false;
-        }
+    if (num_instances_skipped_ == params_->num_instances_to_skip) {
+        return;
+    }
+
+    // The records in between will be skipped by the next read.
+    next_instance_idx_to_read_ +=
+        (params_->num_instances_to_skip - num_instances_skipped_) *
+        num_shards_;
+
+    num_instances_skipped_ = params_->num_instances_to_skip;
+}
 
-        num_instances_skipped_++;
+void
+default_instance_reader::skip_instances_core(std::size_t num_instances)
+{
+    if (params_->num_instances_to_read != std::nullopt) {
+        num_instances =
+            std::min(num_instances,
+                     *params_->num_instances_to_read - num_instances_read_);
     }
 
-    return true;
+    skip_initial_instances();
+
+    num_instances_read_ += num_instances;
+
+    next_instance_idx_to_read_ += num_instances * num_shards_;
 }
 
 std::optional<instance>
@@ -97,6 +168,10 @@ default_instance_reader::read_instance_internal()
     std::optional<memory_slice> payload;
 
     try {
+        if (params_->use_record_index) {
+            skip_records_using_index();
+        }
+
         for (; instance_idx_ < next_instance_idx_to_read_; instance_idx_++) {
             if ((payload = read_record_payload()) == std::nullopt) {
                 return {};
@@ -167,6 +242,10 @@ default_instance_reader::read_record_payload()
 
     num_bytes_read_ += rec->size();
 
+    if (stats_ != nullptr) {
+        stats_->add_record(store_idx_, rec->size());
+    }
+
     store_record_idx_++;
 
     return std::move(*rec).payload();
@@ -177,8 +256,29 @@ default_instance_reader::read_record()
 {
     std::optional<record> rec{};
 
-    while (record_reader_ == nullptr ||
-           (rec = record_reader_->read_record()) == std::nullopt) {
+    while (true) {
+        if (record_reader_ != nullptr && !is_past_range_end()) {
+            std::size_t position = record_reader_->position();
+
+            try {
+                rec = record_reader_->read_record();
+            }
+            catch (corrupt_record_error const &e) {
+                if (!handle_corrupt_record(e)) {
+                    throw;
+                }
+                continue;
+            }
+
+            update_stream_read_time();
+
+            if (rec) {
+                last_record_position_ = position;
+
+                break;
+            }
+        }
+
         if (!init_next_record_reader()) {
             return {};
         }
@@ -188,17 +288,80 @@ default_instance_reader::read_record()
 }
 
 bool
-default_instance_reader::init_next_record_reader()
+default_instance_reader::handle_corrupt_record(corrupt_record_error const &e)
 {
-    if (store_iter_ == params_->dataset.end()) {
+    if (reporter_ == nullptr ||
+        reporter_->handling() == bad_batch_handling::error) {
         return false;
     }
 
-    store_record_idx_ = 0;
+    // A record reader cannot resynchronize after a corrupt record, so we
+    // give up on the rest of the range; the read loop moves on to the
+    // next one.
+    if (reporter_->add_bad_record()) {
+        reporter_->report(fmt::format(
+            "The record {1:n} in the data store {0} is corrupt. The records "
+            "following it in the same range are skipped. {2}",
+            *store_,
+            store_record_idx_,
+            e.what()));
+    }
 
-    store_instance_idx_ = 0;
+    update_stream_read_time();
+
+    record_reader_ = nullptr;
+
+    return true;
+}
+
+bool
+default_instance_reader::init_next_record_reader()
+{
+    if (range_iter_ == ranges_.end()) {
+        if (params_->coordinator == nullptr || !acquire_next_range()) {
+            return false;
+        }
+    }
+
+    data_store_range const &range = *range_iter_;
+
+    store_record_idx_ = range.first_record_idx;
+
+    store_instance_idx_ = range.first_record_idx;
+
+    // If the range is a block of the data store that we have just read,
+    // we can seek to its first record instead of reopening the store.
+    if (record_reader_ != nullptr && range.at_record_boundary &&
+        range.store_idx == store_idx_ && record_reader_->seekable()) {
+        ++range_iter_;
 
-    store_ = store_iter_->get();
+        range_end_ = range.end;
+
+        record_index_ = std::nullopt;
+
+        record_reader_->seek(range.begin);
+
+        return true;
+    }
+
+    // Load the index before constructing the record reader; if it
+    // throws, we must not be left with a reader of a range that we have
+    // not moved past.
+    std::optional<record_index> idx = load_range_index(range);
+
+    store_ = params_->dataset[range.store_idx].get();
+
+    store_idx_ = range.store_idx;
+
+    if (record_reader_ != nullptr) {
+        update_stream_read_time();
+    }
+
+    // If the factory throws, we should not account the time of the
+    // previous reader twice.
+    record_reader_ = nullptr;
+
+    last_read_time_ = {};
 
     try {
         record_reader_ = record_reader_factory_(*store_);
@@ -218,23 +381,336 @@ default_instance_reader::init_next_record_reader()
         throw;
     }
 
+    range_end_ = range.end;
+
+    supports_random_access_ =
+        record_reader_->seekable() && record_reader_->supports_zero_copy();
+
+    if (record_reader_->seekable()) {
+        record_index_ = std::move(idx);
+    }
+    else {
+        record_index_ = std::nullopt;
+    }
+
     // Move to the next data store after we get the reader instance;
     // otherwise we might break the class invariant if the factory
     // throws an exception.
-    ++store_iter_;
+    ++range_iter_;
+
+    move_to_position(range.begin);
+
+    return true;
+}
+
+bool
+default_instance_reader::acquire_next_range()
+{
+    // We only ask for a new work item once the previous one has been
+    // read to its end.
+    complete_current_range();
+
+    std::optional<std::size_t> item_idx =
+        params_->coordinator->acquire_work_item(epoch_, base_ranges_.size());
+    if (item_idx == std::nullopt) {
+        return false;
+    }
+
+    if (*item_idx >= base_ranges_.size()) {
+        throw data_reader_error{fmt::format(
+            "The shard coordinator has handed out the work item {0:n} of a "
+            "dataset with {1:n} work items.",
+            *item_idx,
+            base_ranges_.size())};
+    }
+
+    work_item_idx_ = item_idx;
+
+    auto range_idx = range_iter_ - ranges_.begin();
+
+    ranges_.push_back(base_ranges_[*item_idx]);
+
+    range_iter_ = ranges_.begin() + range_idx;
 
     return true;
 }
 
+void
+default_instance_reader::complete_current_range()
+{
+    if (work_item_idx_ == std::nullopt) {
+        return;
+    }
+
+    params_->coordinator->complete_work_item(epoch_, *work_item_idx_);
+
+    work_item_idx_ = std::nullopt;
+}
+
+void
+default_instance_reader::update_stream_read_time() noexcept
+{
+    if (stats_ == nullptr) {
+        return;
+    }
+
+    std::chrono::nanoseconds read_time = record_reader_->read_time();
+
+    stats_->add_stream_read_time(read_time - last_read_time_);
+
+    last_read_time_ = read_time;
+}
+
+void
+default_instance_reader::move_to_position(std::size_t position)
+{
+    // The record reader might have already consumed a header.
+    if (position <= record_reader_->position()) {
+        return;
+    }
+
+    if (record_reader_->seekable()) {
+        try {
+            record_reader_->seek_to_record_boundary(position);
+
+            return;
+        }
+        catch (not_supported_error const &) {
+            record_reader_->seek(0);
+        }
+    }
+
+    logger::debug(
+        "The data store {0} cannot be seeked. The records preceding the "
+        "byte position {1:n} will be read and discarded.",
+        *store_,
+        position);
+
+    while (record_reader_->position() < position) {
+        if (record_reader_->read_record() == std::nullopt) {
+            break;
+        }
+    }
+}
+
+void
+default_instance_reader::skip_records_using_index()
+{
+    while (instance_idx_ < next_instance_idx_to_read_) {
+        if (record_reader_ == nullptr) {
+            if (skip_range_using_index()) {
+                continue;
+            }
+
+            if (!init_next_record_reader()) {
+                return;
+            }
+        }
+
+        if (record_index_ == std::nullopt ||
+            store_record_idx_ > record_index_->num_records()) {
+            return;
+        }
+
+        std::size_t num_records_to_skip =
+            next_instance_idx_to_read_ - instance_idx_;
+
+        std::size_t num_records_left =
+            record_index_->num_records() - store_record_idx_;
+
+        // If all remaining records of the data store should be skipped,
+        // move on to the next range.
+        if (num_records_to_skip >= num_records_left) {
+            instance_idx_ += num_records_left;
+
+            update_stream_read_time();
+
+            record_reader_ = nullptr;
+
+            continue;
+        }
+
+        auto [record_idx, position] =
+            record_index_->lookup(store_record_idx_ + num_records_to_skip);
+
+        // The remaining records will be read and discarded.
+        if (record_idx > store_record_idx_) {
+            record_reader_->seek(position);
+
+            instance_idx_ += record_idx - store_record_idx_;
+
+            store_record_idx_ = record_idx;
+        }
+
+        return;
+    }
+}
+
+bool
+default_instance_reader::skip_range_using_index()
+{
+    if (range_iter_ == ranges_.end()) {
+        return false;
+    }
+
+    data_store_range const &range = *range_iter_;
+
+    std::optional<record_index> idx = load_range_index(range);
+    if (idx == std::nullopt || range.first_record_idx > idx->num_records()) {
+        return false;
+    }
+
+    std::size_t num_records_to_skip =
+        next_instance_idx_to_read_ - instance_idx_;
+
+    std::size_t num_records = idx->num_records() - range.first_record_idx;
+
+    if (num_records_to_skip < num_records) {
+        // Save the index so that init_next_record_reader() does not
+        // have to load it again.
+        next_record_index_ = std::move(idx);
+
+        return false;
+    }
+
+    instance_idx_ += num_records;
+
+    ++range_iter_;
+
+    return true;
+}
+
+std::optional<record_index>
+default_instance_reader::load_range_index(data_store_range const &range)
+{
+    std::optional<record_index> idx = std::exchange(next_record_index_, {});
+
+    // The index is only meaningful if we read the data store from its
+    // beginning.
+    if (!params_->use_record_index || range.begin != 0 ||
+        range.end != std::nullopt) {
+        return {};
+    }
+
+    if (idx == std::nullopt) {
+        idx = params_->dataset[range.store_idx]->load_record_index();
+    }
+    return idx;
+}
+
+bool
+default_instance_reader::should_shuffle_ranges() const noexcept
+{
+    return params_->shuffle_data_stores || params_->shuffle_block_size > 0;
+}
+
+void
+default_instance_reader::order_ranges()
+{
+    // The work items are handed out by the coordinator one at a time.
+    if (params_->coordinator != nullptr) {
+        ranges_.clear();
+
+        range_iter_ = ranges_.begin();
+
+        return;
+    }
+
+    ranges_ = base_ranges_;
+
+    if (should_shuffle_ranges()) {
+        std::size_t epoch = params_->reshuffle_each_epoch ? epoch_ : 0;
+
+        // The order only depends on the seed and on the epoch so that it
+        // can be reproduced when restoring a saved state.
+        std::seed_seq seq{static_cast<std::uint32_t>(seed_),
+                          static_cast<std::uint32_t>(seed_ >> 32U),
+                          static_cast<std::uint32_t>(epoch),
+                          static_cast<std::uint32_t>(epoch >> 32U)};
+
+        std::mt19937_64 mt{seq};
+
+        shuffle_ranges(ranges_,
+                       mt,
+                       params_->shuffle_data_stores,
+                       params_->shuffle_block_size > 0);
+    }
+
+    range_iter_ = ranges_.begin();
+}
+
+bool
+default_instance_reader::is_past_range_end() const
+{
+    return range_end_ && record_reader_->position() >= *range_end_;
+}
+
+instance
+default_instance_reader::read_instance_at(instance_location const &loc,
+                                          std::size_t instance_idx)
+{
+    if (random_access_readers_.empty()) {
+        random_access_readers_.resize(params_->dataset.size());
+    }
+
+    data_store const &ds = *params_->dataset[loc.store_idx];
+
+    intrusive_ptr<record_reader> &rdr = random_access_readers_[loc.store_idx];
+    if (rdr == nullptr) {
+        rdr = record_reader_factory_(ds);
+    }
+
+    rdr->seek(loc.position);
+
+    std::optional<record> rec = rdr->read_record();
+    if (rec == std::nullopt) {
+        throw data_reader_error{fmt::format(
+            "The data store {0} has been modified while being read.", ds)};
+    }
+
+    return instance{ds, instance_idx, std::move(*rec).payload()};
+}
+
+std::optional<instance_location>
+default_instance_reader::last_instance_location() const noexcept
+{
+    if (!supports_random_access_) {
+        return {};
+    }
+    return instance_location{store_idx_, last_record_position_};
+}
+
 void
 default_instance_reader::reset() noexcept
 {
-    store_iter_ = params_->dataset.begin();
+    // The work item being read is not completed; the coordinator will
+    // not hand it out again in this epoch.
+    work_item_idx_ = std::nullopt;
+
+    epoch_++;
+
+    order_ranges();
+
+    range_end_ = std::nullopt;
+
+    record_index_ = std::nullopt;
+
+    next_record_index_ = std::nullopt;
 
     store_ = nullptr;
 
+    store_idx_ = 0;
+
     record_reader_ = nullptr;
 
+    last_read_time_ = {};
+
+    supports_random_access_ = false;
+
+    last_record_position_ = 0;
+
+    random_access_readers_.clear();
+
     num_bytes_read_ = 0;
 
     store_record_idx_ = 0;
@@ -243,13 +719,101 @@ default_instance_reader::reset() noexcept
 
     instance_idx_ = 0;
 
-    next_instance_idx_to_read_ = params_->shard_index;
+    next_instance_idx_to_read_ = first_instance_idx_;
 
     num_instances_skipped_ = 0;
 
     num_instances_read_ = 0;
 }
 
+void
+default_instance_reader::save_state(state_writer &wr) const
+{
+    if (params_->coordinator != nullptr) {
+        wr.set_error(
+            "The state of a data reader that is sharded by a coordinator "
+            "cannot be saved.");
+    }
+
+    wr.write(epoch_);
+    wr.write(seed_);
+
+    wr.write(static_cast<std::size_t>(range_iter_ - ranges_.begin()));
+
+    // The position of the next record in the current range, if any.
+    wr.write(record_reader_ != nullptr);
+    wr.write(record_reader_ != nullptr ? record_reader_->position() : 0);
+
+    wr.write(num_bytes_read_);
+    wr.write(store_record_idx_);
+    wr.write(store_instance_idx_);
+    wr.write(instance_idx_);
+    wr.write(next_instance_idx_to_read_);
+    wr.write(num_instances_skipped_);
+    wr.write(num_instances_read_);
+}
+
+void
+default_instance_reader::restore_state_core(state_reader &rd)
+{
+    std::size_t epoch = rd.read_size();
+    std::uint_fast64_t seed = rd.read_uint64();
+
+    std::size_t range_idx = rd.read_size();
+
+    bool has_record_reader = rd.read_bool();
+    std::size_t position = rd.read_size();
+
+    std::size_t num_bytes_read = rd.read_size();
+    std::size_t store_record_idx = rd.read_size();
+    std::size_t store_instance_idx = rd.read_size();
+    std::size_t instance_idx = rd.read_size();
+    std::size_t next_instance_idx_to_read = rd.read_size();
+    std::size_t num_instances_skipped = rd.read_size();
+    std::size_t num_instances_read = rd.read_size();
+
+    if (range_idx > base_ranges_.size() ||
+        (has_record_reader && range_idx == 0)) {
+        throw std::invalid_argument{
+            "The state does not match the dataset of the reader."};
+    }
+
+    reset();
+
+    epoch_ = epoch;
+
+    seed_ = seed;
+
+    order_ranges();
+
+    if (has_record_reader) {
+        // Reopen the range that was being read and seek to the record
+        // that follows the last instance read. The saved position is a
+        // record boundary, so there is no need to search for one.
+        range_iter_ = ranges_.begin() + as_ssize(range_idx - 1);
+
+        init_next_record_reader();
+
+        if (record_reader_->seekable()) {
+            record_reader_->seek(position);
+        }
+        else {
+            move_to_position(position);
+        }
+    }
+    else {
+        range_iter_ = ranges_.begin() + as_ssize(range_idx);
+    }
+
+    num_bytes_read_ = num_bytes_read;
+    store_record_idx_ = store_record_idx;
+    store_instance_idx_ = store_instance_idx;
+    instance_idx_ = instance_idx;
+    next_instance_idx_to_read_ = next_instance_idx_to_read;
+    num_instances_skipped_ = num_instances_skipped;
+    num_instances_read_ = num_instances_read;
+}
+
 }  // namespace detail
 }  // namespace v1
 }  // namespace mlio
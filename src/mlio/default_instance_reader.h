@@ -15,16 +15,21 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <functional>
 #include <optional>
+#include <random>
 #include <vector>
 
 #include "mlio/data_stores/data_store.h"
 #include "mlio/fwd.h"
 #include "mlio/instance_reader_base.h"
 #include "mlio/intrusive_ptr.h"
+#include "mlio/record_readers/corrupt_record_error.h"
+#include "mlio/record_readers/record_index.h"
 #include "mlio/record_readers/record_reader.h"
+#include "mlio/sharding.h"
 
 namespace mlio {
 inline namespace v1 {
@@ -33,10 +38,18 @@ namespace detail {
 using record_reader_factory =
     std::function<intrusive_ptr<record_reader>(data_store const &ds)>;
 
+// Identifies the record of a data instance within the dataset.
+struct instance_location {
+    std::size_t store_idx{};
+    std::size_t position{};
+};
+
 class default_instance_reader final : public instance_reader_base {
 public:
     explicit default_instance_reader(data_reader_params const &prm,
-                                     record_reader_factory &&fct);
+                                     record_reader_factory &&fct,
+                                     pipeline_statistics *stats = nullptr,
+                                     bad_record_reporter *reporter = nullptr);
 
 private:
     std::optional<instance>
@@ -45,8 +58,14 @@ private:
     bool
     should_stop_reading() const noexcept;
 
-    bool
-    skip_instances();
+    void
+    skip_initial_instances() noexcept;
+
+    void
+    skip_instances_core(std::size_t num_instances) final;
+
+    void
+    restore_state_core(state_reader &rd) final;
 
     std::optional<instance>
     read_instance_internal();
@@ -60,14 +79,74 @@ private:
     std::optional<record>
     read_record();
 
+    // Returns true if the rest of the current data store should be
+    // skipped instead of failing the reader because of a corrupt
+    // record.
+    bool
+    handle_corrupt_record(corrupt_record_error const &e);
+
     bool
     init_next_record_reader();
 
+    // Asks the coordinator for the next work item and appends it to the
+    // ranges of the current epoch.
+    bool
+    acquire_next_range();
+
+    // Reports the work item being read, if any, as completed.
+    void
+    complete_current_range();
+
+    // Adds the time the current record reader has spent reading from
+    // its stream since the last call to the statistics.
+    void
+    update_stream_read_time() noexcept;
+
+    bool
+    should_shuffle_ranges() const noexcept;
+
+    // Sets the order in which the ranges are read in the current epoch.
+    void
+    order_ranges();
+
+    void
+    move_to_position(std::size_t position);
+
+    bool
+    is_past_range_end() const;
+
+    void
+    skip_records_using_index();
+
+    // Skips the next range as a whole, without opening its data store,
+    // if its record index shows that all of its records should be
+    // skipped.
+    bool
+    skip_range_using_index();
+
+    // Returns the record index of the specified range if the range
+    // covers its data store as a whole.
+    std::optional<record_index>
+    load_range_index(data_store_range const &range);
+
 public:
+    // Reads the instance at the specified location, which should be a
+    // value previously returned by last_instance_location().
+    instance
+    read_instance_at(instance_location const &loc, std::size_t instance_idx);
+
     void
     reset() noexcept final;
 
+    void
+    save_state(state_writer &wr) const final;
+
 public:
+    // Returns the location of the last instance read, or an empty value
+    // if the instance cannot be read again in constant time.
+    std::optional<instance_location>
+    last_instance_location() const noexcept;
+
     std::size_t
     num_bytes_read() const noexcept final
     {
@@ -77,10 +156,31 @@ public:
 private:
     data_reader_params const *params_;
     record_reader_factory record_reader_factory_;
-    std::vector<intrusive_ptr<data_store>>::const_iterator store_iter_;
+    pipeline_statistics *stats_;
+    bad_record_reporter *reporter_;
+    std::vector<data_store_range> base_ranges_;
+    std::vector<data_store_range> ranges_{};
+    std::vector<data_store_range>::const_iterator range_iter_;
+    // The index of the work item being read if the dataset is sharded
+    // by a coordinator.
+    std::optional<std::size_t> work_item_idx_{};
+    std::optional<std::size_t> range_end_{};
+    std::random_device rd_{};
+    std::uint_fast64_t seed_{rd_()};
+    std::size_t epoch_{};
+    std::optional<record_index> record_index_{};
+    // The index of the next range if it has already been loaded by
+    // skip_range_using_index().
+    std::optional<record_index> next_record_index_{};
     data_store *store_{};
+    std::size_t store_idx_{};
     intrusive_ptr<record_reader> record_reader_{};
+    std::chrono::nanoseconds last_read_time_{};
+    bool supports_random_access_{};
+    std::size_t last_record_position_{};
+    std::vector<intrusive_ptr<record_reader>> random_access_readers_{};
     std::size_t num_shards_;
+    std::size_t first_instance_idx_;
     std::size_t num_bytes_read_{};
     std::size_t store_record_idx_{};
     std::size_t store_instance_idx_{};
@@ -21,9 +21,18 @@ namespace mlio {
 inline namespace v1 {
 namespace detail {
 
+// Returns the amount of memory the process can use, which is the
+// smaller of the physical memory and the memory limit of its cgroup,
+// or zero if it cannot be determined.
 std::size_t
 get_total_ram() noexcept;
 
+// Returns the number of processor cores the process can use, taking
+// its CPU affinity, and hence its cpuset, and the CPU quota of its
+// cgroup into account.
+std::size_t
+get_num_cpus() noexcept;
+
 }  // namespace detail
 }  // namespace v1
 }  // namespace mlio
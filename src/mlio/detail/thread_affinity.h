@@ -0,0 +1,35 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+// Returns the processor cores the calling thread is allowed to run on.
+std::vector<std::size_t>
+get_current_thread_affinity();
+
+// Restricts the calling thread to the specified processor cores.
+void
+set_current_thread_affinity(std::vector<std::size_t> const &cpus);
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
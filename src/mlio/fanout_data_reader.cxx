@@ -0,0 +1,340 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/fanout_data_reader.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "mlio/example.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+// Holds the state shared by the consumers of a data reader. There is
+// no background thread; the consumer that finds its queue empty reads
+// from the shared reader on behalf of all consumers.
+class fanout_state {
+public:
+    explicit fanout_state(intrusive_ptr<data_reader> &&rdr,
+                          std::size_t num_consumers,
+                          fanout_policy policy,
+                          std::size_t max_queue_size)
+        : reader_{std::move(rdr)}
+        , policy_{policy}
+        , max_queue_size_{max_queue_size}
+        , queues_(num_consumers)
+        , epochs_(num_consumers)
+    {}
+
+public:
+    intrusive_ptr<example>
+    read_example(std::size_t consumer_idx);
+
+    void
+    reset(std::size_t consumer_idx) noexcept;
+
+    data_reader_statistics
+    statistics() const
+    {
+        return reader_->statistics();
+    }
+
+    std::size_t
+    num_bytes_read() const noexcept
+    {
+        return reader_->num_bytes_read();
+    }
+
+private:
+    // Reads the next example from the shared reader with the lock
+    // released so that the other consumers can drain their queues.
+    intrusive_ptr<example>
+    read_shared_example(std::unique_lock<std::mutex> &lock);
+
+    bool
+    is_queue_full(std::size_t consumer_idx) const noexcept
+    {
+        return epochs_[consumer_idx] == epoch_ &&
+               queues_[consumer_idx].size() >= max_queue_size_;
+    }
+
+    bool
+    is_any_other_queue_full(std::size_t consumer_idx) const noexcept
+    {
+        for (std::size_t idx = 0; idx < queues_.size(); idx++) {
+            if (idx != consumer_idx && is_queue_full(idx)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    intrusive_ptr<data_reader> reader_;
+    fanout_policy policy_;
+    std::size_t max_queue_size_;
+    std::mutex mutex_{};
+    std::condition_variable cond_{};
+    std::vector<std::deque<intrusive_ptr<example>>> queues_;
+    std::vector<std::size_t> epochs_;
+    std::size_t epoch_{};
+    std::size_t next_consumer_idx_{};
+    bool is_reading_{};
+    bool is_exhausted_{};
+};
+
+intrusive_ptr<example>
+fanout_state::read_example(std::size_t consumer_idx)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    // Wait for the other consumers to finish the previous epoch.
+    cond_.wait(lock, [this, consumer_idx] {
+        return epochs_[consumer_idx] == epoch_;
+    });
+
+    auto &queue = queues_[consumer_idx];
+
+    while (true) {
+        if (!queue.empty()) {
+            intrusive_ptr<example> exm = std::move(queue.front());
+
+            queue.pop_front();
+
+            cond_.notify_all();
+
+            return exm;
+        }
+
+        if (is_exhausted_) {
+            return {};
+        }
+
+        // If another consumer is reading, or if a consumer that should
+        // receive the next example has no room left in its queue, wait.
+        if (is_reading_ ||
+            (policy_ == fanout_policy::round_robin &&
+             next_consumer_idx_ != consumer_idx &&
+             is_queue_full(next_consumer_idx_)) ||
+            (policy_ == fanout_policy::broadcast &&
+             is_any_other_queue_full(consumer_idx))) {
+
+            cond_.wait(lock);
+
+            continue;
+        }
+
+        intrusive_ptr<example> exm = read_shared_example(lock);
+        if (exm == nullptr) {
+            is_exhausted_ = true;
+
+            continue;
+        }
+
+        if (policy_ == fanout_policy::work_stealing) {
+            return exm;
+        }
+
+        if (policy_ == fanout_policy::broadcast) {
+            for (std::size_t idx = 0; idx < queues_.size(); idx++) {
+                if (idx != consumer_idx && epochs_[idx] == epoch_) {
+                    queues_[idx].push_back(exm);
+                }
+            }
+            return exm;
+        }
+
+        std::size_t idx = next_consumer_idx_;
+
+        next_consumer_idx_ = (next_consumer_idx_ + 1) % queues_.size();
+
+        if (idx == consumer_idx) {
+            return exm;
+        }
+
+        // If the consumer has already moved to the next epoch, the
+        // example belongs to an epoch it has abandoned.
+        if (epochs_[idx] == epoch_) {
+            queues_[idx].emplace_back(std::move(exm));
+        }
+    }
+}
+
+intrusive_ptr<example>
+fanout_state::read_shared_example(std::unique_lock<std::mutex> &lock)
+{
+    is_reading_ = true;
+
+    lock.unlock();
+
+    intrusive_ptr<example> exm{};
+    try {
+        exm = reader_->read_example();
+    }
+    catch (...) {
+        lock.lock();
+
+        is_reading_ = false;
+
+        cond_.notify_all();
+
+        throw;
+    }
+
+    lock.lock();
+
+    is_reading_ = false;
+
+    cond_.notify_all();
+
+    return exm;
+}
+
+void
+fanout_state::reset(std::size_t consumer_idx) noexcept
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    // A consumer that resets more than once before the others catch up
+    // is already waiting for the next epoch.
+    if (epochs_[consumer_idx] != epoch_) {
+        return;
+    }
+
+    epochs_[consumer_idx]++;
+
+    queues_[consumer_idx].clear();
+
+    for (std::size_t epoch : epochs_) {
+        if (epoch == epoch_) {
+            cond_.notify_all();
+
+            return;
+        }
+    }
+
+    // All consumers have been reset; no consumer can be reading from
+    // the shared reader at this point.
+    reader_->reset();
+
+    epoch_++;
+
+    next_consumer_idx_ = 0;
+
+    is_exhausted_ = false;
+
+    cond_.notify_all();
+}
+
+// Represents the handle of a consumer of a shared data reader.
+class fanout_consumer final : public data_reader {
+public:
+    explicit fanout_consumer(std::shared_ptr<fanout_state> state,
+                             std::size_t idx) noexcept
+        : state_{std::move(state)}, idx_{idx}
+    {}
+
+public:
+    intrusive_ptr<example>
+    read_example() final
+    {
+        if (peeked_example_) {
+            return std::exchange(peeked_example_, nullptr);
+        }
+        return state_->read_example(idx_);
+    }
+
+    intrusive_ptr<example> const &
+    peek_example() final
+    {
+        if (peeked_example_ == nullptr) {
+            peeked_example_ = state_->read_example(idx_);
+        }
+        return peeked_example_;
+    }
+
+    void
+    reset() noexcept final
+    {
+        peeked_example_ = nullptr;
+
+        state_->reset(idx_);
+    }
+
+    data_reader_statistics
+    statistics() const final
+    {
+        return state_->statistics();
+    }
+
+public:
+    std::size_t
+    num_bytes_read() const noexcept final
+    {
+        return state_->num_bytes_read();
+    }
+
+private:
+    std::shared_ptr<fanout_state> state_;
+    std::size_t idx_;
+    intrusive_ptr<example> peeked_example_{};
+};
+
+}  // namespace
+}  // namespace detail
+
+std::vector<intrusive_ptr<data_reader>>
+make_fanout_readers(intrusive_ptr<data_reader> rdr,
+                    std::size_t num_consumers,
+                    fanout_policy policy,
+                    std::size_t max_queue_size)
+{
+    if (rdr == nullptr) {
+        throw std::invalid_argument{"The data reader must not be null."};
+    }
+
+    if (num_consumers == 0) {
+        throw std::invalid_argument{
+            "The number of consumers must be greater than zero."};
+    }
+
+    if (max_queue_size == 0) {
+        throw std::invalid_argument{
+            "The maximum queue size must be greater than zero."};
+    }
+
+    auto state = std::make_shared<detail::fanout_state>(
+        std::move(rdr), num_consumers, policy, max_queue_size);
+
+    std::vector<intrusive_ptr<data_reader>> consumers{};
+    consumers.reserve(num_consumers);
+
+    for (std::size_t i = 0; i < num_consumers; i++) {
+        consumers.emplace_back(
+            make_intrusive<detail::fanout_consumer>(state, i));
+    }
+
+    return consumers;
+}
+
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/global_shuffled_instance_reader.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "mlio/data_reader.h"
+#include "mlio/logger.h"
+#include "mlio/reader_state.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+global_shuffled_instance_reader::global_shuffled_instance_reader(
+    data_reader_params const &prm,
+    std::unique_ptr<default_instance_reader> &&inner)
+    : params_{&prm}, inner_{std::move(inner)}
+{
+    if (params_->shuffle_seed != std::nullopt) {
+        seed_ = *params_->shuffle_seed;
+        mt_.seed(seed_);
+    }
+}
+
+std::optional<instance>
+global_shuffled_instance_reader::read_instance_core()
+{
+    if (!indexed_) {
+        index_instances();
+    }
+
+    if (entries_.empty()) {
+        return {};
+    }
+
+    entry ent = entries_.back();
+
+    entries_.pop_back();
+
+    if (ent.store_idx == buffered_store_idx) {
+        return std::move(instances_[ent.position]);
+    }
+
+    return inner_->read_instance_at({ent.store_idx, ent.position},
+                                    ent.instance_idx);
+}
+
+void
+global_shuffled_instance_reader::skip_instances_core(std::size_t num_instances)
+{
+    if (!indexed_) {
+        index_instances();
+    }
+
+    num_instances = std::min(num_instances, entries_.size());
+
+    // Skipped instances are never materialized.
+    entries_.resize(entries_.size() - num_instances);
+}
+
+void
+global_shuffled_instance_reader::index_instances()
+{
+    std::size_t num_buffered = 0;
+
+    std::optional<instance> ins{};
+    while ((ins = inner_->read_instance())) {
+        std::optional<instance_location> loc =
+            inner_->last_instance_location();
+        if (loc) {
+            entries_.push_back(
+                entry{loc->store_idx, loc->position, ins->index()});
+        }
+        else {
+            entries_.push_back(
+                entry{buffered_store_idx, instances_.size(), ins->index()});
+
+            instances_.emplace_back(std::move(*ins));
+
+            num_buffered++;
+        }
+    }
+
+    if (num_buffered > 0) {
+        logger::info("{0:n} instance(s) cannot be read lazily and have been "
+                     "buffered in memory for shuffling.",
+                     num_buffered);
+    }
+
+    pre_shuffle_mt_ = mt_;
+
+    std::shuffle(entries_.begin(), entries_.end(), mt_);
+
+    indexed_ = true;
+}
+
+void
+global_shuffled_instance_reader::reset() noexcept
+{
+    inner_->reset();
+
+    entries_.clear();
+
+    instances_.clear();
+
+    indexed_ = false;
+
+    // Make sure that we reset the random number generator engine to
+    // its initial state if reshuffling is not desired.
+    if (!params_->reshuffle_each_epoch) {
+        mt_.seed(seed_);
+    }
+}
+
+void
+global_shuffled_instance_reader::save_state(state_writer &wr) const
+{
+    wr.write(seed_);
+
+    wr.write(indexed_);
+
+    // Once the dataset is indexed, the permutation is saved as the
+    // engine state it was generated from along with the number of
+    // entries that are yet to be read.
+    if (indexed_) {
+        wr.write(pre_shuffle_mt_);
+        wr.write(entries_.size());
+    }
+    else {
+        wr.write(mt_);
+    }
+}
+
+void
+global_shuffled_instance_reader::restore_state_core(state_reader &rd)
+{
+    std::uint_fast64_t seed = rd.read_uint64();
+
+    bool indexed = rd.read_bool();
+
+    std::mt19937_64 mt{};
+    rd.read(mt);
+
+    std::size_t num_entries{};
+    if (indexed) {
+        num_entries = rd.read_size();
+    }
+
+    reset();
+
+    seed_ = seed;
+
+    mt_ = mt;
+
+    if (!indexed) {
+        return;
+    }
+
+    // The locations of the instances have to be collected again; this
+    // does not involve decoding the instances though.
+    index_instances();
+
+    if (num_entries > entries_.size()) {
+        throw std::invalid_argument{
+            "The state does not match the dataset of the reader."};
+    }
+
+    entries_.resize(num_entries);
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "mlio/default_instance_reader.h"
+#include "mlio/fwd.h"
+#include "mlio/instance.h"
+#include "mlio/instance_reader_base.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+// Performs a perfect shuffle of the dataset. Instead of buffering the
+// whole dataset, it keeps only the location of each instance and reads
+// them lazily in permuted order. This is only possible for data stores
+// that can be read without copying (e.g. memory-mapped files); the
+// instances of other data stores are buffered as a fallback.
+class global_shuffled_instance_reader final : public instance_reader_base {
+    struct entry {
+        std::size_t store_idx;
+        std::size_t position;
+        std::size_t instance_idx;
+    };
+
+    // Marks the entries whose instance is buffered in instances_.
+    static constexpr std::size_t buffered_store_idx =
+        std::numeric_limits<std::size_t>::max();
+
+public:
+    explicit global_shuffled_instance_reader(
+        data_reader_params const &prm,
+        std::unique_ptr<default_instance_reader> &&inner);
+
+private:
+    std::optional<instance>
+    read_instance_core() final;
+
+    void
+    skip_instances_core(std::size_t num_instances) final;
+
+    void
+    restore_state_core(state_reader &rd) final;
+
+    void
+    index_instances();
+
+public:
+    void
+    reset() noexcept final;
+
+    void
+    save_state(state_writer &wr) const final;
+
+public:
+    std::size_t
+    num_bytes_read() const noexcept final
+    {
+        return inner_->num_bytes_read();
+    }
+
+private:
+    data_reader_params const *params_;
+    std::unique_ptr<default_instance_reader> inner_;
+    std::vector<entry> entries_{};
+    std::vector<instance> instances_{};
+    bool indexed_{};
+    std::random_device rd_{};
+    std::uint_fast64_t seed_{rd_()};
+    std::mt19937_64 mt_{seed_};
+    // The state of the engine right before the entries were shuffled;
+    // used to reproduce the permutation when restoring a saved state.
+    std::mt19937_64 pre_shuffle_mt_{};
+};
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
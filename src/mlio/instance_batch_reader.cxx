@@ -21,20 +21,37 @@
 #include "mlio/instance.h"
 #include "mlio/instance_batch.h"
 #include "mlio/logger.h"
+#include "mlio/pipeline_statistics.h"
+#include "mlio/reader_state.h"
 
 namespace mlio {
 inline namespace v1 {
 namespace detail {
 
 instance_batch_reader::instance_batch_reader(data_reader_params const &prm,
-                                             instance_reader &rdr)
-    : params_{&prm}, reader_{&rdr}
+                                             instance_reader &rdr,
+                                             pipeline_statistics *stats)
+    : params_{&prm}, reader_{&rdr}, stats_{stats}
 {
     if (params_->batch_size == 0) {
         throw std::invalid_argument{
             "The batch size must be greater than zero."};
     }
 
+    if (params_->batch_size_bytes == std::size_t{0}) {
+        throw std::invalid_argument{
+            "The batch size in bytes must be greater than zero."};
+    }
+
+    // A batch sized in bytes has no fixed size to pad the last batch
+    // to; padding it to batch_size would fill it with mostly padding.
+    if (params_->batch_size_bytes &&
+        params_->last_batch_hnd == last_batch_handling::pad) {
+        throw std::invalid_argument{
+            "The last batch cannot be padded if the batch size is "
+            "specified in bytes."};
+    }
+
     if (params_->subsample_ratio == std::nullopt) {
         return;
     }
@@ -44,18 +61,32 @@ instance_batch_reader::instance_batch_reader(data_reader_params const &prm,
         throw std::invalid_argument{"The subsampling ratio must be greater "
                                     "than zero and less than one."};
     }
-
-    auto tmp = static_cast<float>(params_->batch_size);
-
-    num_instances_to_skip_ =
-        static_cast<std::size_t>(tmp / sbr) - params_->batch_size;
 }
 
 std::optional<instance_batch>
 instance_batch_reader::read_instance_batch()
 {
+    using clock = pipeline_statistics::clock;
+
+    clock::time_point start{};
+    if (stats_ != nullptr) {
+        start = clock::now();
+    }
+
+    std::optional<std::size_t> const &budget = params_->batch_size_bytes;
+
     std::vector<instance> instances{};
-    instances.reserve(params_->batch_size);
+
+    // If the batches are sized by cost, the batch size is only an upper
+    // bound and might be much larger than the actual number of
+    // instances.
+    if (budget == std::nullopt) {
+        instances.reserve(params_->batch_size);
+    }
+
+    std::size_t cost = 0;
+
+    bool is_full = false;
 
     for (std::size_t i = 0; i < params_->batch_size; i++) {
         std::optional<instance> ins = reader_->read_instance();
@@ -63,36 +94,93 @@ instance_batch_reader::read_instance_batch()
             break;
         }
 
+        if (budget) {
+            cost += get_instance_cost(*ins);
+        }
+
         instances.emplace_back(std::move(*ins));
+
+        if (budget && cost >= *budget) {
+            is_full = true;
+
+            break;
+        }
+    }
+
+    if (instances.size() == params_->batch_size) {
+        is_full = true;
     }
 
-    if (instances.size() != params_->batch_size) {
+    if (!is_full) {
         if (params_->last_batch_hnd == last_batch_handling::drop) {
             logger::debug("The last batch has been dropped.");
 
+            if (stats_ != nullptr) {
+                stats_->add_instance_read_time(clock::now() - start);
+
+                if (!instances.empty()) {
+                    stats_->add_dropped_batch();
+                }
+            }
+
             return {};
         }
     }
 
     if (instances.empty()) {
+        if (stats_ != nullptr) {
+            stats_->add_instance_read_time(clock::now() - start);
+        }
+
         return {};
     }
 
-    for (std::size_t i = 0; i < num_instances_to_skip_; i++) {
-        if (reader_->read_instance() == std::nullopt) {
-            break;
-        }
+    reader_->skip_instances(get_num_instances_to_skip(instances.size()));
+
+    if (stats_ != nullptr) {
+        stats_->add_instance_read_time(clock::now() - start);
     }
 
     std::size_t size;
-    if (params_->last_batch_hnd == last_batch_handling::pad) {
+    if (!is_full && params_->last_batch_hnd == last_batch_handling::pad) {
         size = params_->batch_size;
     }
     else {
         size = instances.size();
     }
 
-    return instance_batch{batch_idx_++, std::move(instances), size};
+    instance_batch batch{batch_idx_++, std::move(instances), size};
+
+    if (stats_ != nullptr) {
+        stats_->add_batch_read_time(clock::now() - start);
+    }
+
+    return batch;
+}
+
+std::size_t
+instance_batch_reader::get_instance_cost(instance const &ins) const
+{
+    if (params_->instance_cost_fn) {
+        return params_->instance_cost_fn(ins);
+    }
+    return ins.bits().size();
+}
+
+std::size_t
+instance_batch_reader::get_num_instances_to_skip(
+    std::size_t num_instances) const noexcept
+{
+    if (params_->subsample_ratio == std::nullopt) {
+        return 0;
+    }
+
+    // The number of instances to skip is proportional to the size of
+    // the batch, which varies if the batches are sized by cost.
+    auto tmp = static_cast<float>(num_instances);
+
+    return static_cast<std::size_t>(tmp / *params_->subsample_ratio) -
+           num_instances;
 }
 
 void
@@ -103,6 +191,24 @@ instance_batch_reader::reset() noexcept
     batch_idx_ = 0;
 }
 
+void
+instance_batch_reader::save_state(state_writer &wr) const
+{
+    wr.write(batch_idx_);
+
+    reader_->save_state(wr);
+}
+
+void
+instance_batch_reader::restore_state(state_reader &rd)
+{
+    std::size_t batch_idx = rd.read_size();
+
+    reader_->restore_state(rd);
+
+    batch_idx_ = batch_idx;
+}
+
 }  // namespace detail
 }  // namespace v1
 }  // namespace mlio
@@ -29,7 +29,8 @@ namespace detail {
 class instance_batch_reader {
 public:
     explicit instance_batch_reader(data_reader_params const &prm,
-                                   instance_reader &rdr);
+                                   instance_reader &rdr,
+                                   pipeline_statistics *stats = nullptr);
 
 public:
     std::optional<instance_batch>
@@ -38,10 +39,23 @@ public:
     void
     reset() noexcept;
 
+    void
+    save_state(state_writer &wr) const;
+
+    void
+    restore_state(state_reader &rd);
+
+private:
+    std::size_t
+    get_instance_cost(instance const &ins) const;
+
+    std::size_t
+    get_num_instances_to_skip(std::size_t num_instances) const noexcept;
+
 private:
     data_reader_params const *params_;
     instance_reader *reader_;
-    std::size_t num_instances_to_skip_{};
+    pipeline_statistics *stats_;
     std::size_t batch_idx_{};
 };
 
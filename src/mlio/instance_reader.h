@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <optional>
 
 #include "mlio/fwd.h"
@@ -48,9 +49,24 @@ public:
     virtual std::optional<instance> const &
     peek_instance() = 0;
 
+    // Skips the specified number of instances. Derived classes might
+    // avoid reading the skipped instances altogether.
+    virtual void
+    skip_instances(std::size_t num_instances) = 0;
+
     virtual void
     reset() noexcept = 0;
 
+    // Writes the current position of the reader. Should not be called
+    // while an instance is peeked.
+    virtual void
+    save_state(state_writer &wr) const = 0;
+
+    // Moves the reader to a position previously written by
+    // save_state().
+    virtual void
+    restore_state(state_reader &rd) = 0;
+
 public:
     virtual std::size_t
     num_bytes_read() const noexcept = 0;
@@ -37,6 +37,40 @@ instance_reader_base::peek_instance()
     return peeked_instance_;
 }
 
+void
+instance_reader_base::skip_instances(std::size_t num_instances)
+{
+    if (num_instances == 0) {
+        return;
+    }
+
+    if (peeked_instance_) {
+        peeked_instance_ = std::nullopt;
+
+        num_instances--;
+    }
+
+    skip_instances_core(num_instances);
+}
+
+void
+instance_reader_base::restore_state(state_reader &rd)
+{
+    peeked_instance_ = std::nullopt;
+
+    restore_state_core(rd);
+}
+
+void
+instance_reader_base::skip_instances_core(std::size_t num_instances)
+{
+    for (std::size_t i = 0; i < num_instances; i++) {
+        if (read_instance_core() == std::nullopt) {
+            break;
+        }
+    }
+}
+
 }  // namespace detail
 }  // namespace v1
 }  // namespace mlio
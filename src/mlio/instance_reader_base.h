@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <optional>
 
 #include "mlio/instance.h"
@@ -32,10 +33,23 @@ public:
     std::optional<instance> const &
     peek_instance() final;
 
+    void
+    skip_instances(std::size_t num_instances) final;
+
+    void
+    restore_state(state_reader &rd) final;
+
 private:
     virtual std::optional<instance>
     read_instance_core() = 0;
 
+    // The default implementation reads and discards the instances.
+    virtual void
+    skip_instances_core(std::size_t num_instances);
+
+    virtual void
+    restore_state_core(state_reader &rd) = 0;
+
 private:
     std::optional<instance> peeked_instance_{};
 };
@@ -15,12 +15,24 @@
 
 #include "mlio/logger.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
 #include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
 #include <fmt/format.h>
 
+#ifdef MLIO_PLATFORM_POSIX
+#    include <pthread.h>
+#endif
+
 namespace mlio {
 inline namespace v1 {
 namespace logger {
@@ -64,12 +76,209 @@ handle_message(log_level lvl,
 
 }  // namespace detail
 
+namespace {
+
+// Passes the messages queued by log_async() to the log handler on a
+// dedicated thread. Once the sink is stopped, or in a child process
+// forked after the sink has been started, the messages are handled
+// synchronously.
+class async_sink {
+    // The maximum number of messages waiting to be handled.
+    static constexpr std::size_t max_num_messages_ = 1024;
+
+    struct message {
+        log_level lvl{};
+        std::string msg{};
+    };
+
+public:
+    async_sink() : thread_{&async_sink::run, this}
+    {}
+
+public:
+    void
+    push(log_level lvl, std::string &&msg)
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            if (is_stopped_) {
+                lock.unlock();
+
+                detail::handle_message(lvl, msg);
+
+                return;
+            }
+
+            if (messages_.size() == max_num_messages_) {
+                num_dropped_++;
+
+                return;
+            }
+
+            messages_.push_back(message{lvl, std::move(msg)});
+        }
+
+        condition_.notify_one();
+    }
+
+    // Handles the pending messages and joins the thread.
+    void
+    stop() noexcept
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            if (is_stopped_) {
+                return;
+            }
+
+            is_stopped_ = true;
+        }
+
+        condition_.notify_one();
+
+        if (thread_.get_id() != std::this_thread::get_id()) {
+            thread_.join();
+        }
+    }
+
+    // The mutex is held across fork() so that the child inherits the
+    // queue in a consistent state.
+    void
+    before_fork() noexcept
+    {
+        mutex_.lock();
+    }
+
+    void
+    after_fork_in_parent() noexcept
+    {
+        mutex_.unlock();
+    }
+
+    void
+    after_fork_in_child() noexcept
+    {
+        // The thread does not exist in the child and the queued messages
+        // are handled by the parent.
+        messages_.clear();
+
+        num_dropped_ = 0;
+
+        is_stopped_ = true;
+
+        mutex_.unlock();
+    }
+
+private:
+    void
+    run()
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        while (true) {
+            condition_.wait(lock, [this] {
+                return !messages_.empty() || is_stopped_;
+            });
+
+            if (messages_.empty()) {
+                return;
+            }
+
+            message m = std::move(messages_.front());
+
+            messages_.pop_front();
+
+            std::size_t num_dropped = std::exchange(num_dropped_, 0);
+
+            lock.unlock();
+
+            if (num_dropped > 0) {
+                detail::handle_message(
+                    log_level::warning,
+                    "{0:n} log message(s) have been dropped as the log "
+                    "handler could not keep up.",
+                    fmt::make_format_args(num_dropped));
+            }
+
+            detail::handle_message(m.lvl, m.msg);
+
+            lock.lock();
+        }
+    }
+
+private:
+    std::mutex mutex_{};
+    std::condition_variable condition_{};
+    std::deque<message> messages_{};
+    std::size_t num_dropped_{};
+    bool is_stopped_{};
+    std::thread thread_;
+};
+
+std::atomic<async_sink *> sink_{};
+
+async_sink *
+make_async_sink()
+{
+    // Intentionally leaked so that the sink outlives all threads that
+    // might still be logging while the process exits; only its thread
+    // is joined at exit.
+    auto *sink = new async_sink{};  // NOLINT
+
+    sink_ = sink;
+
+    std::atexit([] {
+        sink_.load()->stop();
+    });
+
+#ifdef MLIO_PLATFORM_POSIX
+    ::pthread_atfork(
+        [] {
+            sink_.load()->before_fork();
+        },
+        [] {
+            sink_.load()->after_fork_in_parent();
+        },
+        [] {
+            sink_.load()->after_fork_in_child();
+        });
+#endif
+
+    return sink;
+}
+
+async_sink *
+get_async_sink()
+{
+    static async_sink *sink = make_async_sink();
+
+    return sink;
+}
+
+}  // namespace
+
 bool
 is_enabled_for(log_level lvl) noexcept
 {
     return lvl <= level_;
 }
 
+void
+log_async(log_level lvl, std::string msg) noexcept
+{
+    if (!is_enabled_for(lvl)) {
+        return;
+    }
+
+    try {
+        get_async_sink()->push(lvl, std::move(msg));
+    }
+    catch (...) {
+    }
+}
+
 }  // namespace logger
 
 log_message_handler
@@ -78,6 +287,16 @@ set_log_message_handler(log_message_handler hdl) noexcept
     return std::exchange(logger::msg_handler_, std::move(hdl));
 }
 
+void
+stop_async_logging() noexcept
+{
+    // Only stop a sink that has been started.
+    logger::async_sink *sink = logger::sink_.load();
+    if (sink != nullptr) {
+        sink->stop();
+    }
+}
+
 void
 set_log_level(log_level lvl) noexcept
 {
@@ -15,7 +15,9 @@
 
 #pragma once
 
+#include <string>
 #include <string_view>
+#include <utility>
 
 #include <fmt/format.h>
 
@@ -39,6 +41,12 @@ handle_message(log_level lvl,
 bool
 is_enabled_for(log_level lvl) noexcept;
 
+// Hands the message over to a background thread that passes it to the
+// log handler, so that the caller never blocks on a slow handler. If
+// the handler cannot keep up, excess messages are dropped.
+void
+log_async(log_level lvl, std::string msg) noexcept;
+
 inline void
 log(log_level lvl, std::string_view msg) noexcept
 {
@@ -69,6 +77,12 @@ warn(std::string_view fmt, Args const &... args) noexcept
     log(log_level::warning, fmt, args...);
 }
 
+inline void
+warn_async(std::string msg) noexcept
+{
+    log_async(log_level::warning, std::move(msg));
+}
+
 inline void
 info(std::string_view msg) noexcept
 {
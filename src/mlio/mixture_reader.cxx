@@ -0,0 +1,479 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/mixture_reader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "mlio/cpu_array.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/schema.h"
+#include "mlio/tensor.h"
+#include "mlio/tensor_rows.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+// Indicates whether the instances of the examples of the specified
+// schemas can be mixed. The batch dimension is not compared since it
+// varies from batch to batch.
+bool
+is_mixable(schema const &lhs, schema const &rhs) noexcept
+{
+    if (&lhs == &rhs) {
+        return true;
+    }
+
+    auto const &lhs_descs = lhs.descriptors();
+    auto const &rhs_descs = rhs.descriptors();
+
+    return std::equal(lhs_descs.begin(),
+                      lhs_descs.end(),
+                      rhs_descs.begin(),
+                      rhs_descs.end(),
+                      [](auto const &l, auto const &r) {
+                          size_vector const &ls = l.shape();
+                          size_vector const &rs = r.shape();
+
+                          return l.name() == r.name() &&
+                                 l.dtype() == r.dtype() &&
+                                 l.sparse() == r.sparse() && !ls.empty() &&
+                                 !rs.empty() &&
+                                 std::equal(ls.begin() + 1,
+                                            ls.end(),
+                                            rs.begin() + 1,
+                                            rs.end());
+                      });
+}
+
+}  // namespace
+}  // namespace detail
+
+mixture_reader::mixture_reader(std::vector<intrusive_ptr<data_reader>> readers,
+                               std::vector<double> const &weights,
+                               mixture_granularity granularity,
+                               std::size_t batch_size,
+                               exhaustion_policy exhaustion,
+                               std::optional<std::uint_fast64_t> seed,
+                               last_batch_handling last_batch_hnd)
+    : granularity_{granularity}
+    , batch_size_{batch_size}
+    , exhaustion_{exhaustion}
+    , last_batch_hnd_{last_batch_hnd}
+{
+    if (readers.empty()) {
+        throw std::invalid_argument{
+            "At least one data reader must be specified."};
+    }
+
+    if (readers.size() != weights.size()) {
+        throw std::invalid_argument{
+            "The number of weights must match the number of data readers."};
+    }
+
+    if (granularity_ == mixture_granularity::instance && batch_size_ == 0) {
+        throw std::invalid_argument{
+            "The batch size must be greater than zero."};
+    }
+
+    sources_.reserve(readers.size());
+
+    bool has_weight = false;
+
+    for (std::size_t i = 0; i < readers.size(); i++) {
+        if (readers[i] == nullptr) {
+            throw std::invalid_argument{"The data readers must not be null."};
+        }
+
+        double weight = weights[i];
+        if (!std::isfinite(weight) || weight < 0) {
+            throw std::invalid_argument{
+                "The weights must be non-negative finite numbers."};
+        }
+
+        if (weight > 0) {
+            has_weight = true;
+        }
+
+        source src{};
+        src.reader = std::move(readers[i]);
+        src.weight = weight;
+        src.is_active = weight > 0;
+
+        sources_.emplace_back(std::move(src));
+    }
+
+    if (!has_weight) {
+        throw std::invalid_argument{
+            "At least one weight must be greater than zero."};
+    }
+
+    if (seed) {
+        seed_ = *seed;
+
+        mt_.seed(seed_);
+    }
+
+    update_distribution();
+}
+
+mixture_reader::~mixture_reader() = default;
+
+intrusive_ptr<example>
+mixture_reader::read_example()
+{
+    if (peeked_example_) {
+        return std::exchange(peeked_example_, nullptr);
+    }
+    return read_example_core();
+}
+
+intrusive_ptr<example> const &
+mixture_reader::peek_example()
+{
+    if (peeked_example_ == nullptr) {
+        peeked_example_ = read_example_core();
+    }
+    return peeked_example_;
+}
+
+intrusive_ptr<example>
+mixture_reader::read_example_core()
+{
+    if (is_exhausted_) {
+        return {};
+    }
+
+    if (granularity_ == mixture_granularity::batch) {
+        return read_batch();
+    }
+    return read_rows();
+}
+
+intrusive_ptr<example>
+mixture_reader::read_batch()
+{
+    while (!is_exhausted_) {
+        source *src = draw_source();
+        if (src == nullptr) {
+            is_exhausted_ = true;
+
+            break;
+        }
+
+        intrusive_ptr<example> exm = read_source_example(*src);
+        if (exm != nullptr) {
+            return exm;
+        }
+    }
+    return {};
+}
+
+intrusive_ptr<example>
+mixture_reader::read_rows()
+{
+    std::vector<row_range> ranges{};
+
+    std::size_t num_rows = 0;
+
+    while (num_rows < batch_size_) {
+        source *src = draw_source();
+        if (src == nullptr) {
+            is_exhausted_ = true;
+
+            break;
+        }
+
+        if (!fill_source_rows(*src)) {
+            if (is_exhausted_) {
+                break;
+            }
+            continue;
+        }
+
+        // Consecutive rows of the same example are copied at once.
+        if (!ranges.empty() && ranges.back().exm == src->exm &&
+            ranges.back().end == src->row_idx) {
+            ranges.back().end++;
+        }
+        else {
+            ranges.emplace_back(
+                row_range{src->exm, src->row_idx, src->row_idx + 1});
+        }
+
+        src->row_idx++;
+
+        num_rows++;
+    }
+
+    if (num_rows == 0) {
+        return {};
+    }
+
+    // This is the last batch.
+    if (num_rows < batch_size_) {
+        if (last_batch_hnd_ == last_batch_handling::drop) {
+            return {};
+        }
+
+        if (last_batch_hnd_ == last_batch_handling::none) {
+            return make_copy(ranges, num_rows, num_rows);
+        }
+    }
+
+    return make_copy(ranges, num_rows, batch_size_);
+}
+
+mixture_reader::source *
+mixture_reader::draw_source()
+{
+    if (active_sources_.empty()) {
+        return nullptr;
+    }
+    return &sources_[active_sources_[dist_(mt_)]];
+}
+
+intrusive_ptr<example>
+mixture_reader::read_source_example(source &src)
+{
+    intrusive_ptr<example> exm = src.reader->read_example();
+    if (exm != nullptr) {
+        return exm;
+    }
+
+    switch (exhaustion_) {
+    case exhaustion_policy::stop:
+        is_exhausted_ = true;
+
+        break;
+
+    case exhaustion_policy::drop_source:
+        deactivate(src);
+
+        break;
+
+    case exhaustion_policy::restart_source:
+        src.reader->reset();
+
+        exm = src.reader->read_example();
+
+        // An empty source would be restarted forever.
+        if (exm == nullptr) {
+            deactivate(src);
+        }
+
+        break;
+    }
+
+    return exm;
+}
+
+bool
+mixture_reader::fill_source_rows(source &src)
+{
+    while (src.row_idx == src.num_rows) {
+        intrusive_ptr<example> exm = read_source_example(src);
+        if (exm == nullptr) {
+            return false;
+        }
+
+        src.num_rows = detail::get_batch_size(*exm) - exm->padding;
+
+        src.row_idx = 0;
+
+        src.exm = std::move(exm);
+    }
+    return true;
+}
+
+void
+mixture_reader::deactivate(source &src)
+{
+    src.is_active = false;
+
+    src.exm = nullptr;
+
+    src.row_idx = 0;
+    src.num_rows = 0;
+
+    update_distribution();
+}
+
+intrusive_ptr<example>
+mixture_reader::make_copy(std::vector<row_range> const &ranges,
+                          std::size_t num_rows,
+                          std::size_t batch_size)
+{
+    example const &first = *ranges.front().exm;
+
+    std::size_t num_features = first.features().size();
+
+    std::vector<std::unique_ptr<device_array>> arrays{};
+    arrays.reserve(num_features);
+
+    // Allocate the zero-initialized arrays of the batch; the padding, if
+    // any, is left as is.
+    for (auto const &tsr : first.features()) {
+        std::size_t size = batch_size * detail::get_row_size(*tsr);
+
+        arrays.emplace_back(make_cpu_array(tsr->dtype(), size));
+    }
+
+    std::size_t row_idx = 0;
+
+    for (row_range const &rng : ranges) {
+        example const &src = *rng.exm;
+
+        if (!detail::is_mixable(src.get_schema(), first.get_schema())) {
+            throw std::invalid_argument{
+                "The examples to mix must have the same schema."};
+        }
+
+        std::size_t n = rng.end - rng.begin;
+
+        for (std::size_t i = 0; i < num_features; i++) {
+            dense_tensor &dense = detail::as_dense_tensor(*src.features()[i]);
+
+            if (dense.dtype() != arrays[i]->dtype() ||
+                detail::get_row_size(dense) * batch_size !=
+                    arrays[i]->size()) {
+                throw std::invalid_argument{
+                    "The examples to mix must have the same features."};
+            }
+
+            detail::copy_rows(dense, rng.begin, *arrays[i], row_idx, n);
+        }
+
+        row_idx += n;
+    }
+
+    std::vector<intrusive_ptr<tensor>> tensors{};
+    tensors.reserve(num_features);
+
+    for (std::size_t i = 0; i < num_features; i++) {
+        size_vector shape = first.features()[i]->shape();
+        shape[0] = batch_size;
+
+        tensors.emplace_back(make_intrusive<dense_tensor>(
+            std::move(shape), std::move(arrays[i])));
+    }
+
+    schema const &source_schema = first.get_schema();
+
+    if (last_source_schema_.get() != &source_schema ||
+        last_batch_size_ != batch_size) {
+        last_source_schema_ = wrap_intrusive(&source_schema);
+
+        last_schema_ = detail::make_batch_schema(source_schema, batch_size);
+
+        last_batch_size_ = batch_size;
+    }
+
+    auto exm = make_intrusive<example>(last_schema_, std::move(tensors));
+
+    exm->padding = batch_size - num_rows;
+
+    return exm;
+}
+
+void
+mixture_reader::update_distribution()
+{
+    active_sources_.clear();
+
+    std::vector<double> weights{};
+
+    for (std::size_t i = 0; i < sources_.size(); i++) {
+        if (sources_[i].is_active) {
+            active_sources_.emplace_back(i);
+
+            weights.emplace_back(sources_[i].weight);
+        }
+    }
+
+    dist_ = std::discrete_distribution<std::size_t>(weights.begin(),
+                                                    weights.end());
+}
+
+void
+mixture_reader::reset() noexcept
+{
+    for (source &src : sources_) {
+        src.reader->reset();
+
+        src.is_active = src.weight > 0;
+
+        src.exm = nullptr;
+
+        src.row_idx = 0;
+        src.num_rows = 0;
+    }
+
+    mt_.seed(seed_);
+
+    update_distribution();
+
+    is_exhausted_ = false;
+
+    peeked_example_ = nullptr;
+}
+
+data_reader_statistics
+mixture_reader::statistics() const
+{
+    data_reader_statistics stats{};
+
+    for (source const &src : sources_) {
+        data_reader_statistics s = src.reader->statistics();
+
+        stats.data_stores.insert(stats.data_stores.end(),
+                                 s.data_stores.begin(),
+                                 s.data_stores.end());
+
+        stats.stream_read_time += s.stream_read_time;
+        stats.record_split_time += s.record_split_time;
+        stats.batch_assembly_time += s.batch_assembly_time;
+        stats.decode_time += s.decode_time;
+        stats.transform_time += s.transform_time;
+        stats.wait_time += s.wait_time;
+
+        stats.num_queued_examples += s.num_queued_examples;
+        stats.num_batches_read += s.num_batches_read;
+        stats.num_bad_batches += s.num_bad_batches;
+        stats.num_bad_records += s.num_bad_records;
+        stats.num_dropped_batches += s.num_dropped_batches;
+    }
+
+    return stats;
+}
+
+std::size_t
+mixture_reader::num_bytes_read() const noexcept
+{
+    std::size_t num_bytes = 0;
+    for (source const &src : sources_) {
+        num_bytes += src.reader->num_bytes_read();
+    }
+    return num_bytes;
+}
+
+}  // namespace v1
+}  // namespace mlio
@@ -16,38 +16,163 @@
 #include "mlio/parallel_data_reader.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <stdexcept>
 #include <tuple>
 #include <utility>
 #include <vector>
 
 #include <tbb/tbb.h>
 
+#include "mlio/autotuner.h"
+#include "mlio/bad_record_reporter.h"
 #include "mlio/data_reader.h"
+#include "mlio/data_stores/data_store.h"
 #include "mlio/default_instance_reader.h"
 #include "mlio/detail/thread.h"
 #include "mlio/example.h"
+#include "mlio/global_shuffled_instance_reader.h"
 #include "mlio/instance_batch.h"
 #include "mlio/instance_batch_reader.h"
 #include "mlio/instance_reader.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/pipeline_statistics.h"
+#include "mlio/reader_state.h"
+#include "mlio/record_readers/record_index.h"
+#include "mlio/record_readers/record_reader.h"
 #include "mlio/shuffled_instance_reader.h"
+#include "mlio/task_executor.h"
+#include "mlio/tensor.h"
+#include "mlio/tensor_visitor.h"
 
+using mlio::detail::autotuner;
+using mlio::detail::bad_record_reporter;
 using mlio::detail::default_instance_reader;
+using mlio::detail::global_shuffled_instance_reader;
 using mlio::detail::instance_batch_reader;
+using mlio::detail::pipeline_statistics;
 using mlio::detail::shuffled_instance_reader;
+using mlio::detail::task_executor;
 
 namespace mlio {
 inline namespace v1 {
 
+namespace detail {
+namespace {
+
+// The layout of a saved state is a sequence of little-endian 64-bit
+// integers: magic ("MLIOSTAT"), version, number of data stores, batch
+// size, a flag indicating whether any batch has been read, the epoch,
+// and the state of the instance batch reader.
+constexpr std::uint64_t reader_state_magic = 0x5441'5453'4f49'4c4d;
+constexpr std::uint64_t reader_state_version = 2;
+
+// If the reader is not tuned, batches with fewer values than this
+// cut-off are decoded serially; otherwise the threading overhead slows
+// down the performance.
+constexpr std::size_t parallel_decode_cut_off = 10'000'000;
+
+template<data_type dt>
+struct get_num_bytes_op {
+    std::size_t
+    operator()(device_array_view arr)
+    {
+        return arr.size() * sizeof(data_type_t<dt>);
+    }
+};
+
+template<>
+struct get_num_bytes_op<data_type::string> {
+    std::size_t
+    operator()(device_array_view arr)
+    {
+        std::size_t num_bytes = arr.size() * sizeof(std::string);
+        for (std::string const &s : arr.as<std::string>()) {
+            num_bytes += s.size();
+        }
+        return num_bytes;
+    }
+};
+
+std::size_t
+get_num_bytes(device_array_view arr)
+{
+    return dispatch<get_num_bytes_op>(arr.dtype(), arr);
+}
+
+// Computes the memory footprint of the tensors of an example.
+struct get_example_num_bytes_op : public tensor_visitor {
+    using tensor_visitor::visit;
+
+    void
+    visit(dense_tensor const &tsr) override
+    {
+        num_bytes += get_num_bytes(tsr.data());
+    }
+
+    void
+    visit(coo_tensor const &tsr) override
+    {
+        num_bytes += get_num_bytes(tsr.data());
+
+        for (std::size_t dim = 0; dim < tsr.shape().size(); dim++) {
+            num_bytes += get_num_bytes(tsr.indices(dim));
+        }
+    }
+
+    void
+    visit(csr_tensor const &tsr) override
+    {
+        num_bytes += get_num_bytes(tsr.data());
+        num_bytes += get_num_bytes(tsr.indices());
+        num_bytes += get_num_bytes(tsr.indptr());
+    }
+
+    std::size_t num_bytes{};
+};
+
+std::size_t
+get_num_bytes(example const &exm)
+{
+    get_example_num_bytes_op op{};
+
+    for (auto const &tsr : exm.features()) {
+        static_cast<tensor const &>(*tsr).accept(op);
+    }
+
+    return op.num_bytes;
+}
+
+std::size_t
+get_num_bytes(instance_batch const &batch)
+{
+    std::size_t num_bytes = 0;
+    for (instance const &ins : batch.instances()) {
+        num_bytes += ins.bits().size();
+    }
+    return num_bytes;
+}
+
+}  // namespace
+}  // namespace detail
+
 // Used as a message in the TBB flow graph.
-struct batch_msg {
+struct parallel_data_reader::batch_msg {
+    std::size_t idx{};
     std::shared_ptr<instance_batch> batch{};
+    std::shared_ptr<detail::state_writer const> state{};
+    std::size_t num_bytes{};
+    std::size_t epoch{};
+    bool end_of_epoch{};
 };
 
 // Used as a message in the TBB flow graph.
 struct example_msg {
     std::size_t idx{};
     intrusive_ptr<example> exm{};
+    std::shared_ptr<detail::state_writer const> state{};
+    std::size_t num_bytes{};
 };
 
 // Holds the TBB flow graph objects.
@@ -56,24 +181,69 @@ struct parallel_data_reader::graph_data {
     tbb::flow::graph obj{ctx};
     tbb::flow::source_node<batch_msg> *src_node{};
     std::vector<std::unique_ptr<tbb::flow::graph_node>> nodes{};
+    // The batch read ahead by the source node to find out whether the
+    // current batch is the last one of its epoch.
+    std::optional<batch_msg> next_msg{};
+    // The sequence number of the next batch; unlike the batch index it
+    // does not restart at each epoch.
+    std::size_t next_idx{};
 };
 
 parallel_data_reader::parallel_data_reader(data_reader_params &&prm)
-    : data_reader_base{std::move(prm)}, graph_{std::make_unique<graph_data>()}
+    : data_reader_base{std::move(prm)}
+    , stats_{std::make_unique<pipeline_statistics>(params().dataset.size())}
+    , bad_record_reporter_{std::make_unique<bad_record_reporter>(
+          params(), effective_bad_batch_handling(), stats_.get())}
+    , executor_{std::make_unique<task_executor>(params())}
 {
     data_reader_params const &prms = params();
 
-    reader_ = std::make_unique<default_instance_reader>(
-        prms, [this](data_store const &ds) {
+    // The flow graph attaches to the arena it is constructed in.
+    graph_ = executor_->execute([] {
+        return std::make_unique<graph_data>();
+    });
+
+    executor_->apply_priority(graph_->ctx);
+
+    if (prms.max_prefetch_bytes == std::size_t{0}) {
+        throw std::invalid_argument{
+            "The maximum number of prefetched bytes must be greater than "
+            "zero."};
+    }
+
+    if (prms.autotune) {
+        autotuner_ = std::make_unique<autotuner>(executor_->max_concurrency(),
+                                                 prms.num_prefetched_batches,
+                                                 prms.num_parallel_reads);
+    }
+
+    auto inner = std::make_unique<default_instance_reader>(
+        prms,
+        [this](data_store const &ds) {
             return make_record_reader(ds);
-        });
+        },
+        stats_.get(),
+        bad_record_reporter_.get());
 
     if (prms.shuffle_instances) {
-        reader_ = std::make_unique<shuffled_instance_reader>(
-            prms, std::move(reader_));
+        // A perfect shuffle does not need to buffer the dataset if the
+        // instances can be read lazily.
+        if (prms.shuffle_window == 0 &&
+            prms.shuffle_window_bytes == std::nullopt) {
+            reader_ = std::make_unique<global_shuffled_instance_reader>(
+                prms, std::move(inner));
+        }
+        else {
+            reader_ = std::make_unique<shuffled_instance_reader>(
+                prms, std::move(inner));
+        }
+    }
+    else {
+        reader_ = std::move(inner);
     }
 
-    batch_reader_ = std::make_unique<instance_batch_reader>(prms, *reader_);
+    batch_reader_ =
+        std::make_unique<instance_batch_reader>(prms, *reader_, stats_.get());
 }
 
 parallel_data_reader::~parallel_data_reader() = default;
@@ -81,7 +251,11 @@ parallel_data_reader::~parallel_data_reader() = default;
 intrusive_ptr<example>
 parallel_data_reader::read_example_core()
 {
-    ensure_schema_inferred();
+    // If the pipeline has been started eagerly, the schema is inferred
+    // by the background thread.
+    if (state_ == state::not_started) {
+        ensure_schema_inferred();
+    }
 
     //                   ┌───< read_example_core() <───┐
     //                   │                             │
@@ -102,12 +276,20 @@ parallel_data_reader::read_example_core()
         ensure_pipeline_running();
 
         {
+            auto start = pipeline_statistics::clock::now();
+
             std::unique_lock<std::mutex> queue_lock{queue_mutex_};
 
             read_cond_.wait(queue_lock, [this] {
                 return state_ != state::running || !fill_queue_.empty();
             });
 
+            auto wait_time = pipeline_statistics::clock::now() - start;
+
+            stats_->add_wait_time(wait_time);
+
+            tune(wait_time);
+
             if (state_ == state::faulted) {
                 std::rethrow_exception(exception_ptr_);
             }
@@ -124,13 +306,77 @@ parallel_data_reader::read_example_core()
         return {};
     }
 
-    intrusive_ptr<example> exm = std::move(read_queue_.front());
+    queued_example &qe = read_queue_.front();
+
+    intrusive_ptr<example> exm = std::move(qe.exm);
+
+    commit_state(std::move(qe.state));
+
+    remove_prefetch_bytes(qe.num_bytes);
 
     read_queue_.pop_front();
 
+    stats_->add_queued_examples(-1);
+
     return exm;
 }
 
+void
+parallel_data_reader::read_example_async(read_callback callback)
+{
+    // If an example has already been peeked or prefetched, the read
+    // does not block.
+    if (!has_peeked_example() && read_queue_.empty()) {
+        try {
+            if (state_ == state::not_started) {
+                ensure_schema_inferred();
+            }
+
+            ensure_pipeline_running();
+        }
+        catch (...) {
+            callback(nullptr, std::current_exception());
+
+            return;
+        }
+
+        std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+        // Otherwise the callback will be invoked by the pipeline thread
+        // either when the next example is decoded or when the pipeline
+        // stops.
+        if (state_ == state::running && fill_queue_.empty()) {
+            pending_callback_ = std::move(callback);
+
+            return;
+        }
+    }
+
+    data_reader::read_example_async(std::move(callback));
+}
+
+void
+parallel_data_reader::complete_async_read(queued_example &&qe,
+                                          read_callback const &callback)
+{
+    commit_state(std::move(qe.state));
+
+    remove_prefetch_bytes(qe.num_bytes);
+
+    callback(std::move(qe.exm), nullptr);
+}
+
+void
+parallel_data_reader::commit_state(
+    std::shared_ptr<detail::state_writer const> &&snapshot)
+{
+    // An asynchronous read is completed on a pipeline thread, so the
+    // states are guarded against a concurrent call to save_state().
+    std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+    prev_state_ = std::exchange(last_state_, std::move(snapshot));
+}
+
 void
 parallel_data_reader::ensure_pipeline_running()
 {
@@ -143,22 +389,45 @@ parallel_data_reader::ensure_pipeline_running()
     thrd_ = detail::start_thread(&parallel_data_reader::run_pipeline, this);
 }
 
+void
+parallel_data_reader::start_eagerly()
+{
+    if (params().eager_start) {
+        ensure_pipeline_running();
+    }
+}
+
 void
 parallel_data_reader::run_pipeline()
 {
+    // The graph does not depend on the schema, so it is built before the
+    // first data store is opened.
     if (graph_->src_node == nullptr) {
         init_graph();
     }
 
-    graph_->src_node->activate();
-
     try {
-        graph_->obj.wait_for_all();
+        // This is a no-op unless the pipeline has been started eagerly,
+        // in which case opening the first data store and reading its
+        // header happens here rather than in the caller's thread.
+        ensure_schema_inferred();
+
+        executor_->pin_current_thread();
+
+        // The background thread joins the arena so that it counts
+        // against its concurrency while waiting for the graph.
+        executor_->execute([this] {
+            graph_->src_node->activate();
+
+            graph_->obj.wait_for_all();
+        });
     }
     catch (std::exception const &) {
         exception_ptr_ = std::current_exception();
     }
 
+    read_callback callback{};
+
     {
         std::unique_lock<std::mutex> queue_lock{queue_mutex_};
 
@@ -168,9 +437,17 @@ parallel_data_reader::run_pipeline()
         else {
             state_ = state::stopped;
         }
+
+        callback = std::exchange(pending_callback_, nullptr);
     }
 
     read_cond_.notify_one();
+
+    // A pending asynchronous read is completed with the end of the
+    // dataset or with the error that has stopped the pipeline.
+    if (callback) {
+        callback(nullptr, exception_ptr_);
+    }
 }
 
 void
@@ -180,9 +457,10 @@ parallel_data_reader::init_graph()
 
     std::size_t num_prefetched_batches = params().num_prefetched_batches;
     if (num_prefetched_batches == 0) {
-        // Defaults to the number of processor cores.
-        num_prefetched_batches = static_cast<std::size_t>(
-            tbb::task_scheduler_init::default_num_threads());
+        // Defaults to the concurrency of the arena which, unless
+        // limited, is the number of processor cores available to the
+        // process.
+        num_prefetched_batches = executor_->max_concurrency();
     }
 
     std::size_t num_parallel_reads = params().num_parallel_reads;
@@ -191,20 +469,51 @@ parallel_data_reader::init_graph()
         num_parallel_reads = num_prefetched_batches;
     }
 
+    num_prefetched_batches_ = num_prefetched_batches;
+
+    // If the reader is tuned, the limiter only enforces the upper bound
+    // of parallel reads; the tuned number is enforced by the source.
+    if (autotuner_ != nullptr) {
+        num_parallel_reads = autotuner_->max_num_parallel_reads();
+    }
+
     flw::graph &g = graph_->obj;
 
     // Source
     auto src_node = std::make_unique<flw::source_node<batch_msg>>(
         g,
         [this](auto &msg) {
-            std::optional<instance_batch> btch =
-                batch_reader_->read_instance_batch();
-            if (btch == std::nullopt) {
+            if (!try_acquire_prefetch_budget()) {
                 return false;
             }
 
-            msg =
-                batch_msg{std::make_shared<instance_batch>(std::move(*btch))};
+            auto start = pipeline_statistics::clock::now();
+
+            std::optional<batch_msg> &next_msg = graph_->next_msg;
+
+            if (next_msg == std::nullopt) {
+                next_msg = read_batch();
+                if (next_msg == std::nullopt) {
+                    return false;
+                }
+            }
+
+            msg = std::move(*next_msg);
+
+            next_msg = read_batch();
+
+            if (next_msg == std::nullopt || next_msg->epoch != msg.epoch) {
+                msg.end_of_epoch = true;
+            }
+
+            if (autotuner_ != nullptr) {
+                autotuner_->add_batch_read_time(
+                    pipeline_statistics::clock::now() - start);
+
+                std::unique_lock<std::mutex> prefetch_lock{prefetch_mutex_};
+
+                num_batches_in_flight_++;
+            }
 
             return true;
         },
@@ -218,14 +527,110 @@ parallel_data_reader::init_graph()
     auto decode_node = std::make_unique<
         flw::multifunction_node<batch_msg, std::tuple<example_msg>>>(
         g, flw::unlimited, [this](auto const &msg, auto &ports) {
+            if (autotuner_ != nullptr) {
+                autotuner_->begin_decode();
+            }
+
+            auto start = pipeline_statistics::clock::now();
+
+            intrusive_ptr<example> exm{};
+            try {
+                exm = this->decode(*msg.batch);
+            }
+            catch (...) {
+                cancel_graph();
+
+                throw;
+            }
+
+            if (exm != nullptr) {
+                exm->epoch = msg.epoch;
+
+                exm->end_of_epoch = msg.end_of_epoch;
+            }
+
+            auto decode_time = pipeline_statistics::clock::now() - start;
+
+            stats_->add_decode_time(decode_time, exm == nullptr);
+
+            if (autotuner_ != nullptr) {
+                autotuner_->end_decode(decode_time);
+
+                end_batch_flight();
+            }
+
+            std::size_t num_bytes = 0;
+            if (params().max_prefetch_bytes) {
+                if (exm != nullptr) {
+                    num_bytes = detail::get_num_bytes(*exm);
+                }
+
+                add_prefetch_bytes(num_bytes);
+
+                remove_prefetch_bytes(msg.num_bytes);
+            }
+
             // We send a message to the next node even if the decode()
             // function fails. This is needed to have correct sequential
             // ordering of other batches.
-            example_msg out{msg.batch->index(), this->decode(*msg.batch)};
+            example_msg out{msg.idx, std::move(exm), msg.state, num_bytes};
 
             std::get<0>(ports).try_put(std::move(out));
         });
 
+    // Transform
+    std::unique_ptr<flw::function_node<example_msg, example_msg>>
+        transform_node{};
+    if (params().transform) {
+        transform_node =
+            std::make_unique<flw::function_node<example_msg, example_msg>>(
+                g, flw::unlimited, [this](example_msg msg) {
+                    if (msg.exm == nullptr) {
+                        return msg;
+                    }
+
+                    auto start = pipeline_statistics::clock::now();
+
+                    std::size_t epoch = msg.exm->epoch;
+
+                    bool end_of_epoch = msg.exm->end_of_epoch;
+
+                    try {
+                        msg.exm = params().transform(std::move(msg.exm));
+                    }
+                    catch (...) {
+                        cancel_graph();
+
+                        throw;
+                    }
+
+                    if (msg.exm != nullptr) {
+                        msg.exm->epoch = epoch;
+
+                        msg.exm->end_of_epoch = end_of_epoch;
+                    }
+
+                    stats_->add_transform_time(
+                        pipeline_statistics::clock::now() - start);
+
+                    if (params().max_prefetch_bytes) {
+                        std::size_t num_bytes = 0;
+                        if (msg.exm != nullptr) {
+                            num_bytes = detail::get_num_bytes(*msg.exm);
+                        }
+
+                        add_prefetch_bytes(num_bytes);
+
+                        remove_prefetch_bytes(
+                            std::exchange(msg.num_bytes, num_bytes));
+                    }
+
+                    // Like a failed decode, a skipped example is still
+                    // forwarded to preserve the sequential ordering.
+                    return msg;
+                });
+    }
+
     // Order
     auto order_node = std::make_unique<flw::sequencer_node<example_msg>>(
         g, [](auto const &msg) {
@@ -235,34 +640,57 @@ parallel_data_reader::init_graph()
     // Queue
     auto queue_node =
         std::make_unique<flw::function_node<example_msg, flw::continue_msg>>(
-            g, flw::serial, [this, num_prefetched_batches](auto const &msg) {
+            g, flw::serial, [this](auto const &msg) {
                 // If the decode() function has failed simply discard the
                 // message.
                 if (msg.exm == nullptr) {
                     return;
                 }
 
+                queued_example qe{msg.exm, msg.state, msg.num_bytes};
+
+                read_callback callback{};
+
                 {
                     std::unique_lock<std::mutex> queue_lock{queue_mutex_};
 
-                    fill_cond_.wait(
-                        queue_lock, [this, num_prefetched_batches] {
-                            return fill_queue_.size() < num_prefetched_batches;
-                        });
+                    fill_cond_.wait(queue_lock, [this] {
+                        return fill_queue_.size() < max_queue_size();
+                    });
 
                     if (graph_->ctx.is_group_execution_cancelled()) {
                         return;
                     }
 
-                    fill_queue_.push_back(msg.exm);
+                    // If an asynchronous read is pending, hand the
+                    // example directly to its callback.
+                    if (pending_callback_) {
+                        callback = std::exchange(pending_callback_, nullptr);
+                    }
+                    else {
+                        fill_queue_.push_back(std::move(qe));
+
+                        stats_->add_queued_examples(1);
+                    }
                 }
 
-                read_cond_.notify_one();
+                if (callback) {
+                    complete_async_read(std::move(qe), callback);
+                }
+                else {
+                    read_cond_.notify_one();
+                }
             });
 
     flw::make_edge(*src_node, *limit_node);
     flw::make_edge(*limit_node, *decode_node);
-    flw::make_edge(flw::output_port<0>(*decode_node), *order_node);
+    if (transform_node != nullptr) {
+        flw::make_edge(flw::output_port<0>(*decode_node), *transform_node);
+        flw::make_edge(*transform_node, *order_node);
+    }
+    else {
+        flw::make_edge(flw::output_port<0>(*decode_node), *order_node);
+    }
     flw::make_edge(*order_node, *queue_node);
     flw::make_edge(*queue_node, limit_node->decrement);
 
@@ -271,10 +699,54 @@ parallel_data_reader::init_graph()
     graph_->nodes.emplace_back(std::move(src_node));
     graph_->nodes.emplace_back(std::move(limit_node));
     graph_->nodes.emplace_back(std::move(decode_node));
+    if (transform_node != nullptr) {
+        graph_->nodes.emplace_back(std::move(transform_node));
+    }
     graph_->nodes.emplace_back(std::move(order_node));
     graph_->nodes.emplace_back(std::move(queue_node));
 }
 
+std::optional<parallel_data_reader::batch_msg>
+parallel_data_reader::read_batch()
+{
+    std::size_t num_epochs = params().num_epochs;
+
+    std::optional<instance_batch> btch =
+        batch_reader_->read_instance_batch();
+
+    // If the epoch is over, roll into the next one without stopping the
+    // pipeline. An empty epoch means that the dataset is empty.
+    if (btch == std::nullopt) {
+        if (num_epochs != 0 && epoch_ + 1 >= num_epochs) {
+            return {};
+        }
+
+        epoch_++;
+
+        batch_reader_->reset();
+
+        btch = batch_reader_->read_instance_batch();
+        if (btch == std::nullopt) {
+            return {};
+        }
+    }
+
+    // Until the batch is decoded, its payload size is our best estimate
+    // of its memory footprint.
+    std::size_t num_bytes = 0;
+    if (params().max_prefetch_bytes) {
+        num_bytes = detail::get_num_bytes(*btch);
+
+        add_prefetch_bytes(num_bytes);
+    }
+
+    return batch_msg{graph_->next_idx++,
+                     std::make_shared<instance_batch>(std::move(*btch)),
+                     capture_state(),
+                     num_bytes,
+                     epoch_};
+}
+
 void
 parallel_data_reader::ensure_schema_inferred()
 {
@@ -301,11 +773,312 @@ parallel_data_reader::reset() noexcept
 
     batch_reader_->reset();
 
+    epoch_ = 0;
+
+    graph_->next_msg = std::nullopt;
+
+    graph_->next_idx = 0;
+
     graph_->ctx.reset();
 
-    graph_->obj.reset();
+    // Resetting the graph re-attaches it to the current arena.
+    executor_->execute([this] {
+        graph_->obj.reset();
+    });
 
     exception_ptr_ = nullptr;
+
+    last_state_ = nullptr;
+    prev_state_ = nullptr;
+
+    // The examples that were in flight when the graph was cancelled
+    // are discarded without being accounted.
+    num_prefetch_bytes_ = 0;
+
+    num_batches_in_flight_ = 0;
+
+    if (autotuner_ != nullptr) {
+        autotuner_->reset();
+    }
+}
+
+std::shared_ptr<detail::state_writer const>
+parallel_data_reader::capture_state() const
+{
+    if (!params().enable_checkpointing) {
+        return {};
+    }
+
+    auto wr = std::make_shared<detail::state_writer>();
+
+    wr->write(epoch_);
+
+    batch_reader_->save_state(*wr);
+
+    return wr;
+}
+
+bool
+parallel_data_reader::try_acquire_prefetch_budget()
+{
+    if (params().max_prefetch_bytes == std::nullopt && autotuner_ == nullptr) {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> prefetch_lock{prefetch_mutex_};
+
+    // The reader cancels the graph before it takes the lock to release
+    // a throttled source, so checking it here leaves no gap.
+    if (graph_->ctx.is_group_execution_cancelled()) {
+        return false;
+    }
+
+    if (has_prefetch_budget()) {
+        return true;
+    }
+
+    // The source runs as a task of the graph, so waiting here could
+    // occupy the very thread that has to free up the budget. Instead
+    // the source stops and is activated again once the budget allows;
+    // in the meantime a reservation keeps the graph from going idle.
+    source_throttled_ = true;
+
+    graph_->obj.reserve_wait();
+
+    return false;
+}
+
+bool
+parallel_data_reader::has_prefetch_budget() const noexcept
+{
+    std::optional<std::size_t> const &budget = params().max_prefetch_bytes;
+
+    // We always allow at least one batch in flight; otherwise a batch
+    // larger than the budget would stall the reader forever.
+    if (budget && num_prefetch_bytes_ != 0 &&
+        num_prefetch_bytes_ >= *budget) {
+        return false;
+    }
+
+    return autotuner_ == nullptr ||
+           num_batches_in_flight_ < autotuner_->num_parallel_reads();
+}
+
+void
+parallel_data_reader::resume_source()
+{
+    {
+        std::unique_lock<std::mutex> prefetch_lock{prefetch_mutex_};
+
+        if (!source_throttled_ || !has_prefetch_budget()) {
+            return;
+        }
+
+        source_throttled_ = false;
+    }
+
+    // The source is activated before the reservation is released so
+    // that the graph does not go idle in between.
+    graph_->src_node->activate();
+
+    graph_->obj.release_wait();
+}
+
+void
+parallel_data_reader::release_throttled_source() noexcept
+{
+    bool source_throttled{};
+    {
+        std::unique_lock<std::mutex> prefetch_lock{prefetch_mutex_};
+
+        source_throttled = std::exchange(source_throttled_, false);
+    }
+
+    if (source_throttled) {
+        graph_->obj.release_wait();
+    }
+}
+
+void
+parallel_data_reader::cancel_graph() noexcept
+{
+    // The examples decoded after a failed one wait in the sequencer for
+    // its index and are never accounted out of the prefetch budget, so
+    // a throttled source would hold its reservation on the graph and
+    // keep wait_for_all() from returning the error.
+    graph_->ctx.cancel_group_execution();
+
+    release_throttled_source();
+}
+
+void
+parallel_data_reader::add_prefetch_bytes(std::size_t num_bytes)
+{
+    if (num_bytes == 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> prefetch_lock{prefetch_mutex_};
+
+    num_prefetch_bytes_ += num_bytes;
+}
+
+void
+parallel_data_reader::remove_prefetch_bytes(std::size_t num_bytes)
+{
+    if (num_bytes == 0) {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> prefetch_lock{prefetch_mutex_};
+
+        num_prefetch_bytes_ -= num_bytes;
+    }
+
+    resume_source();
+}
+
+void
+parallel_data_reader::end_batch_flight()
+{
+    {
+        std::unique_lock<std::mutex> prefetch_lock{prefetch_mutex_};
+
+        num_batches_in_flight_--;
+    }
+
+    resume_source();
+}
+
+void
+parallel_data_reader::tune(std::chrono::nanoseconds wait_time)
+{
+    if (autotuner_ == nullptr || !autotuner_->update(wait_time)) {
+        return;
+    }
+
+    // Wake up the stages that might be waiting for the raised limits.
+    // The caller holds the queue mutex, so the queue stage observes
+    // the new prefetch depth once it is notified.
+    fill_cond_.notify_one();
+
+    resume_source();
+}
+
+std::size_t
+parallel_data_reader::max_queue_size() const noexcept
+{
+    if (autotuner_ != nullptr) {
+        return autotuner_->num_prefetched_batches();
+    }
+    return num_prefetched_batches_;
+}
+
+bool
+parallel_data_reader::should_decode_in_parallel(
+    std::size_t num_values) const noexcept
+{
+    if (autotuner_ != nullptr) {
+        return autotuner_->should_decode_in_parallel(num_values);
+    }
+    return num_values >= detail::parallel_decode_cut_off;
+}
+
+bool
+parallel_data_reader::add_bad_instance() const noexcept
+{
+    return bad_record_reporter_->add_bad_record();
+}
+
+void
+parallel_data_reader::report_bad_instance(std::string msg) const
+{
+    bad_record_reporter_->report(std::move(msg));
+}
+
+std::vector<std::byte>
+parallel_data_reader::save_state() const
+{
+    if (!params().enable_checkpointing) {
+        throw not_supported_error{
+            "The state of the data reader is not tracked. Set "
+            "data_reader_params::enable_checkpointing to save it."};
+    }
+
+    // If an example has been peeked, the caller has not consumed it
+    // yet; its batch has to be read again after a restore.
+    std::shared_ptr<detail::state_writer const> snapshot{};
+    {
+        std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+        snapshot = has_peeked_example() ? prev_state_ : last_state_;
+    }
+
+    detail::state_writer wr{};
+
+    wr.write(detail::reader_state_magic);
+    wr.write(detail::reader_state_version);
+
+    wr.write(params().dataset.size());
+    wr.write(params().batch_size);
+
+    wr.write(snapshot != nullptr);
+
+    // The snapshot was captured along with its batch; the parts of it
+    // that are expensive to serialize are written only now.
+    if (snapshot != nullptr) {
+        wr.write(*snapshot);
+    }
+
+    if (wr.error()) {
+        throw not_supported_error{*wr.error()};
+    }
+
+    return wr.bits();
+}
+
+void
+parallel_data_reader::restore_state_core(memory_span bits)
+{
+    detail::state_reader rd{bits};
+
+    if (rd.read_uint64() != detail::reader_state_magic ||
+        rd.read_uint64() != detail::reader_state_version) {
+        throw std::invalid_argument{
+            "The state has not been saved by a compatible data reader."};
+    }
+
+    if (rd.read_size() != params().dataset.size() ||
+        rd.read_size() != params().batch_size) {
+        throw std::invalid_argument{
+            "The state does not match the dataset of the reader."};
+    }
+
+    bool has_position = rd.read_bool();
+
+    reset();
+
+    if (!has_position) {
+        return;
+    }
+
+    std::size_t epoch = rd.read_size();
+
+    batch_reader_->restore_state(rd);
+
+    epoch_ = epoch;
+
+    last_state_ = capture_state();
+}
+
+record_index
+parallel_data_reader::make_record_index(data_store const &ds,
+                                        std::size_t stride)
+{
+    intrusive_ptr<record_reader> rdr = make_record_reader(ds);
+
+    return mlio::make_record_index(*rdr, stride, ds.size_hint());
 }
 
 void
@@ -315,6 +1088,9 @@ parallel_data_reader::stop()
         return;
     }
 
+    stats_->add_queued_examples(
+        -static_cast<std::ptrdiff_t>(read_queue_.size()));
+
     read_queue_.clear();
 
     {
@@ -322,11 +1098,18 @@ parallel_data_reader::stop()
 
         graph_->ctx.cancel_group_execution();
 
+        stats_->add_queued_examples(
+            -static_cast<std::ptrdiff_t>(fill_queue_.size()));
+
         fill_queue_.clear();
     }
 
     fill_cond_.notify_one();
 
+    // A throttled source holds a reservation on the graph that has to
+    // be released for the pipeline thread to return.
+    release_throttled_source();
+
     thrd_.join();
 }
 
@@ -336,5 +1119,11 @@ parallel_data_reader::num_bytes_read() const noexcept
     return reader_->num_bytes_read();
 }
 
+data_reader_statistics
+parallel_data_reader::statistics() const
+{
+    return stats_->snapshot();
+}
+
 }  // namespace v1
 }  // namespace mlio
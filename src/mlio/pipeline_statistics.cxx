@@ -0,0 +1,82 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/pipeline_statistics.h"
+
+#include <algorithm>
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+pipeline_statistics::pipeline_statistics(std::size_t num_stores)
+    : num_stores_{num_stores}
+    , stores_{std::make_unique<store_counters[]>(num_stores)}
+{}
+
+data_reader_statistics
+pipeline_statistics::snapshot() const
+{
+    using std::chrono::nanoseconds;
+
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    data_reader_statistics stats{};
+
+    stats.data_stores.reserve(num_stores_);
+
+    for (std::size_t i = 0; i < num_stores_; i++) {
+        store_counters const &cnt = stores_[i];
+
+        stats.data_stores.push_back(
+            data_store_statistics{cnt.num_records_read.load(relaxed),
+                                  cnt.num_bytes_read.load(relaxed)});
+    }
+
+    std::int64_t stream_read_time = stream_read_time_.load(relaxed);
+    std::int64_t instance_read_time = instance_read_time_.load(relaxed);
+    std::int64_t batch_read_time = batch_read_time_.load(relaxed);
+
+    // The stages are nested; the time of an inner stage is subtracted
+    // from its outer stage. As the counters are read independently, the
+    // difference might be slightly off; clamp it to zero.
+    stats.stream_read_time = nanoseconds{stream_read_time};
+
+    stats.record_split_time =
+        nanoseconds{std::max(instance_read_time - stream_read_time, {})};
+
+    stats.batch_assembly_time =
+        nanoseconds{std::max(batch_read_time - instance_read_time, {})};
+
+    stats.decode_time = nanoseconds{decode_time_.load(relaxed)};
+
+    stats.transform_time = nanoseconds{transform_time_.load(relaxed)};
+
+    stats.wait_time = nanoseconds{wait_time_.load(relaxed)};
+
+    stats.num_queued_examples = static_cast<std::size_t>(
+        std::max(num_queued_examples_.load(relaxed), std::ptrdiff_t{}));
+
+    stats.num_batches_read = num_batches_read_.load(relaxed);
+    stats.num_bad_batches = num_bad_batches_.load(relaxed);
+    stats.num_bad_records = num_bad_records_.load(relaxed);
+    stats.num_dropped_batches = num_dropped_batches_.load(relaxed);
+
+    return stats;
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "mlio/data_reader.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+// Holds the counters of a data reader pipeline. Each counter is updated
+// with relaxed atomic operations so that reading the statistics never
+// blocks the pipeline. The counters that have a single writer (e.g. the
+// serial source stage) use a load and a store instead of a locked
+// read-modify-write operation.
+class pipeline_statistics {
+    struct store_counters {
+        std::atomic<std::size_t> num_records_read{};
+        std::atomic<std::size_t> num_bytes_read{};
+    };
+
+public:
+    using clock = std::chrono::steady_clock;
+
+public:
+    explicit pipeline_statistics(std::size_t num_stores);
+
+public:
+    // Called by the single thread that reads the dataset.
+    void
+    add_record(std::size_t store_idx, std::size_t size) noexcept
+    {
+        store_counters &cnt = stores_[store_idx];
+
+        increment(cnt.num_records_read, 1);
+        increment(cnt.num_bytes_read, size);
+    }
+
+    void
+    add_stream_read_time(std::chrono::nanoseconds value) noexcept
+    {
+        increment(stream_read_time_, value.count());
+    }
+
+    void
+    add_instance_read_time(std::chrono::nanoseconds value) noexcept
+    {
+        increment(instance_read_time_, value.count());
+    }
+
+    void
+    add_batch_read_time(std::chrono::nanoseconds value) noexcept
+    {
+        increment(batch_read_time_, value.count());
+
+        increment(num_batches_read_, 1);
+    }
+
+    void
+    add_dropped_batch() noexcept
+    {
+        increment(num_dropped_batches_, 1);
+    }
+
+    // Called concurrently by the decode stage.
+    void
+    add_decode_time(std::chrono::nanoseconds value, bool failed) noexcept
+    {
+        decode_time_.fetch_add(value.count(), std::memory_order_relaxed);
+
+        if (failed) {
+            num_bad_batches_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Called concurrently by the decode stage and by the thread that
+    // reads the dataset.
+    void
+    add_bad_record() noexcept
+    {
+        num_bad_records_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Called concurrently by the transform stage.
+    void
+    add_transform_time(std::chrono::nanoseconds value) noexcept
+    {
+        transform_time_.fetch_add(value.count(), std::memory_order_relaxed);
+    }
+
+    // Called by the consumer thread.
+    void
+    add_wait_time(std::chrono::nanoseconds value) noexcept
+    {
+        increment(wait_time_, value.count());
+    }
+
+    // Called by both the queue stage and the consumer thread.
+    void
+    add_queued_examples(std::ptrdiff_t value) noexcept
+    {
+        num_queued_examples_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    data_reader_statistics
+    snapshot() const;
+
+private:
+    template<typename T>
+    static void
+    increment(std::atomic<T> &counter,
+              typename std::atomic<T>::value_type value) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value,
+                      std::memory_order_relaxed);
+    }
+
+private:
+    std::size_t num_stores_;
+    std::unique_ptr<store_counters[]> stores_;
+    std::atomic<std::int64_t> stream_read_time_{};
+    std::atomic<std::int64_t> instance_read_time_{};
+    std::atomic<std::int64_t> batch_read_time_{};
+    std::atomic<std::int64_t> decode_time_{};
+    std::atomic<std::int64_t> transform_time_{};
+    std::atomic<std::int64_t> wait_time_{};
+    std::atomic<std::ptrdiff_t> num_queued_examples_{};
+    std::atomic<std::size_t> num_batches_read_{};
+    std::atomic<std::size_t> num_bad_batches_{};
+    std::atomic<std::size_t> num_bad_records_{};
+    std::atomic<std::size_t> num_dropped_batches_{};
+};
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,424 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/data_service.h"
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/detail/thread.h"
+#include "mlio/example.h"
+#include "mlio/platform/posix/detail/unix_socket.h"
+#include "mlio/shared_memory_channel.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+// Reads the examples of a consumer handle on a background thread and
+// sends them through a new shared memory channel. The channel applies
+// backpressure once the client falls behind.
+class example_pump {
+public:
+    explicit example_pump(data_reader &rdr, std::size_t channel_capacity)
+        : reader_{&rdr}
+        , channel_{make_intrusive<shared_memory_channel>(channel_capacity)}
+    {
+        thread_ = start_thread(&example_pump::run, this);
+    }
+
+    example_pump(example_pump const &) = delete;
+
+    example_pump(example_pump &&) = delete;
+
+    ~example_pump()
+    {
+        is_stopping_ = true;
+
+        // Wakes up the thread if it is blocked in send().
+        channel_->close();
+
+        join();
+    }
+
+public:
+    example_pump &
+    operator=(example_pump const &) = delete;
+
+    example_pump &
+    operator=(example_pump &&) = delete;
+
+public:
+    // Waits for the pump to reach the end of the epoch and returns the
+    // error that has stopped it early, if any.
+    std::string const &
+    join()
+    {
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        return error_;
+    }
+
+    int
+    fd() const noexcept
+    {
+        return channel_->fd();
+    }
+
+private:
+    void
+    run()
+    {
+        try {
+            intrusive_ptr<example> exm{};
+            while ((exm = reader_->read_example()) != nullptr) {
+                channel_->send(*exm);
+            }
+        }
+        catch (std::exception const &e) {
+            if (!is_stopping_) {
+                error_ = e.what();
+            }
+        }
+
+        channel_->close();
+    }
+
+private:
+    data_reader *reader_;
+    intrusive_ptr<shared_memory_channel> channel_;
+    std::atomic_bool is_stopping_{};
+    std::string error_{};
+    std::thread thread_{};
+};
+
+}  // namespace
+}  // namespace detail
+
+struct data_service_server::client_list {
+    std::mutex mutex{};
+    std::vector<intrusive_ptr<data_reader>> consumers{};
+    std::vector<bool> is_taken{};
+};
+
+data_service_server::data_service_server(std::string pathname,
+                                         intrusive_ptr<data_reader> rdr,
+                                         std::size_t num_clients,
+                                         fanout_policy policy,
+                                         std::size_t channel_capacity)
+    : channel_capacity_{channel_capacity}
+    , clients_{std::make_unique<client_list>()}
+{
+    if (channel_capacity_ == 0) {
+        throw std::invalid_argument{
+            "The channel capacity must be greater than zero."};
+    }
+
+    clients_->consumers =
+        make_fanout_readers(std::move(rdr), num_clients, policy);
+
+    clients_->is_taken.resize(num_clients);
+
+    server_ = std::make_unique<detail::socket_server>(std::move(pathname));
+}
+
+data_service_server::~data_service_server()
+{
+    // The client threads use the client list; join them first.
+    server_.reset();
+}
+
+void
+data_service_server::serve()
+{
+    server_->serve([this](int fd) {
+        serve_client(fd);
+    });
+}
+
+void
+data_service_server::stop()
+{
+    server_->stop();
+}
+
+void
+data_service_server::serve_client(int fd)
+{
+    std::size_t idx = 0;
+
+    {
+        std::unique_lock<std::mutex> lock{clients_->mutex};
+
+        while (idx < clients_->is_taken.size() && clients_->is_taken[idx]) {
+            idx++;
+        }
+
+        if (idx == clients_->is_taken.size()) {
+            try {
+                detail::write_line(fd,
+                                   "error All clients of the data service "
+                                   "are connected.");
+            }
+            catch (std::exception const &) {
+            }
+            return;
+        }
+
+        clients_->is_taken[idx] = true;
+    }
+
+    data_reader &consumer = *clients_->consumers[idx];
+
+    std::unique_ptr<detail::example_pump> pump{};
+
+    std::string buffer{};
+    std::string req{};
+
+    try {
+        while (detail::read_line(fd, buffer, req)) {
+            if (req == "hello") {
+                detail::write_line(fd, fmt::format("ok {0}", idx));
+            }
+            else if (req == "start") {
+                pump = nullptr;
+
+                pump = std::make_unique<detail::example_pump>(
+                    consumer, channel_capacity_);
+
+                detail::write_line(fd, "ok", pump->fd());
+            }
+            else if (req == "end") {
+                std::string error{};
+                if (pump != nullptr) {
+                    error = pump->join();
+                }
+
+                pump = nullptr;
+
+                if (error.empty()) {
+                    detail::write_line(fd, "ok");
+                }
+                else {
+                    detail::write_line(fd, "error " + error);
+                }
+            }
+            else if (req == "reset") {
+                pump = nullptr;
+
+                consumer.reset();
+
+                detail::write_line(fd, "ok");
+            }
+            else {
+                detail::write_line(
+                    fd,
+                    fmt::format("error The command '{0}' is not supported.",
+                                req));
+            }
+        }
+    }
+    catch (std::exception const &) {
+        // The client has gone away.
+    }
+
+    pump = nullptr;
+
+    // Move the handle to the next epoch so that the other handles do not
+    // wait for it to catch up.
+    consumer.reset();
+
+    std::unique_lock<std::mutex> lock{clients_->mutex};
+
+    clients_->is_taken[idx] = false;
+}
+
+data_service_reader::data_service_reader(std::string pathname)
+    : pathname_{std::move(pathname)}
+{
+    fd_ = detail::connect_socket(pathname_, "data service");
+
+    try {
+        send_request("hello");
+    }
+    catch (...) {
+        ::close(fd_);
+
+        throw;
+    }
+}
+
+data_service_reader::~data_service_reader()
+{
+    if (channel_ != nullptr) {
+        channel_->close();
+    }
+
+    ::close(fd_);
+}
+
+intrusive_ptr<example>
+data_service_reader::read_example()
+{
+    if (peeked_example_) {
+        return std::exchange(peeked_example_, nullptr);
+    }
+    return read_example_core();
+}
+
+intrusive_ptr<example> const &
+data_service_reader::peek_example()
+{
+    if (peeked_example_ == nullptr) {
+        peeked_example_ = read_example_core();
+    }
+    return peeked_example_;
+}
+
+intrusive_ptr<example>
+data_service_reader::read_example_core()
+{
+    if (is_exhausted_) {
+        return {};
+    }
+
+    if (is_reset_pending_) {
+        send_request("reset");
+
+        is_reset_pending_ = false;
+    }
+
+    if (channel_ == nullptr) {
+        int passed_fd = -1;
+
+        send_request("start", &passed_fd);
+
+        if (passed_fd == -1) {
+            throw data_reader_error{
+                "The data service has not passed the shared memory channel."};
+        }
+
+        try {
+            channel_ = shared_memory_channel::open(passed_fd);
+        }
+        catch (...) {
+            ::close(passed_fd);
+
+            throw;
+        }
+
+        ::close(passed_fd);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    intrusive_ptr<example> exm = channel_->receive();
+
+    wait_time_ += std::chrono::steady_clock::now() - start;
+
+    if (exm == nullptr) {
+        channel_ = nullptr;
+
+        is_exhausted_ = true;
+
+        // Checks whether the server has reached the end of the epoch or
+        // has failed to read the dataset.
+        send_request("end");
+    }
+
+    return exm;
+}
+
+void
+data_service_reader::reset() noexcept
+{
+    peeked_example_ = nullptr;
+
+    is_exhausted_ = false;
+
+    if (channel_ != nullptr) {
+        channel_->close();
+
+        channel_ = nullptr;
+    }
+
+    try {
+        send_request("reset");
+    }
+    catch (std::exception const &) {
+        // Retry on the next read, which also reports the error.
+        is_reset_pending_ = true;
+    }
+}
+
+data_reader_statistics
+data_service_reader::statistics() const
+{
+    data_reader_statistics stats{};
+
+    stats.wait_time = wait_time_;
+
+    return stats;
+}
+
+std::string
+data_service_reader::send_request(std::string const &req, int *passed_fd)
+{
+    detail::write_line(fd_, req);
+
+    std::string res{};
+
+    bool has_res{};
+    if (passed_fd == nullptr) {
+        has_res = detail::read_line(fd_, buffer_, res);
+    }
+    else {
+        has_res = detail::read_line(fd_, buffer_, res, *passed_fd);
+    }
+
+    if (res.rfind("error ", 0) == 0 || !has_res) {
+        if (passed_fd != nullptr && *passed_fd != -1) {
+            ::close(std::exchange(*passed_fd, -1));
+        }
+
+        if (!has_res) {
+            throw data_reader_error{
+                "The data service has closed the connection."};
+        }
+
+        throw data_reader_error{fmt::format(
+            "The data service has returned an error: {0}", res.substr(6))};
+    }
+
+    return res;
+}
+
+}  // namespace v1
+}  // namespace mlio
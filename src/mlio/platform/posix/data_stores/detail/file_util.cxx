@@ -0,0 +1,36 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/data_stores/detail/file_util.h"  // IWYU pragma: associated
+
+#include <sys/stat.h>
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+std::optional<std::size_t>
+get_file_size(std::string const &pathname) noexcept
+{
+    struct ::stat buf {};
+    if (::stat(pathname.c_str(), &buf) == -1) {
+        return {};
+    }
+    return static_cast<std::size_t>(buf.st_size);
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
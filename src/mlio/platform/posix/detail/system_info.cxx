@@ -15,26 +15,371 @@
 
 #include "mlio/detail/system_info.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "mlio/config.h"
 
 #if defined(MLIO_PLATFORM_LINUX)
 
 // IWYU pragma: no_include <linux/sysinfo.h>
 
+#    include <charconv>
+#    include <cstdint>
+#    include <fstream>
+#    include <limits>
+#    include <optional>
+#    include <sstream>
+#    include <string>
+#    include <string_view>
+#    include <system_error>
+
+#    include <sched.h>
 #    include <sys/sysinfo.h>
 
 namespace mlio {
 inline namespace v1 {
 namespace detail {
+namespace {
+
+// Represents the directory of the cgroup of the process in a mounted
+// cgroup hierarchy.
+struct cgroup_dir {
+    std::string mount_point;
+    std::string path;
+};
+
+bool
+has_controller(std::string_view list, std::string_view controller)
+{
+    while (!list.empty()) {
+        std::size_t pos = list.find(',');
+        if (list.substr(0, pos) == controller) {
+            return true;
+        }
+        if (pos == std::string_view::npos) {
+            break;
+        }
+        list.remove_prefix(pos + 1);
+    }
+    return false;
+}
+
+// Returns the path of the cgroup of the process in the v1 hierarchy
+// with the specified controller, or in the unified v2 hierarchy if no
+// controller is specified.
+std::optional<std::string>
+find_cgroup_path(std::string_view controller)
+{
+    // Each line has the format "hierarchy-ID:controller-list:path".
+    std::ifstream strm{"/proc/self/cgroup"};
+
+    for (std::string line; std::getline(strm, line);) {
+        std::size_t pos1 = line.find(':');
+        if (pos1 == std::string::npos) {
+            continue;
+        }
+        std::size_t pos2 = line.find(':', pos1 + 1);
+        if (pos2 == std::string::npos) {
+            continue;
+        }
+
+        std::string_view id = std::string_view{line}.substr(0, pos1);
+
+        std::string_view controllers =
+            std::string_view{line}.substr(pos1 + 1, pos2 - pos1 - 1);
+
+        bool match;
+        if (controller.empty()) {
+            match = id == "0" && controllers.empty();
+        }
+        else {
+            match = has_controller(controllers, controller);
+        }
+
+        if (match) {
+            return line.substr(pos2 + 1);
+        }
+    }
+    return {};
+}
+
+std::optional<cgroup_dir>
+find_cgroup_dir(std::string_view controller)
+{
+    std::optional<std::string> cgroup_path = find_cgroup_path(controller);
+    if (cgroup_path == std::nullopt) {
+        return {};
+    }
+
+    // Each line has the format "ID parent-ID major:minor root
+    // mount-point options [optional-fields] - type source
+    // super-options".
+    std::ifstream strm{"/proc/self/mountinfo"};
+
+    for (std::string line; std::getline(strm, line);) {
+        std::size_t sep = line.find(" - ");
+        if (sep == std::string::npos) {
+            continue;
+        }
+
+        std::istringstream mount_strm{line.substr(0, sep)};
+        std::string id, parent_id, device, root, mount_point;
+        mount_strm >> id >> parent_id >> device >> root >> mount_point;
+
+        std::istringstream fs_strm{line.substr(sep + 3)};
+        std::string type, source, options;
+        fs_strm >> type >> source >> options;
+
+        if (controller.empty()) {
+            if (type != "cgroup2") {
+                continue;
+            }
+        }
+        else if (type != "cgroup" || !has_controller(options, controller)) {
+            continue;
+        }
+
+        // Within a container the mount usually exposes only the subtree
+        // of the hierarchy that belongs to the container.
+        if (root == "/") {
+            root.clear();
+        }
+        if (cgroup_path->compare(0, root.size(), root) != 0) {
+            continue;
+        }
+
+        std::string path = mount_point + cgroup_path->substr(root.size());
+
+        while (path.size() > mount_point.size() && path.back() == '/') {
+            path.pop_back();
+        }
+
+        return cgroup_dir{std::move(mount_point), std::move(path)};
+    }
+    return {};
+}
+
+std::optional<std::string>
+read_cgroup_file(std::string const &dir, char const *name)
+{
+    std::ifstream strm{dir + "/" + name};
+
+    std::string value;
+    if (!std::getline(strm, value)) {
+        return {};
+    }
+    return value;
+}
+
+std::optional<std::int64_t>
+parse_int64(std::string_view s)
+{
+    std::int64_t value{};
+
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (ec != std::errc{}) {
+        return {};
+    }
+    return value;
+}
+
+// Calls the specified function with the directory of the cgroup and
+// with the directories of its ancestors up to the mount point, as the
+// limits of an ancestor apply to all of its descendants.
+template<typename Function>
+void
+for_each_cgroup_level(cgroup_dir const &dir, Function &&fn)
+{
+    std::string path = dir.path;
+
+    while (true) {
+        fn(path);
+
+        if (path.size() <= dir.mount_point.size()) {
+            break;
+        }
+
+        std::size_t pos = path.rfind('/');
+        if (pos == std::string::npos || pos < dir.mount_point.size()) {
+            break;
+        }
+        path.resize(std::max(pos, dir.mount_point.size()));
+    }
+}
+
+std::optional<std::size_t>
+get_cgroup_memory_limit()
+{
+    std::optional<std::size_t> limit{};
+
+    auto update_limit = [&limit](std::optional<std::string> const &value) {
+        // A cgroup v2 without a limit reports "max"; a cgroup v1 reports
+        // a huge value that is larger than the physical memory.
+        if (value == std::nullopt || *value == "max") {
+            return;
+        }
+
+        std::optional<std::int64_t> l = parse_int64(*value);
+        if (l == std::nullopt || *l <= 0) {
+            return;
+        }
+
+        auto size = static_cast<std::size_t>(*l);
+        if (limit == std::nullopt || size < *limit) {
+            limit = size;
+        }
+    };
+
+    // On hybrid systems the limits might be set in either hierarchy.
+    if (std::optional<cgroup_dir> dir = find_cgroup_dir({})) {
+        for_each_cgroup_level(*dir, [&update_limit](std::string const &p) {
+            update_limit(read_cgroup_file(p, "memory.max"));
+        });
+    }
+    if (std::optional<cgroup_dir> dir = find_cgroup_dir("memory")) {
+        for_each_cgroup_level(*dir, [&update_limit](std::string const &p) {
+            update_limit(read_cgroup_file(p, "memory.limit_in_bytes"));
+        });
+    }
+
+    return limit;
+}
+
+// Returns the CPU quota of the cgroup as a number of processor cores,
+// rounded up.
+std::optional<std::size_t>
+get_cgroup_cpu_limit()
+{
+    std::optional<std::size_t> limit{};
+
+    auto update_limit = [&limit](std::optional<std::int64_t> quota,
+                                 std::optional<std::int64_t> period) {
+        if (quota == std::nullopt || period == std::nullopt || *quota <= 0 ||
+            *period <= 0) {
+            return;
+        }
+
+        auto num_cpus = static_cast<std::size_t>((*quota + *period - 1) /
+                                                 *period);
+        if (limit == std::nullopt || num_cpus < *limit) {
+            limit = num_cpus;
+        }
+    };
+
+    if (std::optional<cgroup_dir> dir = find_cgroup_dir({})) {
+        for_each_cgroup_level(*dir, [&update_limit](std::string const &p) {
+            // The file has the format "quota period" where the quota is
+            // "max" if the cgroup is not limited.
+            std::optional<std::string> value = read_cgroup_file(p, "cpu.max");
+            if (value == std::nullopt) {
+                return;
+            }
+
+            std::string_view s = *value;
+
+            std::size_t pos = s.find(' ');
+            if (pos == std::string_view::npos) {
+                return;
+            }
+
+            update_limit(parse_int64(s.substr(0, pos)),
+                         parse_int64(s.substr(pos + 1)));
+        });
+    }
+    if (std::optional<cgroup_dir> dir = find_cgroup_dir("cpu")) {
+        for_each_cgroup_level(*dir, [&update_limit](std::string const &p) {
+            std::optional<std::string> quota =
+                read_cgroup_file(p, "cpu.cfs_quota_us");
+            std::optional<std::string> period =
+                read_cgroup_file(p, "cpu.cfs_period_us");
+            if (quota == std::nullopt || period == std::nullopt) {
+                return;
+            }
+
+            update_limit(parse_int64(*quota), parse_int64(*period));
+        });
+    }
+
+    return limit;
+}
 
 std::size_t
-get_total_ram() noexcept
+get_physical_ram() noexcept
 {
     struct ::sysinfo info {};
     if (::sysinfo(&info) == -1) {
         return 0;
     }
-    return info.totalram;
+    return info.totalram * info.mem_unit;
+}
+
+std::size_t
+get_num_affine_cpus() noexcept
+{
+    // The affinity mask of the process already reflects its cpuset.
+    ::cpu_set_t set{};
+    if (::sched_getaffinity(0, sizeof(set), &set) == 0) {
+        int num_cpus = CPU_COUNT(&set);
+        if (num_cpus > 0) {
+            return static_cast<std::size_t>(num_cpus);
+        }
+    }
+    return std::thread::hardware_concurrency();
+}
+
+std::size_t
+detect_total_ram() noexcept
+{
+    std::size_t total_ram = get_physical_ram();
+
+    std::optional<std::size_t> limit{};
+    try {
+        limit = get_cgroup_memory_limit();
+    }
+    catch (...) {
+    }
+
+    if (limit && (total_ram == 0 || *limit < total_ram)) {
+        return *limit;
+    }
+    return total_ram;
+}
+
+std::size_t
+detect_num_cpus() noexcept
+{
+    std::size_t num_cpus = get_num_affine_cpus();
+
+    std::optional<std::size_t> limit{};
+    try {
+        limit = get_cgroup_cpu_limit();
+    }
+    catch (...) {
+    }
+
+    if (limit && (num_cpus == 0 || *limit < num_cpus)) {
+        num_cpus = *limit;
+    }
+    return std::max(num_cpus, std::size_t{1});
+}
+
+}  // namespace
+
+std::size_t
+get_total_ram() noexcept
+{
+    static std::size_t const total_ram = detect_total_ram();
+
+    return total_ram;
+}
+
+std::size_t
+get_num_cpus() noexcept
+{
+    static std::size_t const num_cpus = detect_num_cpus();
+
+    return num_cpus;
 }
 
 }  // namespace detail
@@ -67,6 +412,12 @@ get_total_ram() noexcept
     return data;
 }
 
+std::size_t
+get_num_cpus() noexcept
+{
+    return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
 }  // namespace detail
 }  // namespace v1
 }  // namespace mlio
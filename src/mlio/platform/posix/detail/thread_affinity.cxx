@@ -0,0 +1,104 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/thread_affinity.h"
+
+#include "mlio/config.h"
+
+#if defined(MLIO_PLATFORM_LINUX)
+
+#    include <stdexcept>
+#    include <system_error>
+
+#    include <fmt/format.h>
+#    include <pthread.h>
+#    include <sched.h>
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+std::vector<std::size_t>
+get_current_thread_affinity()
+{
+    ::cpu_set_t set{};
+
+    int s = ::pthread_getaffinity_np(::pthread_self(), sizeof(set), &set);
+    if (s != 0) {
+        throw std::system_error{s, std::generic_category()};
+    }
+
+    std::vector<std::size_t> cpus{};
+    for (std::size_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus.emplace_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+void
+set_current_thread_affinity(std::vector<std::size_t> const &cpus)
+{
+    ::cpu_set_t set{};
+
+    CPU_ZERO(&set);
+
+    for (std::size_t cpu : cpus) {
+        if (cpu >= CPU_SETSIZE) {
+            throw std::invalid_argument{
+                fmt::format("The processor core {0:n} does not exist.", cpu)};
+        }
+
+        CPU_SET(cpu, &set);
+    }
+
+    int s = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+    if (s != 0) {
+        throw std::system_error{s, std::generic_category()};
+    }
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
+
+#else
+
+#    include "mlio/not_supported_error.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+std::vector<std::size_t>
+get_current_thread_affinity()
+{
+    throw not_supported_error{
+        "Thread affinity is not supported on this platform."};
+}
+
+void
+set_current_thread_affinity(std::vector<std::size_t> const &)
+{
+    throw not_supported_error{
+        "Thread affinity is not supported on this platform."};
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
+
+#endif
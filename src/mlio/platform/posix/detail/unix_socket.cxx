@@ -0,0 +1,377 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/platform/posix/detail/unix_socket.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "mlio/detail/error.h"
+#include "mlio/detail/thread.h"
+#include "mlio/platform/posix/detail/system_call.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int send_flags = MSG_NOSIGNAL;
+#else
+constexpr int send_flags = 0;
+#endif
+
+bool
+read_line_core(int fd, std::string &buffer, std::string &line, int *passed_fd)
+{
+    if (passed_fd != nullptr) {
+        *passed_fd = -1;
+    }
+
+    while (true) {
+        std::size_t pos = buffer.find('\n');
+        if (pos != std::string::npos) {
+            line = buffer.substr(0, pos);
+
+            buffer.erase(0, pos + 1);
+
+            return true;
+        }
+
+        char chunk[256];
+
+        ::iovec iov{chunk, sizeof(chunk)};
+
+        alignas(::cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+
+        ::msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+
+        if (passed_fd != nullptr) {
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+        }
+
+        ::ssize_t r{};
+        do {
+            r = ::recvmsg(fd, &msg, 0);
+        } while (r == -1 && errno == EINTR);
+
+        if (r == -1) {
+            throw std::system_error{
+                current_error_code(),
+                "The message cannot be received over the socket."};
+        }
+
+        if (passed_fd != nullptr) {
+            ::cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+            if (cmsg != nullptr && cmsg->cmsg_level == SOL_SOCKET &&
+                cmsg->cmsg_type == SCM_RIGHTS) {
+
+                std::memcpy(passed_fd, CMSG_DATA(cmsg), sizeof(int));
+
+                ::fcntl(*passed_fd, F_SETFD, FD_CLOEXEC);
+            }
+        }
+
+        if (r == 0) {
+            return false;
+        }
+
+        buffer.append(chunk, static_cast<std::size_t>(r));
+    }
+}
+
+}  // namespace
+
+::sockaddr_un
+make_socket_address(std::string const &pathname)
+{
+    ::sockaddr_un addr{};
+
+    if (pathname.empty() || pathname.size() >= sizeof(addr.sun_path)) {
+        throw std::invalid_argument{fmt::format(
+            "The pathname '{0}' is not a valid socket pathname.", pathname)};
+    }
+
+    addr.sun_family = AF_UNIX;
+
+    std::memcpy(addr.sun_path, pathname.data(), pathname.size());
+
+    return addr;
+}
+
+file_descriptor
+make_socket()
+{
+    file_descriptor fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd.get() == -1) {
+        throw std::system_error{current_error_code(),
+                                "The socket cannot be created."};
+    }
+
+#ifdef SO_NOSIGPIPE
+    // macOS does not support MSG_NOSIGNAL.
+    int value = 1;
+    ::setsockopt(fd.get(), SOL_SOCKET, SO_NOSIGPIPE, &value, sizeof(value));
+#endif
+
+    return fd;
+}
+
+int
+release_socket(file_descriptor const &fd)
+{
+    int r = ::fcntl(fd.get(), F_DUPFD_CLOEXEC, 0);
+    if (r == -1) {
+        throw std::system_error{current_error_code(),
+                                "The socket cannot be duplicated."};
+    }
+    return r;
+}
+
+int
+connect_socket(std::string const &pathname, char const *description)
+{
+    ::sockaddr_un addr = make_socket_address(pathname);
+
+    file_descriptor fd = make_socket();
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto *sa = reinterpret_cast<::sockaddr *>(&addr);
+
+    int r{};
+    do {
+        r = ::connect(fd.get(), sa, sizeof(addr));
+    } while (r == -1 && errno == EINTR);
+
+    if (r == -1) {
+        throw std::system_error{
+            current_error_code(),
+            fmt::format(
+                "The {0} at '{1}' cannot be reached.", description, pathname)};
+    }
+
+    return release_socket(fd);
+}
+
+int
+listen_socket(std::string const &pathname)
+{
+    ::sockaddr_un addr = make_socket_address(pathname);
+
+    file_descriptor fd = make_socket();
+
+    ::unlink(pathname.c_str());
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto *sa = reinterpret_cast<::sockaddr *>(&addr);
+
+    if (::bind(fd.get(), sa, sizeof(addr)) == -1) {
+        throw std::system_error{
+            current_error_code(),
+            fmt::format("The socket '{0}' cannot be bound.", pathname)};
+    }
+
+    if (::listen(fd.get(), SOMAXCONN) == -1) {
+        throw std::system_error{
+            current_error_code(),
+            fmt::format("The socket '{0}' cannot be listened on.", pathname)};
+    }
+
+    return release_socket(fd);
+}
+
+void
+write_line(int fd, std::string line, int passed_fd)
+{
+    line += '\n';
+
+    std::size_t num_bytes_written = 0;
+
+    while (num_bytes_written < line.size()) {
+        ::iovec iov{line.data() + num_bytes_written,
+                    line.size() - num_bytes_written};
+
+        alignas(::cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+
+        ::msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+
+        // The descriptor is attached to the first byte of the line.
+        if (passed_fd != -1 && num_bytes_written == 0) {
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+
+            ::cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+
+            std::memcpy(CMSG_DATA(cmsg), &passed_fd, sizeof(int));
+        }
+
+        ::ssize_t r{};
+        do {
+            r = ::sendmsg(fd, &msg, send_flags);
+        } while (r == -1 && errno == EINTR);
+
+        if (r == -1) {
+            throw std::system_error{
+                current_error_code(),
+                "The message cannot be sent over the socket."};
+        }
+
+        num_bytes_written += static_cast<std::size_t>(r);
+    }
+}
+
+bool
+read_line(int fd, std::string &buffer, std::string &line)
+{
+    return read_line_core(fd, buffer, line, nullptr);
+}
+
+bool
+read_line(int fd, std::string &buffer, std::string &line, int &passed_fd)
+{
+    return read_line_core(fd, buffer, line, &passed_fd);
+}
+
+socket_server::socket_server(std::string pathname)
+    : pathname_{std::move(pathname)}, fd_{listen_socket(pathname_)}
+{}
+
+socket_server::~socket_server()
+{
+    stop();
+
+    // Each thread closes the socket of its connection before it exits.
+    for (connection &conn : connections_) {
+        if (conn.thread.joinable()) {
+            conn.thread.join();
+        }
+    }
+
+    ::close(fd_);
+
+    ::unlink(pathname_.c_str());
+}
+
+void
+socket_server::serve(std::function<void(int)> const &handler)
+{
+    while (!stopped_) {
+        int fd = temp_failure_retry(::accept, fd_, nullptr, nullptr);
+        if (fd == -1) {
+            if (stopped_) {
+                break;
+            }
+
+            throw std::system_error{current_error_code(),
+                                    "The connection cannot be accepted."};
+        }
+
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        // If stop() has already shut down the connections, this one
+        // would never be shut down; drop it.
+        if (stopped_) {
+            ::close(fd);
+
+            break;
+        }
+
+        prune();
+
+        // The thread cannot close the socket before it is added to the
+        // list since we hold the mutex.
+        std::thread thrd = start_thread([this, handler, fd] {
+            handler(fd);
+
+            close(fd);
+        });
+
+        connections_.push_back(connection{fd, std::move(thrd)});
+    }
+}
+
+void
+socket_server::stop() noexcept
+{
+    if (stopped_.exchange(true)) {
+        return;
+    }
+
+    // Shutting down the sockets wakes up the threads blocked in accept()
+    // and recv().
+    ::shutdown(fd_, SHUT_RDWR);
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    for (connection const &conn : connections_) {
+        if (!conn.is_done) {
+            ::shutdown(conn.fd, SHUT_RDWR);
+        }
+    }
+}
+
+void
+socket_server::close(int fd) noexcept
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    for (connection &conn : connections_) {
+        if (conn.fd == fd && !conn.is_done) {
+            ::close(fd);
+
+            conn.is_done = true;
+
+            break;
+        }
+    }
+}
+
+// Joins the threads of the connections that are done. The caller must
+// hold the mutex.
+void
+socket_server::prune()
+{
+    for (auto pos = connections_.begin(); pos != connections_.end();) {
+        if (pos->is_done) {
+            pos->thread.join();
+
+            pos = connections_.erase(pos);
+        }
+        else {
+            ++pos;
+        }
+    }
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <sys/un.h>
+
+#include "mlio/platform/posix/detail/file_descriptor.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+// Helpers for the line-based protocols spoken over Unix domain sockets
+// by the shard coordinator and the data service.
+
+::sockaddr_un
+make_socket_address(std::string const &pathname);
+
+file_descriptor
+make_socket();
+
+// Returns a copy of the socket that is closed on exec and that outlives
+// the specified descriptor.
+int
+release_socket(file_descriptor const &fd);
+
+// Connects to the socket at the specified pathname. The description is
+// used in the error message if the connection fails.
+int
+connect_socket(std::string const &pathname, char const *description);
+
+// Binds a listening socket to the specified pathname, replacing the
+// socket file left behind by a previous server.
+int
+listen_socket(std::string const &pathname);
+
+// Writes the specified line followed by a newline. If passed_fd is not
+// -1, the descriptor is passed to the peer along with the line.
+void
+write_line(int fd, std::string line, int passed_fd = -1);
+
+// Reads the next line from the socket. The bytes read past the line are
+// kept in the buffer for the next call. Returns false if the peer has
+// closed the connection.
+bool
+read_line(int fd, std::string &buffer, std::string &line);
+
+// Same as above, but also receives the descriptor passed along with the
+// line, or -1 if there is none. The caller owns the descriptor.
+bool
+read_line(int fd, std::string &buffer, std::string &line, int &passed_fd);
+
+// Accepts connections on a Unix domain socket and serves each of them
+// on its own thread.
+class socket_server {
+public:
+    // Listens on the socket at the specified pathname.
+    explicit socket_server(std::string pathname);
+
+    socket_server(socket_server const &) = delete;
+
+    socket_server(socket_server &&) = delete;
+
+    // Stops the server, joins the threads of the connections, and
+    // removes the socket file.
+    ~socket_server();
+
+public:
+    socket_server &
+    operator=(socket_server const &) = delete;
+
+    socket_server &
+    operator=(socket_server &&) = delete;
+
+public:
+    // Accepts connections until stop() is called and calls the handler
+    // on a new thread for each of them. The socket of a connection is
+    // closed once the handler returns.
+    void
+    serve(std::function<void(int)> const &handler);
+
+    // Shuts down the listening socket and all connections. Can be called
+    // from any thread.
+    void
+    stop() noexcept;
+
+private:
+    // A connected client and the thread that serves it.
+    struct connection {
+        int fd;
+        std::thread thread{};
+        bool is_done{};
+    };
+
+    void
+    close(int fd) noexcept;
+
+    void
+    prune();
+
+private:
+    std::string pathname_;
+    int fd_;
+    std::atomic_bool stopped_{};
+    std::mutex mutex_{};
+    std::list<connection> connections_{};
+};
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
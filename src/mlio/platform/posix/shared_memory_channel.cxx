@@ -0,0 +1,1091 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/shared_memory_channel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "mlio/config.h"
+#include "mlio/cpu_array.h"
+#include "mlio/data_type.h"
+#include "mlio/detail/error.h"
+#include "mlio/device.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/schema.h"
+#include "mlio/tensor.h"
+#include "mlio/tensor_visitor.h"
+#include "mlio/util/cast.h"
+
+using mlio::detail::current_error_code;
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+constexpr std::uint64_t channel_magic = 0x324d'4853'4f49'4c4d;  // MLIOSHM2
+
+// The interval, in seconds, at which a blocked process checks whether
+// its peer is still alive.
+constexpr ::time_t peer_check_interval = 1;
+
+// The alignment of the records and of the tensor data within them.
+constexpr std::size_t alignment = 64;
+
+constexpr std::size_t
+align(std::size_t size) noexcept
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+enum class record_kind : std::uint32_t {
+    example,
+    padding,
+};
+
+// Each record in the ring buffer starts with this header. A record never
+// wraps around the end of the buffer; if the free space at the end is
+// too small, a padding record fills it up.
+struct record_header {
+    std::uint64_t size;
+    record_kind kind;
+    std::uint32_t released;
+};
+
+constexpr std::size_t record_header_size = align(sizeof(record_header));
+
+enum class tensor_kind : std::uint64_t {
+    dense,
+    coo,
+    csr,
+};
+
+template<data_type dt>
+struct get_element_size_op {
+    std::size_t
+    operator()()
+    {
+        if constexpr (dt == data_type::string) {
+            throw not_supported_error{
+                "Only numeric features can be sent through a shared "
+                "memory channel."};
+        }
+        else {
+            return sizeof(data_type_t<dt>);
+        }
+    }
+};
+
+std::size_t
+get_element_size(data_type dt)
+{
+    return dispatch<get_element_size_op>(dt);
+}
+
+// Builds the descriptor of an example that precedes its tensor data.
+class descriptor_writer {
+public:
+    void
+    write(std::uint64_t value)
+    {
+        auto const *ptr = reinterpret_cast<std::byte const *>(&value);
+
+        bytes_.insert(bytes_.end(), ptr, ptr + sizeof(value));
+    }
+
+    void
+    write(std::string const &value)
+    {
+        write(value.size());
+
+        auto const *ptr = reinterpret_cast<std::byte const *>(value.data());
+
+        bytes_.insert(bytes_.end(), ptr, ptr + value.size());
+
+        // Keep the following words aligned.
+        bytes_.resize((bytes_.size() + 7) & ~std::size_t{7});
+    }
+
+    void
+    write_shape(size_vector const &shape, ssize_vector const &strides)
+    {
+        write(shape.size());
+
+        for (std::size_t dim : shape) {
+            write(dim);
+        }
+        for (std::ptrdiff_t stride : strides) {
+            write(static_cast<std::uint64_t>(stride));
+        }
+    }
+
+    std::vector<std::byte> &
+    bytes() noexcept
+    {
+        return bytes_;
+    }
+
+private:
+    std::vector<std::byte> bytes_{};
+};
+
+class descriptor_reader {
+public:
+    explicit descriptor_reader(std::byte const *ptr) noexcept : ptr_{ptr}
+    {}
+
+public:
+    std::uint64_t
+    read() noexcept
+    {
+        std::uint64_t value{};
+
+        std::memcpy(&value, ptr_, sizeof(value));
+
+        ptr_ += sizeof(value);
+
+        return value;
+    }
+
+    std::string
+    read_string()
+    {
+        std::size_t size = read();
+
+        std::string value(reinterpret_cast<char const *>(ptr_), size);
+
+        ptr_ += (size + 7) & ~std::size_t{7};
+
+        return value;
+    }
+
+    void
+    read_shape(size_vector &shape, ssize_vector &strides)
+    {
+        std::size_t rank = read();
+
+        shape.resize(rank);
+        strides.resize(rank);
+
+        for (std::size_t &dim : shape) {
+            dim = read();
+        }
+        for (std::ptrdiff_t &stride : strides) {
+            stride = static_cast<std::ptrdiff_t>(read());
+        }
+    }
+
+    std::byte const *
+    position() const noexcept
+    {
+        return ptr_;
+    }
+
+private:
+    std::byte const *ptr_;
+};
+
+struct array_ref {
+    void const *data;
+    std::size_t num_bytes;
+};
+
+// Writes the descriptor of each tensor and collects its arrays.
+struct encode_tensor_op final : public tensor_visitor {
+    explicit encode_tensor_op(descriptor_writer &w,
+                              std::vector<array_ref> &a) noexcept
+        : writer{&w}, arrays{&a}
+    {}
+
+    using tensor_visitor::visit;
+
+    void
+    visit(dense_tensor const &tsr) final
+    {
+        writer->write(static_cast<std::uint64_t>(tensor_kind::dense));
+        writer->write_shape(tsr.shape(), tsr.strides());
+
+        add_array(tsr.data());
+    }
+
+    void
+    visit(coo_tensor const &tsr) final
+    {
+        writer->write(static_cast<std::uint64_t>(tensor_kind::coo));
+        writer->write_shape(tsr.shape(), tsr.strides());
+
+        add_array(tsr.data());
+
+        for (std::size_t dim = 0; dim < tsr.shape().size(); dim++) {
+            add_array(tsr.indices(dim));
+        }
+    }
+
+    void
+    visit(csr_tensor const &tsr) final
+    {
+        writer->write(static_cast<std::uint64_t>(tensor_kind::csr));
+        writer->write_shape(tsr.shape(), tsr.strides());
+
+        add_array(tsr.data());
+        add_array(tsr.indices());
+        add_array(tsr.indptr());
+    }
+
+    void
+    add_array(device_array_view arr)
+    {
+        std::size_t num_bytes = arr.size() * get_element_size(arr.dtype());
+
+        writer->write(static_cast<std::uint64_t>(arr.dtype()));
+        writer->write(arr.size());
+
+        arrays->push_back(array_ref{arr.data(), num_bytes});
+    }
+
+    descriptor_writer *writer;
+    std::vector<array_ref> *arrays;
+};
+
+}  // namespace
+
+// Keeps a received record alive while any of the tensors constructed
+// on top of it are in use.
+class shared_memory_record
+    : public intrusive_ref_counter<shared_memory_record> {
+public:
+    explicit shared_memory_record(intrusive_ptr<shared_memory_channel> chnl,
+                                  std::uint64_t pos) noexcept
+        : channel_{std::move(chnl)}, pos_{pos}
+    {}
+
+    shared_memory_record(shared_memory_record const &) = delete;
+
+    shared_memory_record(shared_memory_record &&) = delete;
+
+    ~shared_memory_record()
+    {
+        channel_->release(pos_);
+    }
+
+public:
+    shared_memory_record &
+    operator=(shared_memory_record const &) = delete;
+
+    shared_memory_record &
+    operator=(shared_memory_record &&) = delete;
+
+private:
+    intrusive_ptr<shared_memory_channel> channel_;
+    std::uint64_t pos_;
+};
+
+namespace {
+
+// Represents a device array that points into a received record.
+class shared_memory_array final : public device_array {
+public:
+    explicit shared_memory_array(data_type dt,
+                                 void *data,
+                                 std::size_t size,
+                                 intrusive_ptr<shared_memory_record> rec)
+        : data_type_{dt}, data_{data}, size_{size}, record_{std::move(rec)}
+    {}
+
+public:
+    std::unique_ptr<device_array>
+    clone() const final
+    {
+        auto arr = make_cpu_array(data_type_, size_);
+
+        std::memcpy(arr->data(), data_, size_ * get_element_size(data_type_));
+
+        return arr;
+    }
+
+public:
+    void *
+    data() noexcept final
+    {
+        return data_;
+    }
+
+    void const *
+    data() const noexcept final
+    {
+        return data_;
+    }
+
+    std::size_t
+    size() const noexcept final
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool
+    empty() const noexcept final
+    {
+        return size_ == 0;
+    }
+
+    data_type
+    dtype() const noexcept final
+    {
+        return data_type_;
+    }
+
+    device
+    get_device() const noexcept final
+    {
+        return device{device_kind::cpu()};
+    }
+
+private:
+    data_type data_type_;
+    void *data_;
+    std::size_t size_;
+    intrusive_ptr<shared_memory_record> record_;
+};
+
+// Identifies a process that uses a channel. A process ID is only
+// meaningful within the PID namespace in which it has been recorded.
+struct channel_peer {
+    std::int64_t pid;
+    std::uint64_t pid_ns;
+};
+
+}  // namespace
+
+// This struct lives at the beginning of the shared memory and is only
+// accessed while holding its mutex. The positions are monotonically
+// increasing byte counts; their remainder by the capacity is the offset
+// within the ring buffer.
+struct shared_memory_header {
+    std::uint64_t magic;
+    std::uint64_t capacity;
+    ::pthread_mutex_t mutex;
+    ::pthread_cond_t cond;
+    // The end of the records published by the sender.
+    std::uint64_t write_pos;
+    // The end of the records taken by the receiver.
+    std::uint64_t read_pos;
+    // The end of the records whose space can be reused.
+    std::uint64_t free_pos;
+    std::uint32_t closed;
+    // The processes that have last sent and received through the
+    // channel; zero if unknown.
+    channel_peer sender;
+    channel_peer receiver;
+};
+
+namespace {
+
+constexpr std::size_t header_size = align(sizeof(shared_memory_header));
+
+std::uint64_t
+get_pid_namespace() noexcept
+{
+#ifdef MLIO_PLATFORM_LINUX
+    struct ::stat buf {};
+    if (::stat("/proc/self/ns/pid", &buf) == 0) {
+        return buf.st_ino;
+    }
+#endif
+    return 0;
+}
+
+channel_peer
+get_current_peer() noexcept
+{
+    return {::getpid(), get_pid_namespace()};
+}
+
+// Indicates whether the specified process is known to have exited. A
+// process in another PID namespace is assumed to be alive.
+bool
+has_exited(channel_peer const &peer) noexcept
+{
+    if (peer.pid <= 0 || peer.pid_ns != get_pid_namespace()) {
+        return false;
+    }
+
+    if (::kill(static_cast<::pid_t>(peer.pid), 0) != 0) {
+        return errno == ESRCH;
+    }
+
+#ifdef MLIO_PLATFORM_LINUX
+    // A child process that has exited remains a zombie until its parent
+    // reaps it, which a parent blocked on the channel never does.
+    std::ifstream strm{fmt::format("/proc/{0}/stat", peer.pid)};
+
+    std::string stat{};
+    std::getline(strm, stat);
+
+    // The state follows the executable name, which is in parentheses.
+    std::size_t pos = stat.rfind(')');
+    if (pos != std::string::npos && pos + 2 < stat.size()) {
+        char state = stat[pos + 2];
+
+        return state == 'Z' || state == 'X';
+    }
+#endif
+
+    return false;
+}
+
+// Holds the locked process-shared mutex of a channel. If a process has
+// died while holding the mutex, the channel is closed as its state
+// might be inconsistent.
+class channel_lock {
+public:
+    explicit channel_lock(shared_memory_header &hdr) noexcept
+        : header_{&hdr}
+    {
+        recover(::pthread_mutex_lock(&header_->mutex));
+    }
+
+    channel_lock(channel_lock const &) = delete;
+
+    channel_lock(channel_lock &&) = delete;
+
+    ~channel_lock()
+    {
+        ::pthread_mutex_unlock(&header_->mutex);
+    }
+
+public:
+    channel_lock &
+    operator=(channel_lock const &) = delete;
+
+    channel_lock &
+    operator=(channel_lock &&) = delete;
+
+public:
+    // Waits for the condition variable of the channel. Since the peer
+    // cannot signal it once it has died, the wait times out
+    // periodically and closes the channel if the peer has exited.
+    void
+    wait(channel_peer const &peer) noexcept
+    {
+        ::timespec deadline{};
+        ::clock_gettime(CLOCK_REALTIME, &deadline);
+
+        deadline.tv_sec += peer_check_interval;
+
+        int r = ::pthread_cond_timedwait(
+            &header_->cond, &header_->mutex, &deadline);
+        if (r == ETIMEDOUT && has_exited(peer)) {
+            header_->closed = 1;
+        }
+        else {
+            recover(r);
+        }
+    }
+
+private:
+    void
+    recover(int r) noexcept
+    {
+#ifdef MLIO_PLATFORM_LINUX
+        if (r == EOWNERDEAD) {
+            header_->closed = 1;
+
+            ::pthread_mutex_consistent(&header_->mutex);
+        }
+#else
+        static_cast<void>(r);
+#endif
+    }
+
+private:
+    shared_memory_header *header_;
+};
+
+int
+make_shared_memory_fd()
+{
+#ifdef MLIO_PLATFORM_LINUX
+    int fd = ::memfd_create("mlio-channel", MFD_CLOEXEC);
+#else
+    static std::atomic<unsigned> counter{};
+
+    std::string name = fmt::format("/mlio-{0}-{1}", ::getpid(), counter++);
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd != -1) {
+        ::shm_unlink(name.c_str());
+    }
+#endif
+
+    if (fd == -1) {
+        throw std::system_error{current_error_code(),
+                                "The shared memory cannot be created."};
+    }
+    return fd;
+}
+
+}  // namespace
+}  // namespace detail
+
+shared_memory_channel::shared_memory_channel(std::size_t capacity)
+    : capacity_{detail::align(capacity)}
+{
+    if (capacity == 0) {
+        throw std::invalid_argument{
+            "The capacity must be greater than zero."};
+    }
+
+    map_size_ = detail::header_size + capacity_;
+
+    fd_ = detail::make_shared_memory_fd();
+
+    try {
+        if (::ftruncate(fd_, static_cast<::off_t>(map_size_)) != 0) {
+            throw std::system_error{current_error_code(),
+                                    "The shared memory cannot be allocated."};
+        }
+
+        map_memory();
+
+        ::pthread_mutexattr_t mtx_attr{};
+        ::pthread_mutexattr_init(&mtx_attr);
+        ::pthread_mutexattr_setpshared(&mtx_attr, PTHREAD_PROCESS_SHARED);
+#ifdef MLIO_PLATFORM_LINUX
+        // A peer that dies while holding the mutex must not block the
+        // other process forever.
+        ::pthread_mutexattr_setrobust(&mtx_attr, PTHREAD_MUTEX_ROBUST);
+#endif
+
+        int r = ::pthread_mutex_init(&header_->mutex, &mtx_attr);
+
+        ::pthread_mutexattr_destroy(&mtx_attr);
+
+        ::pthread_condattr_t cond_attr{};
+        ::pthread_condattr_init(&cond_attr);
+        ::pthread_condattr_setpshared(&cond_attr, PTHREAD_PROCESS_SHARED);
+
+        if (r == 0) {
+            r = ::pthread_cond_init(&header_->cond, &cond_attr);
+        }
+
+        ::pthread_condattr_destroy(&cond_attr);
+
+        if (r != 0) {
+            throw std::system_error{
+                r,
+                std::generic_category(),
+                "The shared memory channel cannot be initialized."};
+        }
+
+        header_->capacity = capacity_;
+
+        header_->magic = detail::channel_magic;
+    }
+    catch (...) {
+        unmap_memory();
+
+        throw;
+    }
+}
+
+shared_memory_channel::shared_memory_channel(int fd, std::size_t capacity)
+    : fd_{fd}, capacity_{capacity}, map_size_{detail::header_size + capacity}
+{
+    try {
+        map_memory();
+    }
+    catch (...) {
+        unmap_memory();
+
+        throw;
+    }
+}
+
+shared_memory_channel::~shared_memory_channel()
+{
+    unmap_memory();
+}
+
+intrusive_ptr<shared_memory_channel>
+shared_memory_channel::open(int fd)
+{
+    int dup_fd = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (dup_fd == -1) {
+        throw std::system_error{current_error_code(),
+                                "The file descriptor cannot be duplicated."};
+    }
+
+    struct ::stat buf {};
+    if (::fstat(dup_fd, &buf) != 0) {
+        ::close(dup_fd);
+
+        throw std::system_error{current_error_code(),
+                                "The shared memory cannot be inspected."};
+    }
+
+    auto size = static_cast<std::size_t>(buf.st_size);
+    if (size <= detail::header_size) {
+        ::close(dup_fd);
+
+        throw std::invalid_argument{
+            "The file descriptor does not refer to a shared memory channel."};
+    }
+
+    intrusive_ptr<shared_memory_channel> chnl = wrap_intrusive(
+        new shared_memory_channel{dup_fd, size - detail::header_size});
+
+    if (chnl->header_->magic != detail::channel_magic ||
+        chnl->header_->capacity != chnl->capacity_) {
+
+        throw std::invalid_argument{
+            "The file descriptor does not refer to a shared memory channel."};
+    }
+
+    return chnl;
+}
+
+void
+shared_memory_channel::map_memory()
+{
+    void *addr = ::mmap(/*addr*/ nullptr,
+                        map_size_,
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED,
+                        fd_,
+                        /*offset*/ 0);
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+    if (addr == MAP_FAILED) {
+        throw std::system_error{current_error_code(),
+                                "The shared memory cannot be mapped."};
+    }
+
+    header_ = static_cast<detail::shared_memory_header *>(addr);
+
+    data_ = static_cast<std::byte *>(addr) + detail::header_size;
+}
+
+void
+shared_memory_channel::unmap_memory() noexcept
+{
+    if (header_ != nullptr) {
+        ::munmap(header_, map_size_);
+
+        header_ = nullptr;
+        data_ = nullptr;
+    }
+
+    if (fd_ != -1) {
+        ::close(fd_);
+
+        fd_ = -1;
+    }
+}
+
+void
+shared_memory_channel::send(example const &exm)
+{
+    detail::descriptor_writer schema_writer{};
+
+    auto const &descs = exm.get_schema().descriptors();
+
+    schema_writer.write(descs.size());
+
+    for (feature_desc const &desc : descs) {
+        schema_writer.write(desc.name());
+        schema_writer.write(static_cast<std::uint64_t>(desc.dtype()));
+        schema_writer.write(static_cast<std::uint64_t>(desc.sparse()));
+        schema_writer.write_shape(desc.shape(), desc.strides());
+    }
+
+    detail::descriptor_writer writer{};
+
+    std::vector<std::byte> &schema_bytes = schema_writer.bytes();
+
+    writer.write(schema_bytes.size());
+
+    writer.bytes().insert(
+        writer.bytes().end(), schema_bytes.begin(), schema_bytes.end());
+
+    writer.write(exm.padding);
+    writer.write(exm.epoch);
+    writer.write(static_cast<std::uint64_t>(exm.end_of_epoch));
+
+    std::vector<detail::array_ref> arrays{};
+
+    detail::encode_tensor_op op{writer, arrays};
+
+    for (intrusive_ptr<tensor> const &tsr : exm.features()) {
+        std::as_const(*tsr).accept(op);
+    }
+
+    std::vector<std::byte> const &desc_bytes = writer.bytes();
+
+    std::size_t size =
+        detail::record_header_size + detail::align(desc_bytes.size());
+
+    for (detail::array_ref const &arr : arrays) {
+        size += detail::align(arr.num_bytes);
+    }
+
+    std::byte *ptr = reserve(size);
+
+    std::memcpy(ptr, desc_bytes.data(), desc_bytes.size());
+
+    ptr += detail::align(desc_bytes.size());
+
+    for (detail::array_ref const &arr : arrays) {
+        if (arr.num_bytes > 0) {
+            std::memcpy(ptr, arr.data, arr.num_bytes);
+        }
+
+        ptr += detail::align(arr.num_bytes);
+    }
+
+    commit(size);
+}
+
+std::byte *
+shared_memory_channel::reserve(std::size_t size)
+{
+    if (size > capacity_) {
+        throw std::invalid_argument{fmt::format(
+            "The example requires {0:n} bytes, which exceeds the capacity "
+            "of the shared memory channel ({1:n} bytes).",
+            size,
+            capacity_)};
+    }
+
+    detail::channel_lock lock{*header_};
+
+    header_->sender = detail::get_current_peer();
+
+    for (;;) {
+        if (header_->closed != 0) {
+            throw std::runtime_error{"The shared memory channel is closed."};
+        }
+
+        std::size_t offset = header_->write_pos % capacity_;
+
+        // Records do not wrap around; if the record does not fit, the
+        // end of the buffer is filled up with a padding record as soon
+        // as its space is free and the record goes to the beginning.
+        bool needs_padding = offset + size > capacity_;
+
+        std::size_t num_bytes = needs_padding ? capacity_ - offset : size;
+
+        if (header_->write_pos + num_bytes - header_->free_pos > capacity_) {
+            lock.wait(header_->receiver);
+
+            continue;
+        }
+
+        auto *hdr = reinterpret_cast<detail::record_header *>(data_ + offset);
+
+        if (!needs_padding) {
+            *hdr = {size, detail::record_kind::example, 0};
+
+            return data_ + offset + detail::record_header_size;
+        }
+
+        *hdr = {num_bytes, detail::record_kind::padding, 1};
+
+        header_->write_pos += num_bytes;
+
+        ::pthread_cond_broadcast(&header_->cond);
+    }
+}
+
+void
+shared_memory_channel::commit(std::size_t size)
+{
+    {
+        detail::channel_lock lock{*header_};
+
+        header_->write_pos += size;
+    }
+
+    ::pthread_cond_broadcast(&header_->cond);
+}
+
+intrusive_ptr<example>
+shared_memory_channel::receive()
+{
+    std::uint64_t pos{};
+
+    std::byte *payload = acquire(pos);
+    if (payload == nullptr) {
+        return {};
+    }
+
+    // Gives back the space of the record once the example and all its
+    // tensors are gone, or if we fail to reconstruct the example.
+    auto rec = make_intrusive<detail::shared_memory_record>(
+        wrap_intrusive(this), pos);
+
+    std::byte const *ptr = payload;
+
+    intrusive_ptr<schema> shm = read_schema(ptr);
+
+    detail::descriptor_reader reader{ptr};
+
+    std::size_t padding = reader.read();
+    std::size_t epoch = reader.read();
+    bool end_of_epoch = reader.read() != 0;
+
+    // The tensor data follows the descriptor whose size is only known
+    // once it has been read; first collect the tensor metadata.
+    struct tensor_desc {
+        detail::tensor_kind kind{};
+        size_vector shape{};
+        ssize_vector strides{};
+        std::vector<std::pair<data_type, std::size_t>> arrays{};
+    };
+
+    std::vector<tensor_desc> tensor_descs(shm->descriptors().size());
+
+    for (tensor_desc &td : tensor_descs) {
+        td.kind = static_cast<detail::tensor_kind>(reader.read());
+
+        reader.read_shape(td.shape, td.strides);
+
+        std::size_t num_arrays = 1;
+        if (td.kind == detail::tensor_kind::coo) {
+            num_arrays += td.shape.size();
+        }
+        else if (td.kind == detail::tensor_kind::csr) {
+            num_arrays += 2;
+        }
+
+        for (std::size_t i = 0; i < num_arrays; i++) {
+            auto dt = static_cast<data_type>(reader.read());
+
+            td.arrays.emplace_back(dt, reader.read());
+        }
+    }
+
+    std::byte *data =
+        payload + detail::align(as_size(reader.position() - payload));
+
+    std::vector<intrusive_ptr<tensor>> tensors{};
+    tensors.reserve(tensor_descs.size());
+
+    for (tensor_desc &td : tensor_descs) {
+        std::vector<std::unique_ptr<device_array>> arrays{};
+        arrays.reserve(td.arrays.size());
+
+        for (auto [dt, size] : td.arrays) {
+            arrays.emplace_back(std::make_unique<detail::shared_memory_array>(
+                dt, data, size, rec));
+
+            data += detail::align(size * detail::get_element_size(dt));
+        }
+
+        switch (td.kind) {
+        case detail::tensor_kind::dense:
+            tensors.emplace_back(
+                make_intrusive<dense_tensor>(std::move(td.shape),
+                                             std::move(arrays[0]),
+                                             std::move(td.strides)));
+            break;
+
+        case detail::tensor_kind::coo: {
+            std::unique_ptr<device_array> arr = std::move(arrays[0]);
+
+            arrays.erase(arrays.begin());
+
+            tensors.emplace_back(make_intrusive<coo_tensor>(
+                std::move(td.shape), std::move(arr), std::move(arrays)));
+            break;
+        }
+
+        case detail::tensor_kind::csr:
+            tensors.emplace_back(
+                make_intrusive<csr_tensor>(std::move(td.shape),
+                                           std::move(arrays[0]),
+                                           std::move(arrays[1]),
+                                           std::move(arrays[2])));
+            break;
+        }
+    }
+
+    auto exm = make_intrusive<example>(std::move(shm), std::move(tensors));
+
+    exm->padding = padding;
+    exm->epoch = epoch;
+    exm->end_of_epoch = end_of_epoch;
+
+    return exm;
+}
+
+std::byte *
+shared_memory_channel::acquire(std::uint64_t &pos)
+{
+    detail::channel_lock lock{*header_};
+
+    header_->receiver = detail::get_current_peer();
+
+    for (;;) {
+        while (header_->read_pos == header_->write_pos) {
+            if (header_->closed != 0) {
+                return nullptr;
+            }
+            lock.wait(header_->sender);
+        }
+
+        pos = header_->read_pos;
+
+        std::byte *ptr = data_ + pos % capacity_;
+
+        auto *hdr = reinterpret_cast<detail::record_header *>(ptr);
+
+        header_->read_pos += hdr->size;
+
+        if (hdr->kind == detail::record_kind::example) {
+            return ptr + detail::record_header_size;
+        }
+
+        // A padding record is released as soon as it is taken; give its
+        // space back to the sender unless an earlier record is still in
+        // use.
+        if (reclaim_space()) {
+            ::pthread_cond_broadcast(&header_->cond);
+        }
+    }
+}
+
+void
+shared_memory_channel::release(std::uint64_t pos) noexcept
+{
+    {
+        detail::channel_lock lock{*header_};
+
+        auto *hdr =
+            reinterpret_cast<detail::record_header *>(data_ + pos % capacity_);
+
+        hdr->released = 1;
+
+        reclaim_space();
+    }
+
+    ::pthread_cond_broadcast(&header_->cond);
+}
+
+bool
+shared_memory_channel::reclaim_space() noexcept
+{
+    std::uint64_t free_pos = header_->free_pos;
+
+    // The records are released in arbitrary order, but their space can
+    // only be reused in ring order.
+    while (header_->free_pos < header_->read_pos) {
+        auto *hdr = reinterpret_cast<detail::record_header *>(
+            data_ + header_->free_pos % capacity_);
+
+        if (hdr->released == 0) {
+            break;
+        }
+
+        header_->free_pos += hdr->size;
+    }
+
+    return header_->free_pos != free_pos;
+}
+
+intrusive_ptr<schema>
+shared_memory_channel::read_schema(std::byte const *&ptr)
+{
+    detail::descriptor_reader reader{ptr};
+
+    std::size_t size = reader.read();
+
+    std::byte const *begin = reader.position();
+    std::byte const *end = begin + size;
+
+    ptr = end;
+
+    // Consecutive examples almost always share the same schema; avoid
+    // rebuilding it.
+    if (schema_ != nullptr && schema_bytes_.size() == size &&
+        std::equal(begin, end, schema_bytes_.begin())) {
+
+        return schema_;
+    }
+
+    std::size_t num_features = reader.read();
+
+    std::vector<feature_desc> descs{};
+    descs.reserve(num_features);
+
+    for (std::size_t i = 0; i < num_features; i++) {
+        std::string name = reader.read_string();
+
+        auto dt = static_cast<data_type>(reader.read());
+
+        bool sparse = reader.read() != 0;
+
+        size_vector shape{};
+        ssize_vector strides{};
+        reader.read_shape(shape, strides);
+
+        descs.emplace_back(
+            feature_desc_builder{std::move(name), dt, std::move(shape)}
+                .with_sparsity(sparse)
+                .with_strides(std::move(strides))
+                .build());
+    }
+
+    schema_ = make_intrusive<schema>(std::move(descs));
+
+    schema_bytes_.assign(begin, end);
+
+    return schema_;
+}
+
+void
+shared_memory_channel::close() noexcept
+{
+    {
+        detail::channel_lock lock{*header_};
+
+        header_->closed = 1;
+    }
+
+    ::pthread_cond_broadcast(&header_->cond);
+}
+
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/shard_coordinator.h"  // IWYU pragma: associated
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "mlio/platform/posix/detail/unix_socket.h"
+
+namespace mlio {
+inline namespace v1 {
+
+socket_shard_coordinator::socket_shard_coordinator(std::string pathname)
+    : pathname_{std::move(pathname)}
+{}
+
+socket_shard_coordinator::~socket_shard_coordinator()
+{
+    if (fd_ != -1) {
+        ::close(fd_);
+    }
+}
+
+std::optional<std::size_t>
+socket_shard_coordinator::acquire_work_item(std::size_t epoch,
+                                            std::size_t num_items)
+{
+    std::string res =
+        send_request(fmt::format("acquire {0} {1}", epoch, num_items));
+
+    if (res == "none") {
+        return {};
+    }
+
+    std::istringstream strm{res};
+
+    std::string kind{};
+    std::size_t item_idx{};
+
+    if (!(strm >> kind >> item_idx) || kind != "item") {
+        throw std::runtime_error{fmt::format(
+            "The shard coordinator has returned an invalid response '{0}'.",
+            res)};
+    }
+
+    return item_idx;
+}
+
+void
+socket_shard_coordinator::complete_work_item(std::size_t epoch,
+                                             std::size_t item_idx)
+{
+    std::string res =
+        send_request(fmt::format("complete {0} {1}", epoch, item_idx));
+
+    if (res != "ok") {
+        throw std::runtime_error{fmt::format(
+            "The shard coordinator has returned an invalid response '{0}'.",
+            res)};
+    }
+}
+
+std::string
+socket_shard_coordinator::send_request(std::string const &req)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    if (fd_ == -1) {
+        fd_ = detail::connect_socket(pathname_, "shard coordinator");
+    }
+
+    std::string res{};
+
+    try {
+        detail::write_line(fd_, req);
+
+        if (!detail::read_line(fd_, buffer_, res)) {
+            throw std::runtime_error{
+                "The shard coordinator has closed the connection."};
+        }
+    }
+    catch (...) {
+        // Reconnect on the next request.
+        ::close(std::exchange(fd_, -1));
+
+        buffer_.clear();
+
+        throw;
+    }
+
+    if (res.rfind("error ", 0) == 0) {
+        throw std::runtime_error{fmt::format(
+            "The shard coordinator has rejected the request: {0}",
+            res.substr(6))};
+    }
+
+    return res;
+}
+
+shard_coordinator_server::shard_coordinator_server(
+    std::string pathname, intrusive_ptr<shard_coordinator> coordinator)
+    : coordinator_{std::move(coordinator)}
+{
+    if (coordinator_ == nullptr) {
+        coordinator_ = make_intrusive<local_shard_coordinator>();
+    }
+
+    server_ = std::make_unique<detail::socket_server>(std::move(pathname));
+}
+
+shard_coordinator_server::~shard_coordinator_server() = default;
+
+void
+shard_coordinator_server::serve()
+{
+    server_->serve([this](int fd) {
+        serve_connection(fd);
+    });
+}
+
+void
+shard_coordinator_server::stop()
+{
+    server_->stop();
+}
+
+void
+shard_coordinator_server::serve_connection(int fd)
+{
+    std::string buffer{};
+    std::string req{};
+
+    try {
+        while (detail::read_line(fd, buffer, req)) {
+            detail::write_line(fd, handle_request(req));
+        }
+    }
+    catch (std::exception const &) {
+        // The client has gone away; its work item will not be completed
+        // but there is nothing else to clean up.
+    }
+}
+
+std::string
+shard_coordinator_server::handle_request(std::string const &req)
+{
+    std::istringstream strm{req};
+
+    std::string cmd{};
+    std::size_t epoch{};
+    std::size_t value{};
+
+    if (!(strm >> cmd >> epoch >> value)) {
+        return fmt::format("error The request '{0}' is malformed.", req);
+    }
+
+    try {
+        if (cmd == "acquire") {
+            std::optional<std::size_t> item_idx =
+                coordinator_->acquire_work_item(epoch, value);
+            if (item_idx == std::nullopt) {
+                return "none";
+            }
+            return fmt::format("item {0}", *item_idx);
+        }
+
+        if (cmd == "complete") {
+            coordinator_->complete_work_item(epoch, value);
+
+            return "ok";
+        }
+    }
+    catch (std::exception const &e) {
+        return fmt::format("error {0}", e.what());
+    }
+
+    return fmt::format("error The command '{0}' is not supported.", cmd);
+}
+
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/reader_state.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "mlio/endian.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+void
+state_writer::write(std::uint64_t value)
+{
+    // The conversion is symmetric.
+    value = little_to_host_order(value);
+
+    auto first = reinterpret_cast<std::byte const *>(&value);
+
+    bits_.insert(bits_.end(), first, first + sizeof(value));
+}
+
+void
+state_writer::write(std::string_view value)
+{
+    write(value.size());
+
+    auto first = reinterpret_cast<std::byte const *>(value.data());
+
+    bits_.insert(bits_.end(), first, first + value.size());
+}
+
+void
+state_writer::write(std::mt19937_64 const &mt)
+{
+    std::ostringstream strm{};
+
+    strm << mt;
+
+    write(strm.str());
+}
+
+void
+state_writer::write(state_writer const &other)
+{
+    auto first = other.bits_.begin();
+
+    for (auto const &[offset, fn] : other.deferred_) {
+        auto last = other.bits_.begin() + as_ssize(offset);
+
+        bits_.insert(bits_.end(), first, last);
+
+        fn(*this);
+
+        first = last;
+    }
+
+    bits_.insert(bits_.end(), first, other.bits_.end());
+
+    if (other.error_) {
+        set_error(*other.error_);
+    }
+}
+
+std::uint64_t
+state_reader::read_uint64()
+{
+    memory_span bits = read_bits(sizeof(std::uint64_t));
+
+    std::uint64_t value{};
+
+    std::copy(bits.begin(), bits.end(), reinterpret_cast<std::byte *>(&value));
+
+    return little_to_host_order(value);
+}
+
+std::size_t
+state_reader::read_size()
+{
+    return read_uint64();
+}
+
+bool
+state_reader::read_bool()
+{
+    return read_uint64() != 0;
+}
+
+std::string
+state_reader::read_string()
+{
+    memory_span bits = read_bits(read_size());
+
+    return std::string{reinterpret_cast<char const *>(bits.data()),
+                       bits.size()};
+}
+
+void
+state_reader::read(std::mt19937_64 &mt)
+{
+    std::istringstream strm{read_string()};
+
+    if (!(strm >> mt)) {
+        throw std::invalid_argument{
+            "The state contains an invalid random number generator state."};
+    }
+}
+
+memory_span
+state_reader::read_bits(std::size_t size)
+{
+    if (size > bits_.size()) {
+        throw std::invalid_argument{"The state is truncated."};
+    }
+
+    memory_span bits = bits_.first(size);
+
+    bits_ = bits_.subspan(size);
+
+    return bits;
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
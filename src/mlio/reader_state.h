@@ -0,0 +1,126 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+// Serializes the position of a reader into a byte buffer. All integers
+// are stored as little-endian 64-bit values.
+class state_writer {
+public:
+    void
+    write(std::uint64_t value);
+
+    void
+    write(std::string_view value);
+
+    void
+    write(std::mt19937_64 const &mt);
+
+    // Appends the specified state; its deferred parts are serialized
+    // into this state.
+    void
+    write(state_writer const &other);
+
+    // Appends a part of the state that is serialized only once the
+    // state is requested by the caller. The function must not refer to
+    // anything that the reader modifies later on.
+    void
+    write_deferred(std::function<void(state_writer &)> fn)
+    {
+        deferred_.emplace_back(bits_.size(), std::move(fn));
+    }
+
+    // Marks the state as one that cannot be restored; the error message
+    // is reported when the state is requested by the caller.
+    void
+    set_error(std::string msg)
+    {
+        if (error_ == std::nullopt) {
+            error_ = std::move(msg);
+        }
+    }
+
+public:
+    // Gets the serialized state, excluding the deferred parts.
+    std::vector<std::byte> const &
+    bits() const noexcept
+    {
+        return bits_;
+    }
+
+    std::optional<std::string> const &
+    error() const noexcept
+    {
+        return error_;
+    }
+
+private:
+    std::vector<std::byte> bits_{};
+    std::optional<std::string> error_{};
+    // The deferred parts along with their offsets in bits_.
+    std::vector<std::pair<std::size_t, std::function<void(state_writer &)>>>
+        deferred_{};
+};
+
+// Deserializes a state written by a state_writer. Throws an
+// std::invalid_argument if the state is truncated.
+class state_reader {
+public:
+    explicit state_reader(memory_span bits) noexcept : bits_{bits}
+    {}
+
+public:
+    std::uint64_t
+    read_uint64();
+
+    std::size_t
+    read_size();
+
+    bool
+    read_bool();
+
+    std::string
+    read_string();
+
+    void
+    read(std::mt19937_64 &mt);
+
+private:
+    memory_span
+    read_bits(std::size_t size);
+
+private:
+    memory_span bits_;
+};
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,381 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/rebatching_data_reader.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "mlio/cpu_array.h"
+#include "mlio/data_type.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/schema.h"
+#include "mlio/tensor.h"
+#include "mlio/tensor_rows.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+// Represents a container that refers to the data of a tensor and
+// keeps it alive. Used to construct zero-copy views of tensors.
+template<typename T>
+class tensor_data_view {
+public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = T const *;
+
+public:
+    explicit tensor_data_view(intrusive_ptr<tensor> owner,
+                              T *data,
+                              std::size_t size) noexcept
+        : owner_{std::move(owner)}, data_{data}, size_{size}
+    {}
+
+public:
+    T *
+    data() noexcept
+    {
+        return data_;
+    }
+
+    T const *
+    data() const noexcept
+    {
+        return data_;
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool
+    empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    const_iterator
+    begin() const noexcept
+    {
+        return data_;
+    }
+
+    const_iterator
+    end() const noexcept
+    {
+        return data_ + size_;
+    }
+
+private:
+    intrusive_ptr<tensor> owner_;
+    T *data_;
+    std::size_t size_;
+};
+
+template<data_type dt>
+struct make_view_op {
+    std::unique_ptr<device_array>
+    operator()(intrusive_ptr<tensor> owner,
+               device_array_span arr,
+               std::size_t offset,
+               std::size_t size)
+    {
+        using T = data_type_t<dt>;
+
+        T *data = arr.as<T>().data() + offset;
+
+        return cpu_array_access::wrap(
+            dt, tensor_data_view<T>{std::move(owner), data, size});
+    }
+};
+
+}  // namespace
+}  // namespace detail
+
+rebatching_data_reader::rebatching_data_reader(
+    intrusive_ptr<data_reader> rdr,
+    std::size_t batch_size,
+    last_batch_handling last_batch_hnd)
+    : reader_{std::move(rdr)}
+    , batch_size_{batch_size}
+    , last_batch_hnd_{last_batch_hnd}
+{
+    if (reader_ == nullptr) {
+        throw std::invalid_argument{"The data reader must not be null."};
+    }
+
+    if (batch_size_ == 0) {
+        throw std::invalid_argument{
+            "The batch size must be greater than zero."};
+    }
+}
+
+rebatching_data_reader::~rebatching_data_reader() = default;
+
+intrusive_ptr<example>
+rebatching_data_reader::read_example()
+{
+    if (peeked_example_) {
+        return std::exchange(peeked_example_, nullptr);
+    }
+    return read_example_core();
+}
+
+intrusive_ptr<example> const &
+rebatching_data_reader::peek_example()
+{
+    if (peeked_example_ == nullptr) {
+        peeked_example_ = read_example_core();
+    }
+    return peeked_example_;
+}
+
+intrusive_ptr<example>
+rebatching_data_reader::read_example_core()
+{
+    fill_pending_rows();
+
+    if (num_pending_rows_ == 0) {
+        return {};
+    }
+
+    std::size_t num_rows = std::min(batch_size_, num_pending_rows_);
+
+    // This is the last batch.
+    if (num_rows < batch_size_) {
+        if (last_batch_hnd_ == last_batch_handling::drop) {
+            pending_rows_.clear();
+
+            num_pending_rows_ = 0;
+
+            return {};
+        }
+
+        if (last_batch_hnd_ == last_batch_handling::pad) {
+            return make_copy(num_rows, batch_size_);
+        }
+    }
+
+    row_range &front = pending_rows_.front();
+
+    // If the rows are all in a single example, we can avoid the copy.
+    if (front.end - front.begin >= num_rows) {
+        row_range rng{front.exm, front.begin, front.begin + num_rows};
+
+        front.begin += num_rows;
+        if (front.begin == front.end) {
+            pending_rows_.pop_front();
+        }
+
+        num_pending_rows_ -= num_rows;
+
+        return make_view(rng);
+    }
+
+    return make_copy(num_rows, num_rows);
+}
+
+void
+rebatching_data_reader::fill_pending_rows()
+{
+    while (num_pending_rows_ < batch_size_ && !is_exhausted_) {
+        intrusive_ptr<example> exm = reader_->read_example();
+        if (exm == nullptr) {
+            is_exhausted_ = true;
+
+            break;
+        }
+
+        std::size_t num_rows = detail::get_batch_size(*exm) - exm->padding;
+        if (num_rows == 0) {
+            continue;
+        }
+
+        pending_rows_.emplace_back(row_range{std::move(exm), 0, num_rows});
+
+        num_pending_rows_ += num_rows;
+    }
+}
+
+intrusive_ptr<example>
+rebatching_data_reader::make_view(row_range const &rng) const
+{
+    example const &src = *rng.exm;
+
+    std::size_t num_rows = rng.end - rng.begin;
+
+    // If the range covers the whole example, there is nothing to do.
+    if (rng.begin == 0 && src.padding == 0 &&
+        src.features().front()->shape()[0] == num_rows) {
+        return rng.exm;
+    }
+
+    std::vector<intrusive_ptr<tensor>> tensors{};
+    tensors.reserve(src.features().size());
+
+    for (auto const &tsr : src.features()) {
+        dense_tensor &dense = detail::as_dense_tensor(*tsr);
+
+        std::size_t offset = rng.begin * as_size(dense.strides()[0]);
+
+        std::size_t size = detail::get_data_size(dense, num_rows);
+
+        std::unique_ptr<device_array> arr =
+            dispatch<detail::make_view_op>(dense.dtype(),
+                                           tsr,
+                                           dense.data(),
+                                           offset,
+                                           size);
+
+        size_vector shape = dense.shape();
+        shape[0] = num_rows;
+
+        tensors.emplace_back(make_intrusive<dense_tensor>(
+            std::move(shape), std::move(arr), dense.strides()));
+    }
+
+    return make_intrusive<example>(make_schema(src.get_schema(), num_rows),
+                                   std::move(tensors));
+}
+
+intrusive_ptr<example>
+rebatching_data_reader::make_copy(std::size_t num_rows, std::size_t batch_size)
+{
+    example const &first = *pending_rows_.front().exm;
+
+    std::size_t num_features = first.features().size();
+
+    std::vector<intrusive_ptr<tensor>> tensors{};
+    tensors.reserve(num_features);
+
+    std::vector<std::unique_ptr<device_array>> arrays{};
+    arrays.reserve(num_features);
+
+    // Allocate the zero-initialized arrays of the batch; the padding, if
+    // any, is left as is.
+    for (auto const &tsr : first.features()) {
+        std::size_t size = batch_size * detail::get_row_size(*tsr);
+
+        arrays.emplace_back(make_cpu_array(tsr->dtype(), size));
+    }
+
+    std::size_t row_idx = 0;
+
+    while (row_idx < num_rows) {
+        row_range &rng = pending_rows_.front();
+
+        example const &src = *rng.exm;
+
+        if (src.features().size() != num_features) {
+            throw std::invalid_argument{
+                "The examples to rebatch must have the same features."};
+        }
+
+        std::size_t n = std::min(rng.end - rng.begin, num_rows - row_idx);
+
+        for (std::size_t i = 0; i < num_features; i++) {
+            dense_tensor &dense = detail::as_dense_tensor(*src.features()[i]);
+
+            if (dense.dtype() != arrays[i]->dtype() ||
+                detail::get_row_size(dense) * batch_size !=
+                    arrays[i]->size()) {
+                throw std::invalid_argument{
+                    "The examples to rebatch must have the same features."};
+            }
+
+            detail::copy_rows(dense, rng.begin, *arrays[i], row_idx, n);
+        }
+
+        row_idx += n;
+
+        rng.begin += n;
+        if (rng.begin == rng.end) {
+            pending_rows_.pop_front();
+        }
+
+        num_pending_rows_ -= n;
+    }
+
+    for (std::size_t i = 0; i < num_features; i++) {
+        size_vector shape = first.features()[i]->shape();
+        shape[0] = batch_size;
+
+        tensors.emplace_back(make_intrusive<dense_tensor>(
+            std::move(shape), std::move(arrays[i])));
+    }
+
+    auto exm = make_intrusive<example>(
+        make_schema(first.get_schema(), batch_size), std::move(tensors));
+
+    exm->padding = batch_size - num_rows;
+
+    return exm;
+}
+
+intrusive_ptr<schema>
+rebatching_data_reader::make_schema(schema const &source,
+                                    std::size_t batch_size) const
+{
+    if (last_source_schema_.get() == &source &&
+        last_batch_size_ == batch_size) {
+        return last_schema_;
+    }
+
+    last_source_schema_ = wrap_intrusive(&source);
+
+    last_schema_ = detail::make_batch_schema(source, batch_size);
+
+    last_batch_size_ = batch_size;
+
+    return last_schema_;
+}
+
+void
+rebatching_data_reader::reset() noexcept
+{
+    reader_->reset();
+
+    pending_rows_.clear();
+
+    num_pending_rows_ = 0;
+
+    is_exhausted_ = false;
+
+    peeked_example_ = nullptr;
+}
+
+data_reader_statistics
+rebatching_data_reader::statistics() const
+{
+    return reader_->statistics();
+}
+
+std::size_t
+rebatching_data_reader::num_bytes_read() const noexcept
+{
+    return reader_->num_bytes_read();
+}
+
+}  // namespace v1
+}  // namespace mlio
@@ -21,6 +21,7 @@
 #include "mlio/config.h"
 #include "mlio/csv_reader.h"
 #include "mlio/memory/memory_slice.h"
+#include "mlio/not_supported_error.h"
 #include "mlio/record_readers/corrupt_record_error.h"
 #include "mlio/record_readers/detail/text_line.h"
 #include "mlio/record_readers/record.h"
@@ -63,6 +64,21 @@ csv_record_reader::decode_text_record(memory_slice &chunk,
     return {};
 }
 
+bool
+csv_record_reader::skip_to_next_record(memory_slice &chunk,
+                                       bool ignore_leftover)
+{
+    // With quoted new-lines a record boundary cannot be determined
+    // without parsing the file from its beginning.
+    if (params_->allow_quoted_new_lines) {
+        throw not_supported_error{
+            "The CSV record reader does not support seeking to an arbitrary "
+            "position when quoted new-line characters are allowed."};
+    }
+
+    return text_record_reader::skip_to_next_record(chunk, ignore_leftover);
+}
+
 bool
 csv_record_reader::is_comment_line(memory_slice const &chunk)
 {
@@ -47,6 +47,9 @@ private:
     std::optional<record>
     decode_text_record(memory_slice &chunk, bool ignore_leftover) final;
 
+    bool
+    skip_to_next_record(memory_slice &chunk, bool ignore_leftover) final;
+
     bool
     is_comment_line(memory_slice const &chunk);
 
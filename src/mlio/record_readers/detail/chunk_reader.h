@@ -48,10 +48,19 @@ public:
     virtual memory_slice
     read_chunk(memory_span leftover) = 0;
 
+    virtual void
+    seek(std::size_t position) = 0;
+
 public:
     virtual bool
     eof() const noexcept = 0;
 
+    virtual bool
+    seekable() const noexcept = 0;
+
+    virtual bool
+    supports_zero_copy() const noexcept = 0;
+
     virtual std::size_t
     chunk_size_hint() const noexcept = 0;
 
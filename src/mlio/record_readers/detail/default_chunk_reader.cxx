@@ -95,6 +95,14 @@ default_chunk_reader::read_chunk(memory_span leftover)
     return memory_slice{chunk}.first(chunk->end() - stdx::ssize(remaining));
 }
 
+void
+default_chunk_reader::seek(std::size_t position)
+{
+    stream_->seek(position);
+
+    eof_ = false;
+}
+
 void
 default_chunk_reader::set_chunk_size_hint(std::size_t value) noexcept
 {
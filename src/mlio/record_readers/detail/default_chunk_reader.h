@@ -39,6 +39,9 @@ public:
     memory_slice
     read_chunk(memory_span leftover) final;
 
+    void
+    seek(std::size_t position) final;
+
 public:
     bool
     eof() const noexcept final
@@ -46,6 +49,18 @@ public:
         return eof_;
     }
 
+    bool
+    seekable() const noexcept final
+    {
+        return stream_->seekable();
+    }
+
+    bool
+    supports_zero_copy() const noexcept final
+    {
+        return false;
+    }
+
     std::size_t
     chunk_size_hint() const noexcept final
     {
@@ -15,6 +15,8 @@
 
 #include "mlio/record_readers/detail/in_memory_chunk_reader.h"
 
+#include <algorithm>
+
 #include "mlio/memory/memory_slice.h"
 
 namespace mlio {
@@ -26,6 +28,12 @@ memory_slice in_memory_chunk_reader::read_chunk(memory_span)
     return std::exchange(chunk_, {});
 }
 
+void
+in_memory_chunk_reader::seek(std::size_t position)
+{
+    chunk_ = source_.subslice(std::min(position, source_.size()));
+}
+
 }  // namespace detail
 }  // namespace v1
 }  // namespace mlio
@@ -29,13 +29,16 @@ namespace detail {
 class in_memory_chunk_reader : public chunk_reader {
 public:
     explicit in_memory_chunk_reader(memory_slice &&chunk) noexcept
-        : chunk_{std::move(chunk)}
+        : source_{std::move(chunk)}, chunk_{source_}
     {}
 
 public:
     memory_slice
     read_chunk(memory_span leftover) final;
 
+    void
+    seek(std::size_t position) final;
+
 public:
     bool
     eof() const noexcept final
@@ -43,6 +46,18 @@ public:
         return chunk_.empty();
     }
 
+    bool
+    seekable() const noexcept final
+    {
+        return true;
+    }
+
+    bool
+    supports_zero_copy() const noexcept final
+    {
+        return true;
+    }
+
     std::size_t
     chunk_size_hint() const noexcept final
     {
@@ -53,6 +68,7 @@ public:
     {}
 
 private:
+    memory_slice source_;
     memory_slice chunk_;
 };
 
@@ -0,0 +1,236 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/record_readers/record_index.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+#include <fmt/format.h>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/endian.h"
+#include "mlio/record_readers/record.h"
+#include "mlio/record_readers/record_reader.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+// The on-disk layout is a sequence of little-endian 64-bit integers:
+// magic ("MLIOINDX"), version, stride, number of records, data size
+// (or max if unknown), number of positions, and the positions.
+constexpr std::uint64_t record_index_magic = 0x5844'4e49'4f49'4c4d;
+constexpr std::uint64_t record_index_version = 1;
+constexpr std::uint64_t unknown_data_size = ~std::uint64_t{};
+
+void
+write_uint64(std::ofstream &strm, std::uint64_t value)
+{
+    // The conversion is symmetric.
+    value = little_to_host_order(value);
+
+    strm.write(reinterpret_cast<char const *>(&value), sizeof(value));
+}
+
+std::optional<std::uint64_t>
+read_uint64(std::ifstream &strm)
+{
+    std::uint64_t value{};
+    if (!strm.read(reinterpret_cast<char *>(&value), sizeof(value))) {
+        return {};
+    }
+    return little_to_host_order(value);
+}
+
+}  // namespace
+}  // namespace detail
+
+record_index::record_index(std::size_t stride,
+                           std::vector<std::size_t> positions,
+                           std::size_t num_records,
+                           std::optional<std::size_t> data_size)
+    : stride_{stride}
+    , positions_{std::move(positions)}
+    , num_records_{num_records}
+    , data_size_{data_size}
+{
+    if (stride_ == 0) {
+        throw std::invalid_argument{
+            "The stride of the record index must be greater than zero."};
+    }
+
+    if (positions_.size() != (num_records_ + stride_ - 1) / stride_) {
+        throw std::invalid_argument{
+            "The number of positions does not match the number of records "
+            "and the stride."};
+    }
+}
+
+std::pair<std::size_t, std::size_t>
+record_index::lookup(std::size_t record_idx) const noexcept
+{
+    if (positions_.empty()) {
+        return {0, 0};
+    }
+
+    std::size_t idx = std::min(record_idx / stride_, positions_.size() - 1);
+
+    return {idx * stride_, positions_[idx]};
+}
+
+record_index
+make_record_index(record_reader &rdr,
+                  std::size_t stride,
+                  std::optional<std::size_t> data_size)
+{
+    if (stride == 0) {
+        throw std::invalid_argument{
+            "The stride of the record index must be greater than zero."};
+    }
+
+    std::vector<std::size_t> positions{};
+
+    std::size_t num_records = 0;
+
+    while (true) {
+        std::size_t position = rdr.position();
+
+        std::optional<record> rec = rdr.read_record();
+        if (rec == std::nullopt) {
+            break;
+        }
+
+        if (num_records % stride == 0) {
+            positions.push_back(position);
+        }
+
+        num_records++;
+    }
+
+    return record_index{stride, std::move(positions), num_records, data_size};
+}
+
+void
+save_record_index(record_index const &idx, std::string const &pathname)
+{
+    std::ofstream strm{pathname, std::ios::binary | std::ios::trunc};
+
+    detail::write_uint64(strm, detail::record_index_magic);
+    detail::write_uint64(strm, detail::record_index_version);
+    detail::write_uint64(strm, idx.stride());
+    detail::write_uint64(strm, idx.num_records());
+    detail::write_uint64(strm,
+                         idx.data_size().value_or(detail::unknown_data_size));
+    detail::write_uint64(strm, idx.positions().size());
+
+    for (std::size_t position : idx.positions()) {
+        detail::write_uint64(strm, position);
+    }
+
+    strm.flush();
+    if (!strm) {
+        throw std::system_error{
+            std::make_error_code(std::errc::io_error),
+            fmt::format("The record index '{0}' cannot be written.",
+                        pathname)};
+    }
+}
+
+record_index
+load_record_index(std::string const &pathname)
+{
+    std::ifstream strm{pathname, std::ios::binary};
+    if (!strm) {
+        throw std::system_error{
+            std::make_error_code(std::errc::no_such_file_or_directory),
+            fmt::format("The record index '{0}' cannot be opened.", pathname)};
+    }
+
+    auto magic = detail::read_uint64(strm);
+    auto version = detail::read_uint64(strm);
+    if (magic != detail::record_index_magic ||
+        version != detail::record_index_version) {
+        throw data_reader_error{fmt::format(
+            "The file '{0}' is not a valid record index.", pathname)};
+    }
+
+    auto stride = detail::read_uint64(strm);
+    auto num_records = detail::read_uint64(strm);
+    auto data_size = detail::read_uint64(strm);
+    auto num_positions = detail::read_uint64(strm);
+    if (!num_positions) {
+        throw data_reader_error{fmt::format(
+            "The header of the record index '{0}' is truncated.", pathname)};
+    }
+
+    // The number of positions comes from the file; make sure that the
+    // file can hold them before allocating memory for them.
+    std::streamoff header_end = strm.tellg();
+    strm.seekg(0, std::ios::end);
+    std::streamoff file_end = strm.tellg();
+    strm.seekg(header_end);
+
+    if (header_end < 0 || file_end < header_end ||
+        *num_positions > static_cast<std::uint64_t>(file_end - header_end) /
+                             sizeof(std::uint64_t)) {
+        throw data_reader_error{fmt::format(
+            "The record index '{0}' is truncated.", pathname)};
+    }
+
+    std::vector<std::size_t> positions{};
+    positions.reserve(*num_positions);
+
+    for (std::uint64_t i = 0; i < *num_positions; i++) {
+        auto position = detail::read_uint64(strm);
+        if (position == std::nullopt) {
+            throw data_reader_error{fmt::format(
+                "The record index '{0}' is truncated.", pathname)};
+        }
+        positions.push_back(*position);
+    }
+
+    std::optional<std::size_t> size{};
+    if (*data_size != detail::unknown_data_size) {
+        size = *data_size;
+    }
+
+    try {
+        return record_index{*stride, std::move(positions), *num_records, size};
+    }
+    catch (std::invalid_argument const &) {
+        std::throw_with_nested(data_reader_error{fmt::format(
+            "The record index '{0}' is corrupt. "
+            "See nested exception for details.",
+            pathname)});
+    }
+}
+
+std::string
+get_record_index_pathname(std::string_view pathname)
+{
+    std::string idx_pathname{pathname};
+
+    idx_pathname += ".mlidx";
+
+    return idx_pathname;
+}
+
+}  // namespace v1
+}  // namespace mlio
@@ -20,5 +20,11 @@ inline namespace v1 {
 
 record_reader::~record_reader() = default;
 
+std::chrono::nanoseconds
+record_reader::read_time() const noexcept
+{
+    return {};
+}
+
 }  // namespace v1
 }  // namespace mlio
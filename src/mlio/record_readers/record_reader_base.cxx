@@ -33,10 +33,37 @@ std::optional<record> const &
 record_reader_base::peek_record()
 {
     if (peeked_record_ == std::nullopt) {
+        peeked_position_ = position_core();
+
         peeked_record_ = read_record_core();
     }
     return peeked_record_;
 }
 
+void
+record_reader_base::seek(std::size_t position)
+{
+    peeked_record_ = std::nullopt;
+
+    seek_core(position);
+}
+
+void
+record_reader_base::seek_to_record_boundary(std::size_t position)
+{
+    peeked_record_ = std::nullopt;
+
+    seek_to_record_boundary_core(position);
+}
+
+std::size_t
+record_reader_base::position() const
+{
+    if (peeked_record_) {
+        return peeked_position_;
+    }
+    return position_core();
+}
+
 }  // namespace v1
 }  // namespace mlio
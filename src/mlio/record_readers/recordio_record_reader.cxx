@@ -15,15 +15,20 @@
 
 #include "mlio/record_readers/recordio_record_reader.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 #include <fmt/format.h>
 
+#include "mlio/endian.h"
 #include "mlio/memory/memory_slice.h"
 #include "mlio/record_readers/corrupt_record_error.h"
 #include "mlio/record_readers/detail/recordio_header.h"
 #include "mlio/record_readers/detail/util.h"
 #include "mlio/record_readers/record.h"
+#include "mlio/span.h"
 
 namespace mlio {
 inline namespace v1 {
@@ -78,6 +83,60 @@ recordio_record_reader::decode_record(memory_slice &chunk,
         std::move(payload), record_size + hdr->size(), hdr->get_record_kind()};
 }
 
+bool
+recordio_record_reader::skip_to_next_record(memory_slice &chunk,
+                                            bool ignore_leftover)
+{
+    constexpr std::uint32_t magic = 0xced7'230a;
+
+    constexpr std::size_t alignment = detail::recordio_header::alignment;
+
+    auto bits = as_span<std::byte const>(chunk);
+
+    std::size_t pos = position();
+
+    // Records are always on 4-byte boundary; the first candidate is the
+    // first aligned offset after the beginning of the chunk.
+    std::size_t offset = detail::align(pos + 1, alignment) - pos;
+
+    for (; offset + sizeof(std::uint32_t) * 2 <= bits.size();
+         offset += alignment) {
+        std::uint32_t hdr_magic{};
+        std::uint32_t hdr_data{};
+
+        // The chunk is not guaranteed to be aligned in memory.
+        std::memcpy(&hdr_magic, bits.data() + offset, sizeof(std::uint32_t));
+        std::memcpy(&hdr_data,
+                    bits.data() + offset + sizeof(std::uint32_t),
+                    sizeof(std::uint32_t));
+
+        if (little_to_host_order(hdr_magic) != magic) {
+            continue;
+        }
+
+        // A multi-part instance can only be read from its first record.
+        auto kind = recordio_header{little_to_host_order(hdr_data)}
+                        .get_record_kind();
+        if (kind == record_kind::complete || kind == record_kind::begin) {
+            chunk = chunk.subslice(offset);
+
+            return true;
+        }
+    }
+
+    if (!ignore_leftover) {
+        chunk = {};
+
+        return true;
+    }
+
+    // Keep the bits starting right before the next candidate offset so
+    // that it can be checked once more data is available.
+    chunk = chunk.subslice(std::min(offset - 1, chunk.size()));
+
+    return false;
+}
+
 }  // namespace detail
 }  // namespace v1
 }  // namespace mlio
@@ -36,6 +36,9 @@ public:
 private:
     std::optional<record>
     decode_record(memory_slice &chunk, bool ignore_leftover) final;
+
+    bool
+    skip_to_next_record(memory_slice &chunk, bool ignore_leftover) final;
 };
 
 }  // namespace detail
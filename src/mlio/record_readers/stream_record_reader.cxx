@@ -15,9 +15,11 @@
 
 #include "mlio/record_readers/stream_record_reader.h"
 
+#include <chrono>
 #include <optional>
 #include <utility>
 
+#include "mlio/not_supported_error.h"
 #include "mlio/record_readers/detail/chunk_reader.h"
 #include "mlio/record_readers/record.h"
 #include "mlio/streams/input_stream.h"
@@ -38,12 +40,19 @@ stream_record_reader::read_record_core()
     std::optional<record> rec{};
 
     while (true) {
+        std::size_t size = chunk_.size();
+
         rec = decode_record(chunk_, !chunk_reader_->eof());
+
+        // The decoder might consume bits such as comment lines even if
+        // it cannot decode a complete record.
+        position_ += size - chunk_.size();
+
         if (rec) {
             break;
         }
 
-        chunk_ = chunk_reader_->read_chunk(chunk_);
+        read_next_chunk();
         if (chunk_.empty()) {
             break;
         }
@@ -52,6 +61,82 @@ stream_record_reader::read_record_core()
     return rec;
 }
 
+void
+stream_record_reader::seek_core(std::size_t position)
+{
+    if (!chunk_reader_->seekable()) {
+        throw not_supported_error{"The record reader is not seekable."};
+    }
+
+    chunk_reader_->seek(position);
+
+    chunk_ = {};
+
+    position_ = position;
+}
+
+void
+stream_record_reader::seek_to_record_boundary_core(std::size_t position)
+{
+    if (position == 0) {
+        seek_core(position);
+
+        return;
+    }
+
+    // A record that begins exactly at the specified position is only
+    // recognizable by looking at the preceding byte (e.g. a new-line
+    // character); therefore we start one byte before.
+    seek_core(position - 1);
+
+    while (true) {
+        std::size_t size = chunk_.size();
+
+        bool found = skip_to_next_record(chunk_, !chunk_reader_->eof());
+
+        position_ += size - chunk_.size();
+
+        if (found) {
+            break;
+        }
+
+        read_next_chunk();
+        if (chunk_.empty()) {
+            break;
+        }
+    }
+}
+
+void
+stream_record_reader::read_next_chunk()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    chunk_ = chunk_reader_->read_chunk(chunk_);
+
+    read_time_ += std::chrono::steady_clock::now() - start;
+}
+
+bool
+stream_record_reader::skip_to_next_record(memory_slice &, bool)
+{
+    throw not_supported_error{
+        "The record reader does not support seeking to an arbitrary "
+        "position."};
+}
+
+bool
+stream_record_reader::seekable() const noexcept
+{
+    return chunk_reader_->seekable();
+}
+
+bool
+stream_record_reader::supports_zero_copy() const noexcept
+{
+    return chunk_reader_->supports_zero_copy();
+}
+
 std::size_t
 stream_record_reader::record_size_hint() const noexcept
 {
@@ -15,12 +15,14 @@
 
 #include "mlio/record_readers/text_record_reader.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "mlio/memory/memory_slice.h"
 #include "mlio/record_readers/record.h"
 #include "mlio/span.h"
 #include "mlio/streams/input_stream.h"
+#include "mlio/util/cast.h"
 
 namespace mlio {
 inline namespace v1 {
@@ -43,6 +45,27 @@ text_record_reader::decode_record(memory_slice &chunk, bool ignore_leftover)
     return {};
 }
 
+bool
+text_record_reader::skip_to_next_record(memory_slice &chunk,
+                                        bool ignore_leftover)
+{
+    auto chrs = as_span<char const>(chunk);
+
+    // A record begins right after a new-line character; since the
+    // chunk starts one byte before the requested position, a new-line
+    // at the very beginning still marks a boundary within the range.
+    auto pos = std::find(chrs.begin(), chrs.end(), '\n');
+    if (pos != chrs.end()) {
+        chunk = chunk.subslice(sizeof(char) * as_size(pos - chrs.begin() + 1));
+
+        return true;
+    }
+
+    chunk = {};
+
+    return !ignore_leftover;
+}
+
 bool
 text_record_reader::skip_utf8_bom(memory_slice &chunk,
                                   bool ignore_leftover) noexcept
@@ -26,16 +26,20 @@
 #include <fmt/ostream.h>
 #include <tbb/tbb.h>
 
+#include "mlio/array_pool.h"
+#include "mlio/buffer_provider.h"
 #include "mlio/coo_tensor_builder.h"
 #include "mlio/cpu_array.h"
 #include "mlio/data_reader_error.h"
 #include "mlio/detail/protobuf/recordio_protobuf.pb.h"
+#include "mlio/example.h"
+#include "mlio/example_decoder.h"
 #include "mlio/instance.h"
 #include "mlio/instance_batch.h"
-#include "mlio/logger.h"
 #include "mlio/not_supported_error.h"
 #include "mlio/record_readers/recordio_record_reader.h"
 #include "mlio/tensor.h"
+#include "mlio/tensor_rows.h"
 #include "mlio/util/cast.h"
 
 using aialgs::data::Record;
@@ -59,8 +63,16 @@ thread_local Record proto_msg_{};  // NOLINT(cert-err58-cpp)
 
 class recordio_protobuf_reader::decoder_state {
 public:
-    explicit decoder_state(recordio_protobuf_reader const &reader,
-                           std::size_t batch_size);
+    explicit decoder_state(schema const &shm,
+                           std::size_t batch_size,
+                           recordio_protobuf_reader const *rdr,
+                           detail::array_pool *pool = nullptr);
+
+public:
+    // Builds the tensors of the sparse features once all instances of
+    // the batch have been decoded.
+    void
+    build_sparse_tensors();
 
 private:
     void
@@ -75,24 +87,50 @@ private:
 public:
     std::vector<intrusive_ptr<tensor>> tensors;
     std::vector<std::unique_ptr<coo_tensor_builder>> coo_tensor_builders;
-    bad_batch_handling bbh;
+    // The reader to which the bad records are reported, if any.
+    recordio_protobuf_reader const *reader;
+
+private:
+    detail::array_pool *pool_;
+    buffer_provider *buffer_prv_{};
 };
 
 class recordio_protobuf_reader::decoder {
 public:
-    explicit decoder(recordio_protobuf_reader const &reader,
-                     decoder_state &state)
-        : reader_{&reader}, state_{&state}
+    explicit decoder(schema const &shm, decoder_state &state)
+        : schema_{&shm}, state_{&state}
     {}
 
 public:
     bool
     decode(std::size_t row_idx, instance const &ins);
 
+    // Decodes a record that has no originating instance; only valid if
+    // the state has no reader to report bad records to.
+    bool
+    decode(std::size_t row_idx, memory_span bits);
+
 private:
+    // Counts a bad record. Returns true if it should be described by a
+    // call to report().
+    bool
+    should_report() const noexcept
+    {
+        return state_->reader != nullptr && state_->reader->add_bad_instance();
+    }
+
+    void
+    report(std::string msg) const
+    {
+        state_->reader->report_bad_instance(std::move(msg));
+    }
+
     Record const *
     parse_proto(instance const &ins) const;
 
+    bool
+    decode_record(Record const &proto_msg);
+
     bool
     decode_feature(std::string const &name, Value const &value);
 
@@ -117,7 +155,7 @@ private:
     append_to_builder(ProtobufTensor const &tsr) const;
 
 private:
-    recordio_protobuf_reader const *reader_;
+    schema const *schema_;
     decoder_state *state_;
     instance const *instance_{};
     std::size_t row_idx_{};
@@ -125,9 +163,41 @@ private:
     feature_desc const *ftr_dsc_{};
 };
 
+class recordio_protobuf_reader::sync_decoder final : public example_decoder {
+public:
+    explicit sync_decoder(intrusive_ptr<schema> shm, std::size_t batch_size)
+        : schema_{std::move(shm)}
+        , batch_size_{batch_size}
+        , pool_{make_intrusive<detail::array_pool>()}
+    {}
+
+public:
+    decode_result
+    decode(stdx::span<memory_span const> records) const final;
+
+    schema const &
+    get_schema() const noexcept final
+    {
+        return *schema_;
+    }
+
+    std::size_t
+    batch_size() const noexcept final
+    {
+        return batch_size_;
+    }
+
+private:
+    intrusive_ptr<schema> schema_;
+    std::size_t batch_size_;
+    intrusive_ptr<detail::array_pool> pool_;
+};
+
 recordio_protobuf_reader::recordio_protobuf_reader(data_reader_params prm)
     : parallel_data_reader{std::move(prm)}
-{}
+{
+    start_eagerly();
+}
 
 recordio_protobuf_reader::~recordio_protobuf_reader()
 {
@@ -146,7 +216,7 @@ recordio_protobuf_reader::make_record_reader(data_store const &ds)
 void
 recordio_protobuf_reader::infer_schema(instance const &ins)
 {
-    Record const *proto_msg = parse_proto(ins);
+    Record const *proto_msg = parse_proto(ins.bits());
     if (proto_msg == nullptr) {
         throw schema_error{fmt::format(
             "The record {1:n} in the data store {0} contains a corrupt "
@@ -294,7 +364,7 @@ recordio_protobuf_reader::copy_shape(instance const &ins,
 intrusive_ptr<example>
 recordio_protobuf_reader::decode(instance_batch const &batch) const
 {
-    decoder_state dec_state{*this, batch.size()};
+    decoder_state dec_state{*schema_, batch.size(), this};
 
     std::atomic_bool skip_batch{};
 
@@ -313,29 +383,26 @@ recordio_protobuf_reader::decode(instance_batch const &batch) const
 
     auto worker = [this, &dec_state, &skip_batch](auto &sub_range) {
         for (auto row_zip : sub_range) {
-            decoder dc{*this, dec_state};
-            // If we failed to decode the instance, we can terminate the
-            // task early and skip this batch.
+            decoder dc{*schema_, dec_state};
+            // If we failed to decode the instance, the batch is skipped;
+            // the remaining instances are still decoded so that every
+            // bad record gets counted.
             if (!dc.decode(std::get<0>(row_zip), std::get<1>(row_zip))) {
                 skip_batch = true;
-
-                return;
             }
         }
     };
 
-    constexpr std::size_t cut_off = 10'000'000;
-
     bool serial =
         // If we have any sparse features, we cannot decode the batch in
         // parallel as we need to append each instance sequentially to
         // the COO tensor.
         has_sparse_feature_ ||
         // If the number of values (e.g. integers, floating-points) we
-        // need to decode is below the cut-off, avoid parallel
-        // execution; otherwise the threading overhead will slow down
-        // the performance.
-        num_values_per_instance_ * num_instances < cut_off;
+        // need to decode is too small, avoid parallel execution;
+        // otherwise the threading overhead will slow down the
+        // performance.
+        !should_decode_in_parallel(num_values_per_instance_ * num_instances);
 
     if (serial) {
         worker(range);
@@ -350,48 +417,104 @@ recordio_protobuf_reader::decode(instance_batch const &batch) const
         return nullptr;
     }
 
-    auto tsr_beg = dec_state.tensors.begin();
-    auto tsr_end = dec_state.tensors.end();
+    dec_state.build_sparse_tensors();
 
-    auto bld_beg = dec_state.coo_tensor_builders.begin();
-    auto bld_end = dec_state.coo_tensor_builders.end();
+    auto exm = make_intrusive<example>(schema_, std::move(dec_state.tensors));
 
-    auto ftr_beg = tbb::make_zip_iterator(tsr_beg, bld_beg);
-    auto ftr_end = tbb::make_zip_iterator(tsr_end, bld_end);
+    exm->padding = batch.size() - num_instances;
 
-    for (auto ftr_pos = ftr_beg; ftr_pos < ftr_end; ++ftr_pos) {
-        intrusive_ptr<tensor> &tsr = std::get<0>(*ftr_pos);
+    return exm;
+}
 
-        // If no tensor exists at the specified location, it means the
-        // corresponding feature was sparse. We should build its tensor
-        // as we processed the whole batch now.
-        if (tsr == nullptr) {
-            tsr = std::get<1>(*ftr_pos)->build();
+intrusive_ptr<example_decoder>
+recordio_protobuf_reader::make_decoder()
+{
+    peek_example();
+
+    if (schema_ == nullptr) {
+        throw schema_error{
+            "The schema of the dataset cannot be inferred as the dataset "
+            "has no records."};
+    }
+
+    return make_intrusive<sync_decoder>(schema_, params().batch_size);
+}
+
+decode_result
+recordio_protobuf_reader::sync_decoder::decode(
+    stdx::span<memory_span const> records) const
+{
+    std::size_t num_records = records.size();
+
+    // Bad records are reported through the result; no error message is
+    // ever formatted.
+    decoder_state dec_state{*schema_, num_records, nullptr, pool_.get()};
+
+    for (std::size_t row_idx = 0; row_idx < num_records; row_idx++) {
+        decoder dc{*schema_, dec_state};
+        if (!dc.decode(row_idx, records[row_idx])) {
+            return {decode_status::invalid_record, nullptr, row_idx};
         }
     }
 
-    auto exm = make_intrusive<example>(schema_, std::move(dec_state.tensors));
+    dec_state.build_sparse_tensors();
 
-    exm->padding = batch.size() - num_instances;
+    intrusive_ptr<schema> shm = schema_;
+    if (num_records != batch_size_) {
+        shm = detail::make_batch_schema(*schema_, num_records);
+    }
 
-    return exm;
+    auto exm = make_intrusive<example>(std::move(shm),
+                                       std::move(dec_state.tensors));
+
+    return {decode_status::ok, std::move(exm), 0};
 }
 
 Record const *
-recordio_protobuf_reader::parse_proto(instance const &ins)
+recordio_protobuf_reader::parse_proto(memory_span bits)
 {
     bool parsed = detail::proto_msg_.ParseFromArray(
-        ins.bits().data(), static_cast<int>(ins.bits().size()));
+        bits.data(), static_cast<int>(bits.size()));
 
     return parsed ? &detail::proto_msg_ : nullptr;
 }
 
 recordio_protobuf_reader::decoder_state::decoder_state(
-    recordio_protobuf_reader const &reader, std::size_t batch_size)
+    schema const &shm,
+    std::size_t batch_size,
+    recordio_protobuf_reader const *rdr,
+    detail::array_pool *pool)
+    : reader{rdr}, pool_{pool}
 {
-    init_state(*reader.schema_, batch_size);
+    if (reader != nullptr) {
+        buffer_prv_ = reader->params().output_buffers.get();
+    }
 
-    bbh = reader.effective_bad_batch_handling();
+    init_state(shm, batch_size);
+}
+
+void
+recordio_protobuf_reader::decoder_state::build_sparse_tensors()
+{
+    auto tsr_beg = tensors.begin();
+    auto tsr_end = tensors.end();
+
+    auto bld_beg = coo_tensor_builders.begin();
+    auto bld_end = coo_tensor_builders.end();
+
+    auto ftr_beg = tbb::make_zip_iterator(tsr_beg, bld_beg);
+    auto ftr_end = tbb::make_zip_iterator(tsr_end, bld_end);
+
+    for (auto ftr_pos = ftr_beg; ftr_pos < ftr_end; ++ftr_pos) {
+        intrusive_ptr<tensor> &tsr = std::get<0>(*ftr_pos);
+
+        // If no tensor exists at the specified location, it means the
+        // corresponding feature was sparse. We should build its tensor
+        // as we processed the whole batch now.
+        if (tsr == nullptr) {
+            tsr = std::get<1>(*ftr_pos)->build();
+        }
+    }
 }
 
 void
@@ -418,8 +541,18 @@ recordio_protobuf_reader::decoder_state::init_tensor(feature_desc const &desc,
 {
     std::size_t data_size = batch_size * as_size(desc.strides()[0]);
 
-    std::unique_ptr<device_array> arr =
-        make_cpu_array(desc.dtype(), data_size);
+    std::unique_ptr<device_array> arr{};
+    if (buffer_prv_ != nullptr) {
+        arr = buffer_prv_->acquire_array(desc, batch_size);
+    }
+    if (arr == nullptr) {
+        if (pool_ == nullptr) {
+            arr = make_cpu_array(desc.dtype(), data_size);
+        }
+        else {
+            arr = pool_->make_array(desc.dtype(), data_size);
+        }
+    }
 
     size_vector shape = desc.shape();
     shape[0] = batch_size;
@@ -455,16 +588,36 @@ recordio_protobuf_reader::decoder::decode(std::size_t row_idx,
         return false;
     }
 
+    return decode_record(*proto_msg);
+}
+
+bool
+recordio_protobuf_reader::decoder::decode(std::size_t row_idx,
+                                          memory_span bits)
+{
+    row_idx_ = row_idx;
+
+    Record const *proto_msg = recordio_protobuf_reader::parse_proto(bits);
+    if (proto_msg == nullptr) {
+        return false;
+    }
+
+    return decode_record(*proto_msg);
+}
+
+bool
+recordio_protobuf_reader::decoder::decode_record(Record const &proto_msg)
+{
     std::size_t num_features_read = 0;
 
-    for (auto &[label, value] : proto_msg->label()) {
+    for (auto &[label, value] : proto_msg.label()) {
         if (!decode_feature("label_" + label, value)) {
             return false;
         }
 
         num_features_read++;
     }
-    for (auto &[label, value] : proto_msg->features()) {
+    for (auto &[label, value] : proto_msg.features()) {
         if (!decode_feature(label, value)) {
             return false;
         }
@@ -474,24 +627,20 @@ recordio_protobuf_reader::decoder::decode(std::size_t row_idx,
 
     // Make sure that we read all the features for which we
     // have a descriptor in the schema.
-    if (num_features_read == reader_->schema_->descriptors().size()) {
+    if (num_features_read == schema_->descriptors().size()) {
         return true;
     }
 
-    if (state_->bbh != bad_batch_handling::skip) {
+    if (should_report()) {
         auto msg = fmt::format(
             "The record {1:n} in the data store {0} has {2:n} feature(s) "
             "while the expected number of features is {3:n}.",
             instance_->get_data_store(),
             instance_->index() + 1,
             num_features_read,
-            reader_->schema_->descriptors().size());
-
-        if (state_->bbh == bad_batch_handling::error) {
-            throw invalid_instance_error{msg};
-        }
+            schema_->descriptors().size());
 
-        logger::warn(msg);
+        report(std::move(msg));
     }
 
     return false;
@@ -500,23 +649,20 @@ recordio_protobuf_reader::decoder::decode(std::size_t row_idx,
 Record const *
 recordio_protobuf_reader::decoder::parse_proto(instance const &ins) const
 {
-    Record const *proto_msg = recordio_protobuf_reader::parse_proto(ins);
+    Record const *proto_msg =
+        recordio_protobuf_reader::parse_proto(ins.bits());
     if (proto_msg != nullptr) {
         return proto_msg;
     }
 
-    if (state_->bbh != bad_batch_handling::skip) {
+    if (should_report()) {
         auto msg = fmt::format(
             "The record {1:n} in the data store {0} contains a corrupt "
             "RecordIO-protobuf message.",
             instance_->get_data_store(),
             instance_->index() + 1);
 
-        if (state_->bbh == bad_batch_handling::error) {
-            throw invalid_instance_error{msg};
-        }
-
-        logger::warn(msg);
+        report(std::move(msg));
     }
 
     return nullptr;
@@ -526,9 +672,9 @@ bool
 recordio_protobuf_reader::decoder::decode_feature(std::string const &name,
                                                   Value const &value)
 {
-    std::optional<std::size_t> idx = reader_->schema_->get_index(name);
+    std::optional<std::size_t> idx = schema_->get_index(name);
     if (idx == std::nullopt) {
-        if (state_->bbh != bad_batch_handling::skip) {
+        if (should_report()) {
             auto msg = fmt::format(
                 "The record {1:n} in the data store {0} has an unknown "
                 "feature named '{2}'.",
@@ -536,11 +682,7 @@ recordio_protobuf_reader::decoder::decode_feature(std::string const &name,
                 instance_->index() + 1,
                 name);
 
-            if (state_->bbh == bad_batch_handling::error) {
-                throw invalid_instance_error{msg};
-            }
-
-            logger::warn(msg);
+            report(std::move(msg));
         }
 
         return false;
@@ -548,7 +690,7 @@ recordio_protobuf_reader::decoder::decode_feature(std::string const &name,
 
     ftr_idx_ = *idx;
 
-    ftr_dsc_ = &reader_->schema_->descriptors()[ftr_idx_];
+    ftr_dsc_ = &schema_->descriptors()[ftr_idx_];
 
     switch (value.value_case()) {
     case Value::ValueCase::kFloat32Tensor:
@@ -565,7 +707,7 @@ recordio_protobuf_reader::decoder::decode_feature(std::string const &name,
         break;
     }
 
-    if (state_->bbh != bad_batch_handling::skip) {
+    if (should_report()) {
         auto msg = fmt::format(
             "The feature '{2}' of the record {1:n} in the data store {0} has "
             "an unexpected data type.",
@@ -573,11 +715,7 @@ recordio_protobuf_reader::decoder::decode_feature(std::string const &name,
             instance_->index() + 1,
             ftr_dsc_->name());
 
-        if (state_->bbh == bad_batch_handling::error) {
-            throw invalid_instance_error{msg};
-        }
-
-        logger::warn(msg);
+        report(std::move(msg));
     }
 
     return false;
@@ -588,7 +726,7 @@ bool
 recordio_protobuf_reader::decoder::decode_feature(ProtobufTensor const &tsr)
 {
     if (ftr_dsc_->dtype() != dt) {
-        if (state_->bbh != bad_batch_handling::skip) {
+        if (should_report()) {
             auto msg = fmt::format(
                 "The feature '{2}' of the record {1:n} in the data store {0} "
                 "has the data type {3}, while the expected data type is {4}.",
@@ -598,18 +736,14 @@ recordio_protobuf_reader::decoder::decode_feature(ProtobufTensor const &tsr)
                 dt,
                 ftr_dsc_->dtype());
 
-            if (state_->bbh == bad_batch_handling::error) {
-                throw invalid_instance_error{msg};
-            }
-
-            logger::warn(msg);
+            report(std::move(msg));
         }
 
         return false;
     }
 
     if (is_sparse(tsr) != ftr_dsc_->sparse()) {
-        if (state_->bbh != bad_batch_handling::skip) {
+        if (should_report()) {
             char const *ft;
             if (ftr_dsc_->sparse()) {
                 ft =
@@ -626,18 +760,14 @@ recordio_protobuf_reader::decoder::decode_feature(ProtobufTensor const &tsr)
                                    instance_->index() + 1,
                                    ftr_dsc_->name());
 
-            if (state_->bbh == bad_batch_handling::error) {
-                throw invalid_instance_error{msg};
-            }
-
-            logger::warn(msg);
+            report(std::move(msg));
         }
 
         return false;
     }
 
     if (!shape_equals(tsr)) {
-        if (state_->bbh != bad_batch_handling::skip) {
+        if (should_report()) {
             std::string pshp;
             if (tsr.shape().empty()) {
                 pshp = fmt::to_string(tsr.values_size());
@@ -657,11 +787,7 @@ recordio_protobuf_reader::decoder::decode_feature(ProtobufTensor const &tsr)
                 pshp,
                 fmt::join(shape.begin() + 1, shape.end(), ", "));
 
-            if (state_->bbh == bad_batch_handling::error) {
-                throw invalid_instance_error{msg};
-            }
-
-            logger::warn(msg);
+            report(std::move(msg));
         }
 
         return false;
@@ -732,7 +858,7 @@ recordio_protobuf_reader::decoder::copy_to_tensor(
     std::ptrdiff_t num_values = ftr_dsc_->strides()[0];
 
     if (num_values != tsr.values_size()) {
-        if (state_->bbh != bad_batch_handling::skip) {
+        if (should_report()) {
             size_vector const &shape = ftr_dsc_->shape();
 
             auto msg = fmt::format(
@@ -744,11 +870,7 @@ recordio_protobuf_reader::decoder::copy_to_tensor(
                 tsr.values_size(),
                 fmt::join(shape.begin() + 1, shape.end(), ", "));
 
-            if (state_->bbh == bad_batch_handling::error) {
-                throw invalid_instance_error{msg};
-            }
-
-            logger::warn(msg);
+            report(std::move(msg));
         }
 
         return false;
@@ -771,7 +893,7 @@ recordio_protobuf_reader::decoder::append_to_builder(
     ProtobufTensor const &tsr) const
 {
     if (tsr.keys_size() != tsr.values_size()) {
-        if (state_->bbh != bad_batch_handling::skip) {
+        if (should_report()) {
             auto msg = fmt::format(
                 "The sparse feature '{2}' of the record {1:n} in the data "
                 "store {0} has {3:n} key(s) but {4:n} value(s).",
@@ -781,11 +903,7 @@ recordio_protobuf_reader::decoder::append_to_builder(
                 tsr.keys_size(),
                 tsr.values_size());
 
-            if (state_->bbh == bad_batch_handling::error) {
-                throw invalid_instance_error{msg};
-            }
-
-            logger::warn(msg);
+            report(std::move(msg));
         }
 
         return false;
@@ -798,7 +916,7 @@ recordio_protobuf_reader::decoder::append_to_builder(
         return true;
     }
 
-    if (state_->bbh != bad_batch_handling::skip) {
+    if (should_report()) {
         auto msg = fmt::format(
             "The sparse feature '{2}' of the record {1:n} in the data "
             "store {0} has one or more invalid keys.",
@@ -806,11 +924,7 @@ recordio_protobuf_reader::decoder::append_to_builder(
             instance_->index() + 1,
             ftr_dsc_->name());
 
-        if (state_->bbh == bad_batch_handling::error) {
-            throw invalid_instance_error{msg};
-        }
-
-        logger::warn(msg);
+        report(std::move(msg));
     }
 
     return false;
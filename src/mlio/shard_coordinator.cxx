@@ -0,0 +1,103 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/shard_coordinator.h"
+
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace mlio {
+inline namespace v1 {
+
+shard_coordinator::~shard_coordinator() = default;
+
+local_shard_coordinator::~local_shard_coordinator() = default;
+
+std::optional<std::size_t>
+local_shard_coordinator::acquire_work_item(std::size_t epoch,
+                                           std::size_t num_items)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    // The first reader that reaches an epoch determines the number of
+    // work items of the epoch.
+    auto [pos, inserted] = epochs_.try_emplace(epoch);
+
+    epoch_state &st = pos->second;
+    if (inserted) {
+        st.num_items = num_items;
+
+        st.is_completed.resize(num_items);
+    }
+    else if (st.num_items != num_items) {
+        throw std::invalid_argument{fmt::format(
+            "The dataset has {0:n} work items while the other readers of "
+            "the coordinator have {1:n} work items.",
+            num_items,
+            st.num_items)};
+    }
+
+    if (st.next_item_idx == st.num_items) {
+        return {};
+    }
+
+    return st.next_item_idx++;
+}
+
+void
+local_shard_coordinator::complete_work_item(std::size_t epoch,
+                                            std::size_t item_idx)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    auto pos = epochs_.find(epoch);
+    if (pos == epochs_.end() || item_idx >= pos->second.next_item_idx) {
+        throw std::invalid_argument{fmt::format(
+            "The work item {0:n} of the epoch {1:n} has not been handed out.",
+            item_idx,
+            epoch)};
+    }
+
+    epoch_state &st = pos->second;
+
+    // A client that retries a request after a reconnect might complete
+    // the same work item twice.
+    if (st.is_completed[item_idx]) {
+        return;
+    }
+
+    st.is_completed[item_idx] = true;
+
+    st.num_completed_items++;
+}
+
+bool
+local_shard_coordinator::is_epoch_complete(std::size_t epoch) const
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    auto pos = epochs_.find(epoch);
+    if (pos == epochs_.end()) {
+        return false;
+    }
+
+    epoch_state const &st = pos->second;
+
+    return st.num_completed_items == st.num_items;
+}
+
+}  // namespace v1
+}  // namespace mlio
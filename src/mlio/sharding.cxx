@@ -0,0 +1,326 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/sharding.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include "mlio/data_reader.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/record_readers/record_index.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+std::vector<data_store_range>
+make_whole_ranges(data_reader_params const &prm)
+{
+    std::vector<data_store_range> ranges{};
+
+    ranges.reserve(prm.dataset.size());
+
+    for (std::size_t idx = 0; idx < prm.dataset.size(); idx++) {
+        ranges.push_back(data_store_range{idx});
+    }
+
+    return ranges;
+}
+
+std::vector<std::size_t>
+get_store_sizes(data_reader_params const &prm)
+{
+    std::vector<std::optional<std::size_t>> hints{};
+
+    hints.reserve(prm.dataset.size());
+
+    std::size_t total_size = 0;
+    std::size_t num_known = 0;
+
+    for (auto const &ds : prm.dataset) {
+        auto &hint = hints.emplace_back(ds->size_hint());
+        if (hint) {
+            total_size += *hint;
+
+            num_known++;
+        }
+    }
+
+    // Data stores with an unknown size are treated as average-sized.
+    std::size_t default_size = 1;
+    if (num_known > 0) {
+        default_size = std::max(total_size / num_known, std::size_t{1});
+    }
+
+    std::vector<std::size_t> sizes{};
+
+    sizes.reserve(hints.size());
+
+    for (auto const &hint : hints) {
+        sizes.push_back(hint.value_or(default_size));
+    }
+
+    return sizes;
+}
+
+std::vector<data_store_range>
+make_data_store_ranges(data_reader_params const &prm)
+{
+    std::vector<std::size_t> sizes = get_store_sizes(prm);
+
+    std::vector<std::size_t> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    // Assign the largest data store to the shard with the smallest total
+    // size first. The assignment is deterministic, so all shards agree
+    // on it as long as they see the same dataset.
+    std::stable_sort(order.begin(), order.end(), [&sizes](auto a, auto b) {
+        return sizes[a] > sizes[b];
+    });
+
+    std::vector<std::size_t> shard_sizes(prm.num_shards);
+
+    std::vector<data_store_range> ranges{};
+
+    for (std::size_t idx : order) {
+        auto pos = std::min_element(shard_sizes.begin(), shard_sizes.end());
+
+        *pos += sizes[idx];
+
+        if (static_cast<std::size_t>(pos - shard_sizes.begin()) ==
+            prm.shard_index) {
+            ranges.push_back(data_store_range{idx});
+        }
+    }
+
+    // Preserve the original order of the dataset.
+    std::sort(ranges.begin(), ranges.end(), [](auto const &a, auto const &b) {
+        return a.store_idx < b.store_idx;
+    });
+
+    return ranges;
+}
+
+inline std::size_t
+get_split_point(std::size_t size, std::size_t shard_idx, std::size_t n)
+{
+    return (size / n) * shard_idx + (size % n) * shard_idx / n;
+}
+
+std::vector<data_store_range>
+make_byte_ranges(data_reader_params const &prm)
+{
+    std::size_t n = prm.num_shards;
+
+    std::vector<data_store_range> ranges{};
+
+    for (std::size_t idx = 0; idx < prm.dataset.size(); idx++) {
+        std::optional<std::size_t> size = prm.dataset[idx]->size_hint();
+
+        // If we cannot split the data store, we fall back to assigning
+        // it as a whole.
+        if (size == std::nullopt || *size == 0) {
+            if (idx % n == prm.shard_index) {
+                ranges.push_back(data_store_range{idx});
+            }
+            continue;
+        }
+
+        std::size_t begin = get_split_point(*size, prm.shard_index, n);
+        std::size_t end = get_split_point(*size, prm.shard_index + 1, n);
+
+        if (begin == end) {
+            continue;
+        }
+
+        // The last shard reads till the end of the data store in case
+        // its size hint is not accurate (e.g. compressed or growing).
+        if (prm.shard_index == n - 1) {
+            ranges.push_back(data_store_range{idx, begin});
+        }
+        else {
+            ranges.push_back(data_store_range{idx, begin, end});
+        }
+    }
+
+    return ranges;
+}
+
+// Splits the data stores with a known size into ranges of the work item
+// size specified in the parameters. The readers sharing a coordinator
+// compute the same list, so only the indices of the work items have to
+// be exchanged.
+std::vector<data_store_range>
+make_work_items(data_reader_params const &prm)
+{
+    std::size_t item_size = prm.work_item_size;
+    if (item_size == 0) {
+        return make_whole_ranges(prm);
+    }
+
+    std::vector<data_store_range> items{};
+
+    for (std::size_t idx = 0; idx < prm.dataset.size(); idx++) {
+        std::optional<std::size_t> size = prm.dataset[idx]->size_hint();
+        if (size == std::nullopt || *size <= item_size) {
+            items.push_back(data_store_range{idx});
+
+            continue;
+        }
+
+        for (std::size_t begin = 0; begin < *size; begin += item_size) {
+            // The last range reads till the end of the data store in
+            // case its size hint is not accurate.
+            if (*size - begin <= item_size) {
+                items.push_back(data_store_range{idx, begin});
+            }
+            else {
+                items.push_back(
+                    data_store_range{idx, begin, begin + item_size});
+            }
+        }
+    }
+
+    return items;
+}
+
+}  // namespace
+
+std::vector<data_store_range>
+make_shard_ranges(data_reader_params const &prm)
+{
+    if (prm.coordinator != nullptr) {
+        return make_work_items(prm);
+    }
+
+    if (prm.num_shards <= 1) {
+        return make_whole_ranges(prm);
+    }
+
+    switch (prm.shard_strategy) {
+    case sharding_strategy::instances:
+        return make_whole_ranges(prm);
+    case sharding_strategy::data_stores:
+        return make_data_store_ranges(prm);
+    case sharding_strategy::byte_ranges:
+        return make_byte_ranges(prm);
+    }
+
+    return make_whole_ranges(prm);
+}
+
+std::vector<data_store_range>
+split_into_record_blocks(data_reader_params const &prm,
+                         std::vector<data_store_range> const &ranges,
+                         std::size_t block_size)
+{
+    std::vector<data_store_range> blocks{};
+
+    blocks.reserve(ranges.size());
+
+    for (data_store_range const &range : ranges) {
+        if (range.begin != 0 || range.end != std::nullopt) {
+            blocks.push_back(range);
+
+            continue;
+        }
+
+        std::optional<record_index> idx =
+            prm.dataset[range.store_idx]->load_record_index();
+        if (idx == std::nullopt || idx->positions().empty()) {
+            blocks.push_back(range);
+
+            continue;
+        }
+
+        std::vector<std::size_t> const &positions = idx->positions();
+
+        // A block has to start at an indexed record; round the block
+        // size up to a multiple of the index stride.
+        std::size_t step = (block_size + idx->stride() - 1) / idx->stride();
+
+        for (std::size_t i = 0; i < positions.size(); i += step) {
+            data_store_range &block = blocks.emplace_back();
+
+            block.store_idx = range.store_idx;
+            block.begin = positions[i];
+
+            if (i + step < positions.size()) {
+                block.end = positions[i + step];
+            }
+
+            block.first_record_idx = i * idx->stride();
+            block.at_record_boundary = true;
+        }
+    }
+
+    return blocks;
+}
+
+void
+shuffle_ranges(std::vector<data_store_range> &ranges,
+               std::mt19937_64 &mt,
+               bool shuffle_data_stores,
+               bool shuffle_blocks)
+{
+    // Find the adjacent ranges that belong to the same data store.
+    std::vector<std::pair<std::size_t, std::size_t>> groups{};
+
+    for (std::size_t i = 0; i < ranges.size();) {
+        std::size_t j = i + 1;
+        while (j < ranges.size() &&
+               ranges[j].store_idx == ranges[i].store_idx) {
+            j++;
+        }
+
+        groups.emplace_back(i, j);
+
+        i = j;
+    }
+
+    if (shuffle_blocks) {
+        for (auto [first, last] : groups) {
+            std::shuffle(ranges.begin() + as_ssize(first),
+                         ranges.begin() + as_ssize(last),
+                         mt);
+        }
+    }
+
+    if (!shuffle_data_stores || groups.size() < 2) {
+        return;
+    }
+
+    std::shuffle(groups.begin(), groups.end(), mt);
+
+    std::vector<data_store_range> shuffled{};
+
+    shuffled.reserve(ranges.size());
+
+    for (auto [first, last] : groups) {
+        shuffled.insert(shuffled.end(),
+                        ranges.begin() + as_ssize(first),
+                        ranges.begin() + as_ssize(last));
+    }
+
+    ranges = std::move(shuffled);
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
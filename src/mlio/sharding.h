@@ -0,0 +1,68 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "mlio/fwd.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+// Represents the part of a data store that belongs to a shard. Only the
+// records that begin within [begin, end) should be read.
+struct data_store_range {
+    std::size_t store_idx{};
+    std::size_t begin{};
+    std::optional<std::size_t> end{};
+    // The index of the first record of the range within its data store
+    // if known; otherwise zero.
+    std::size_t first_record_idx{};
+    // A boolean value indicating whether begin is the exact position of
+    // a record rather than an arbitrary byte position.
+    bool at_record_boundary{};
+};
+
+// Returns the data store ranges of the dataset that should be read by
+// the shard specified in the parameters. If the dataset is sharded by a
+// coordinator, returns all work items of the dataset instead.
+std::vector<data_store_range>
+make_shard_ranges(data_reader_params const &prm);
+
+// Splits the ranges that span a whole data store having a record index
+// into blocks of at least the specified number of records. The blocks
+// of a data store are adjacent in the returned list.
+std::vector<data_store_range>
+split_into_record_blocks(data_reader_params const &prm,
+                         std::vector<data_store_range> const &ranges,
+                         std::size_t block_size);
+
+// Permutes the order of the data stores and, if requested, the order of
+// the blocks within each data store while keeping the blocks of a data
+// store adjacent.
+void
+shuffle_ranges(std::vector<data_store_range> &ranges,
+               std::mt19937_64 &mt,
+               bool shuffle_data_stores,
+               bool shuffle_blocks);
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
@@ -16,26 +16,60 @@
 #include "mlio/shuffled_instance_reader.h"
 
 #include <algorithm>
+#include <cstring>
 #include <limits>
+#include <numeric>
+#include <stdexcept>
 #include <utility>
 
 #include "mlio/data_reader.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/reader_state.h"
+#include "mlio/util/cast.h"
 
 namespace mlio {
 inline namespace v1 {
 namespace detail {
+namespace {
+
+// Only the blocks allocated by the record readers pin memory that the
+// buffer could give back. The other blocks, such as the mapping of a
+// memory-mapped file, are owned by their data stores; relocating their
+// payloads would only add copies.
+bool
+is_reader_allocated(memory_block const *blk) noexcept
+{
+    return dynamic_cast<mutable_memory_block const *>(blk) != nullptr;
+}
+
+}  // namespace
 
 shuffled_instance_reader::shuffled_instance_reader(
-    data_reader_params const &prm, std::unique_ptr<instance_reader> &&inner)
+    data_reader_params const &prm,
+    std::unique_ptr<default_instance_reader> &&inner)
     : params_{&prm}
     , inner_{std::move(inner)}
     , shuffle_window_{params_->shuffle_window}
+    , shuffle_window_bytes_{params_->shuffle_window_bytes}
     , dist_{0, shuffle_window_ - 1}
 {
-    if (shuffle_window_ == 1) {
+    // If the window is sized in bytes, the number of buffered instances
+    // is only bounded by their total payload size.
+    if (shuffle_window_bytes_ != std::nullopt) {
+        if (*shuffle_window_bytes_ == 0) {
+            throw std::invalid_argument{
+                "The shuffle window size in bytes must be greater than "
+                "zero."};
+        }
+        shuffle_window_ = std::numeric_limits<std::size_t>::max();
+    }
+    else if (shuffle_window_ == 1) {
         return;
     }
-    if (shuffle_window_ == 0) {
+    else if (shuffle_window_ == 0) {
         shuffle_window_ = std::numeric_limits<std::size_t>::max();
     }
     else {
@@ -65,44 +99,238 @@ shuffled_instance_reader::read_instance_core()
         return pop_random_instance_from_buffer();
     }
 
-    instance ins = std::move(buffer_.back());
-
-    buffer_.pop_back();
-
-    return std::move(ins);
+    return remove_from_buffer(buffer_.size() - 1);
 }
 
 void
 shuffled_instance_reader::buffer_instances()
 {
-    while (inner_has_instances_ && buffer_.size() < shuffle_window_) {
+    while (inner_has_instances_ && !is_buffer_full()) {
         std::optional<instance> ins = inner_->read_instance();
         if (ins == std::nullopt) {
             inner_has_instances_ = false;
 
-            std::shuffle(buffer_.begin(), buffer_.end(), mt_);
+            shuffle_buffer();
+
+            rebase_log();
 
             break;
         }
 
+        std::optional<instance_location> loc{};
+        if (params_->enable_checkpointing) {
+            loc = inner_->last_instance_location();
+
+            locations_.emplace_back(loc);
+        }
+
+        add_to_usage(*ins);
+
+        std::size_t instance_idx = ins->index();
+
         buffer_.emplace_back(std::move(*ins));
+
+        log_change(buffer_change{{}, buffer_entry{loc, instance_idx}});
+    }
+
+    compact_buffer_if_needed();
+}
+
+void
+shuffled_instance_reader::shuffle_buffer()
+{
+    if (locations_.empty()) {
+        std::shuffle(buffer_.begin(), buffer_.end(), mt_);
+
+        return;
+    }
+
+    // Shuffling the indices consumes the same random numbers as
+    // shuffling the buffer itself, so the order does not depend on
+    // whether checkpointing is enabled.
+    std::vector<std::size_t> order(buffer_.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    std::shuffle(order.begin(), order.end(), mt_);
+
+    std::vector<instance> buffer{};
+    buffer.reserve(buffer_.size());
+
+    std::vector<std::optional<instance_location>> locations{};
+    locations.reserve(locations_.size());
+
+    for (std::size_t idx : order) {
+        buffer.emplace_back(std::move(buffer_[idx]));
+
+        locations.emplace_back(locations_[idx]);
+    }
+
+    buffer_ = std::move(buffer);
+
+    locations_ = std::move(locations);
+}
+
+bool
+shuffled_instance_reader::is_buffer_full() const noexcept
+{
+    if (shuffle_window_bytes_ != std::nullopt) {
+        return buffer_num_bytes_ >= *shuffle_window_bytes_;
     }
+    return buffer_.size() >= shuffle_window_;
 }
 
 std::optional<instance>
 shuffled_instance_reader::pop_random_instance_from_buffer()
 {
-    std::size_t random_idx = dist_(mt_);
+    std::size_t random_idx{};
+
+    // A byte-sized window holds a varying number of instances, so the
+    // sampling range has to be recomputed on each call.
+    if (shuffle_window_bytes_ != std::nullopt) {
+        std::uniform_int_distribution<std::size_t> dist{0, buffer_.size() - 1};
+
+        random_idx = dist(mt_);
+    }
+    else {
+        random_idx = dist_(mt_);
+    }
+
+    return remove_from_buffer(random_idx);
+}
 
-    instance ins = std::move(buffer_[random_idx]);
+instance
+shuffled_instance_reader::remove_from_buffer(std::size_t idx)
+{
+    instance ins = std::move(buffer_[idx]);
 
-    if (random_idx != buffer_.size() - 1) {
-        buffer_[random_idx] = std::move(buffer_.back());
+    if (idx != buffer_.size() - 1) {
+        buffer_[idx] = std::move(buffer_.back());
     }
 
     buffer_.pop_back();
 
-    return std::move(ins);
+    if (!locations_.empty()) {
+        locations_[idx] = locations_.back();
+
+        locations_.pop_back();
+    }
+
+    log_change(buffer_change{idx, {}});
+
+    remove_from_usage(ins);
+
+    return ins;
+}
+
+void
+shuffled_instance_reader::add_to_usage(instance const &ins)
+{
+    memory_slice const &bits = ins.bits();
+
+    buffer_num_bytes_ += bits.size();
+
+    memory_block const *blk = bits.block().get();
+    if (blk == nullptr || bits.empty() || !is_reader_allocated(blk)) {
+        return;
+    }
+
+    auto [pos, inserted] = block_usage_.try_emplace(blk, 0);
+    if (inserted) {
+        pinned_num_bytes_ += blk->size();
+    }
+    pos->second += bits.size();
+}
+
+void
+shuffled_instance_reader::remove_from_usage(instance const &ins) noexcept
+{
+    memory_slice const &bits = ins.bits();
+
+    buffer_num_bytes_ -= bits.size();
+
+    memory_block const *blk = bits.block().get();
+    if (blk == nullptr || bits.empty()) {
+        return;
+    }
+
+    auto pos = block_usage_.find(blk);
+    if (pos == block_usage_.end()) {
+        return;
+    }
+
+    pos->second -= bits.size();
+    if (pos->second == 0) {
+        pinned_num_bytes_ -= blk->size();
+
+        block_usage_.erase(pos);
+    }
+}
+
+void
+shuffled_instance_reader::compact_buffer_if_needed()
+{
+    constexpr std::size_t min_pinned_num_bytes = 0x400'0000;  // 64 MiB
+
+    std::size_t max_pinned_num_bytes =
+        std::max(2 * buffer_num_bytes_, min_pinned_num_bytes);
+
+    if (pinned_num_bytes_ <= max_pinned_num_bytes) {
+        return;
+    }
+
+    // Only relocate the payloads of the blocks that are less than half
+    // used; the rest would not free enough memory to justify a copy.
+    std::size_t num_bytes_to_copy = 0;
+    for (auto pos = block_usage_.begin(); pos != block_usage_.end();) {
+        auto [blk, usage] = *pos;
+        if (usage * 2 < blk->size()) {
+            num_bytes_to_copy += usage;
+
+            pinned_num_bytes_ -= blk->size();
+
+            pos = block_usage_.erase(pos);
+        }
+        else {
+            ++pos;
+        }
+    }
+
+    if (num_bytes_to_copy == 0) {
+        return;
+    }
+
+    intrusive_ptr<mutable_memory_block> arena =
+        get_memory_allocator().allocate(num_bytes_to_copy);
+
+    memory_slice arena_slice{arena};
+
+    // The instances whose blocks are no longer tracked are the ones to
+    // relocate. Note that their blocks might get deallocated as soon as
+    // the last referencing instance is replaced.
+    std::size_t offset = 0;
+    for (instance &ins : buffer_) {
+        memory_slice const &bits = ins.bits();
+
+        memory_block const *blk = bits.block().get();
+        if (blk == nullptr || bits.empty() || block_usage_.count(blk) > 0 ||
+            !is_reader_allocated(blk)) {
+            continue;
+        }
+
+        std::size_t size = bits.size();
+
+        std::memcpy(arena->data() + offset, bits.data(), size);
+
+        ins = instance{ins.get_data_store(),
+                       ins.index(),
+                       arena_slice.subslice(offset, size)};
+
+        offset += size;
+    }
+
+    block_usage_.emplace(arena.get(), num_bytes_to_copy);
+
+    pinned_num_bytes_ += arena->size();
 }
 
 void
@@ -112,6 +340,19 @@ shuffled_instance_reader::reset() noexcept
 
     buffer_.clear();
 
+    locations_.clear();
+
+    buffer_num_bytes_ = 0;
+    pinned_num_bytes_ = 0;
+
+    block_usage_.clear();
+
+    log_ = nullptr;
+
+    pending_changes_.clear();
+
+    num_logged_changes_ = 0;
+
     inner_has_instances_ = true;
 
     // Make sure that we reset the random number generator engine to
@@ -121,6 +362,174 @@ shuffled_instance_reader::reset() noexcept
     }
 }
 
+void
+shuffled_instance_reader::save_state(state_writer &wr) const
+{
+    inner_->save_state(wr);
+
+    wr.write(seed_);
+    wr.write(mt_);
+
+    wr.write(inner_has_instances_);
+
+    // A state is captured for every batch, but only a few of them are
+    // ever requested; the buffer is serialized on request.
+    if (!pending_changes_.empty()) {
+        log_ = std::make_shared<buffer_log const>(
+            buffer_log{log_, {}, std::move(pending_changes_)});
+
+        pending_changes_.clear();
+    }
+
+    wr.write_deferred([log = log_](state_writer &w) {
+        write_buffer(w, log.get());
+    });
+}
+
+void
+shuffled_instance_reader::log_change(buffer_change &&change)
+{
+    if (!params_->enable_checkpointing) {
+        return;
+    }
+
+    constexpr std::size_t min_num_logged_changes = 1024;
+
+    pending_changes_.emplace_back(std::move(change));
+
+    num_logged_changes_++;
+
+    if (num_logged_changes_ > buffer_.size() &&
+        num_logged_changes_ > min_num_logged_changes) {
+        rebase_log();
+    }
+}
+
+void
+shuffled_instance_reader::rebase_log()
+{
+    if (!params_->enable_checkpointing) {
+        return;
+    }
+
+    std::vector<buffer_entry> entries{};
+    entries.reserve(buffer_.size());
+
+    for (std::size_t i = 0; i < buffer_.size(); i++) {
+        entries.emplace_back(buffer_entry{locations_[i], buffer_[i].index()});
+    }
+
+    log_ = std::make_shared<buffer_log const>(
+        buffer_log{nullptr, std::move(entries), {}});
+
+    pending_changes_.clear();
+
+    num_logged_changes_ = 0;
+}
+
+void
+shuffled_instance_reader::write_buffer(state_writer &wr,
+                                       buffer_log const *log)
+{
+    std::vector<buffer_log const *> segments{};
+    for (; log != nullptr; log = log->prev.get()) {
+        segments.emplace_back(log);
+    }
+
+    // Replay the chain starting from its full copy of the buffer.
+    std::vector<buffer_entry> entries{};
+    for (auto pos = segments.rbegin(); pos < segments.rend(); ++pos) {
+        if ((*pos)->prev == nullptr) {
+            entries = (*pos)->entries;
+        }
+
+        for (buffer_change const &change : (*pos)->changes) {
+            if (change.removed_idx == std::nullopt) {
+                entries.emplace_back(change.entry);
+            }
+            else {
+                entries[*change.removed_idx] = entries.back();
+
+                entries.pop_back();
+            }
+        }
+    }
+
+    // The buffered instances are saved by their location and read
+    // again when the state is restored.
+    wr.write(entries.size());
+
+    for (buffer_entry const &entry : entries) {
+        if (entry.location == std::nullopt) {
+            wr.set_error(
+                "The shuffle buffer cannot be saved since the data stores "
+                "of the dataset do not support random access.");
+
+            return;
+        }
+
+        wr.write(entry.location->store_idx);
+        wr.write(entry.location->position);
+        wr.write(entry.instance_idx);
+    }
+}
+
+void
+shuffled_instance_reader::restore_state_core(state_reader &rd)
+{
+    inner_->restore_state(rd);
+
+    std::uint_fast64_t seed = rd.read_uint64();
+
+    std::mt19937_64 mt{};
+    rd.read(mt);
+
+    bool inner_has_instances = rd.read_bool();
+
+    std::size_t num_buffered = rd.read_size();
+
+    buffer_.clear();
+
+    locations_.clear();
+
+    buffer_num_bytes_ = 0;
+    pinned_num_bytes_ = 0;
+
+    block_usage_.clear();
+
+    for (std::size_t i = 0; i < num_buffered; i++) {
+        instance_location loc{};
+
+        loc.store_idx = rd.read_size();
+        loc.position = rd.read_size();
+
+        std::size_t instance_idx = rd.read_size();
+
+        if (loc.store_idx >= params_->dataset.size()) {
+            throw std::invalid_argument{
+                "The state does not match the dataset of the reader."};
+        }
+
+        instance ins = inner_->read_instance_at(loc, instance_idx);
+
+        add_to_usage(ins);
+
+        buffer_.emplace_back(std::move(ins));
+
+        locations_.emplace_back(loc);
+    }
+
+    compact_buffer_if_needed();
+
+    rebase_log();
+
+    seed_ = seed;
+
+    mt_ = mt;
+
+    inner_has_instances_ = inner_has_instances;
+}
+
 }  // namespace detail
 }  // namespace v1
 }  // namespace mlio
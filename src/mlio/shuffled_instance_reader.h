@@ -19,11 +19,12 @@
 #include <memory>
 #include <optional>
 #include <random>
+#include <unordered_map>
 #include <vector>
 
+#include "mlio/default_instance_reader.h"
 #include "mlio/fwd.h"
 #include "mlio/instance.h"
-#include "mlio/instance_reader.h"
 #include "mlio/instance_reader_base.h"
 
 namespace mlio {
@@ -31,25 +32,85 @@ inline namespace v1 {
 namespace detail {
 
 class shuffled_instance_reader final : public instance_reader_base {
+    // The location and the index of a buffered instance.
+    struct buffer_entry {
+        std::optional<instance_location> location{};
+        std::size_t instance_idx{};
+    };
+
+    // An instance appended to, or removed from, the buffer.
+    struct buffer_change {
+        std::optional<std::size_t> removed_idx{};
+        buffer_entry entry{};
+    };
+
+    // The buffer is logged as a chain of immutable segments so that a
+    // state can be captured without copying it. The first segment of a
+    // chain holds a full copy of the buffer.
+    struct buffer_log {
+        std::shared_ptr<buffer_log const> prev{};
+        std::vector<buffer_entry> entries{};
+        std::vector<buffer_change> changes{};
+    };
+
 public:
     explicit shuffled_instance_reader(
         data_reader_params const &prm,
-        std::unique_ptr<instance_reader> &&inner);
+        std::unique_ptr<default_instance_reader> &&inner);
 
 private:
     std::optional<instance>
     read_instance_core() final;
 
+    void
+    restore_state_core(state_reader &rd) final;
+
     void
     buffer_instances();
 
+    // Shuffles the buffered instances along with their locations.
+    void
+    shuffle_buffer();
+
+    bool
+    is_buffer_full() const noexcept;
+
     std::optional<instance>
     pop_random_instance_from_buffer();
 
+    instance
+    remove_from_buffer(std::size_t idx);
+
+    void
+    add_to_usage(instance const &ins);
+
+    void
+    remove_from_usage(instance const &ins) noexcept;
+
+    // Copies the payloads of the buffered instances whose memory blocks
+    // are mostly unreferenced into a single compact block so that the
+    // buffer does not pin entire chunks for a handful of instances.
+    void
+    compact_buffer_if_needed();
+
+    void
+    log_change(buffer_change &&change);
+
+    // Starts a new chain with a full copy of the buffer; called once
+    // the chain grows longer than the buffer itself.
+    void
+    rebase_log();
+
+    static void
+    write_buffer(state_writer &wr, buffer_log const *log);
+
 public:
     void
     reset() noexcept final;
 
+    void
+    save_state(state_writer &wr) const final;
+
 public:
     std::size_t
     num_bytes_read() const noexcept final
@@ -59,9 +120,24 @@ public:
 
 private:
     data_reader_params const *params_;
-    std::unique_ptr<instance_reader> inner_;
+    std::unique_ptr<default_instance_reader> inner_;
     std::size_t shuffle_window_;
+    std::optional<std::size_t> shuffle_window_bytes_;
     std::vector<instance> buffer_{};
+    // The locations of the buffered instances; only tracked if
+    // checkpointing is enabled.
+    std::vector<std::optional<instance_location>> locations_{};
+    // The total payload size of the buffered instances.
+    std::size_t buffer_num_bytes_{};
+    // The total size of the memory blocks referenced by the buffered
+    // instances and the payload size referenced in each of them.
+    std::size_t pinned_num_bytes_{};
+    std::unordered_map<memory_block const *, std::size_t> block_usage_{};
+    // The changes made to the buffer since the last captured state are
+    // sealed into a new segment once a state is captured.
+    mutable std::shared_ptr<buffer_log const> log_{};
+    mutable std::vector<buffer_change> pending_changes_{};
+    std::size_t num_logged_changes_{};
     bool inner_has_instances_ = true;
     std::random_device rd_{};
     std::uint_fast64_t seed_{rd_()};
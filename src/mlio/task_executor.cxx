@@ -0,0 +1,199 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/task_executor.h"
+
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "mlio/detail/system_info.h"
+#include "mlio/detail/thread_affinity.h"
+#include "mlio/logger.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+int
+get_max_concurrency(data_reader_params const &prm)
+{
+    // TBB sizes an automatic arena by the processor cores of the host,
+    // which oversubscribes a container that has a CPU quota.
+    if (prm.max_concurrency == 0) {
+        return static_cast<int>(get_num_cpus());
+    }
+    return static_cast<int>(prm.max_concurrency);
+}
+
+#if TBB_INTERFACE_VERSION >= 12000
+
+tbb::task_arena::priority
+as_arena_priority(task_priority priority) noexcept
+{
+    switch (priority) {
+    case task_priority::low:
+        return tbb::task_arena::priority::low;
+    case task_priority::normal:
+        return tbb::task_arena::priority::normal;
+    case task_priority::high:
+        return tbb::task_arena::priority::high;
+    }
+    return tbb::task_arena::priority::normal;
+}
+
+#endif
+
+// The affinity that the current worker thread had before it joined an
+// arena with an affinity observer.
+thread_local std::optional<std::vector<std::size_t>> original_cpus{};
+
+}  // namespace
+
+// Pins the worker threads to the processor cores of the arena as they
+// join it. Since TBB shares its worker threads among all arenas, the
+// original affinity of a worker is restored when it leaves the arena.
+class task_executor::affinity_observer final
+    : public tbb::task_scheduler_observer {
+public:
+    explicit affinity_observer(tbb::task_arena &arena,
+                               std::vector<std::size_t> const &cpus)
+        : tbb::task_scheduler_observer{arena}, cpus_{&cpus}
+    {
+        observe(true);
+    }
+
+    affinity_observer(affinity_observer const &) = delete;
+
+    affinity_observer(affinity_observer &&) = delete;
+
+    ~affinity_observer() override
+    {
+        observe(false);
+    }
+
+public:
+    affinity_observer &
+    operator=(affinity_observer const &) = delete;
+
+    affinity_observer &
+    operator=(affinity_observer &&) = delete;
+
+public:
+    void
+    on_scheduler_entry(bool is_worker) override
+    {
+        if (!is_worker) {
+            return;
+        }
+
+        try {
+            // If the worker is already pinned by an enclosing arena, the
+            // affinity it had before that arena is kept.
+            if (original_cpus == std::nullopt) {
+                original_cpus = get_current_thread_affinity();
+            }
+
+            set_current_thread_affinity(*cpus_);
+        }
+        catch (std::exception const &e) {
+            logger::warn("A worker thread cannot be pinned to the requested "
+                         "processor cores: {0}",
+                         e.what());
+        }
+    }
+
+    void
+    on_scheduler_exit(bool is_worker) override
+    {
+        if (!is_worker || original_cpus == std::nullopt) {
+            return;
+        }
+
+        std::vector<std::size_t> cpus = std::move(*original_cpus);
+
+        original_cpus = std::nullopt;
+
+        try {
+            set_current_thread_affinity(cpus);
+        }
+        catch (std::exception const &e) {
+            logger::warn("The affinity of a worker thread cannot be "
+                         "restored: {0}",
+                         e.what());
+        }
+    }
+
+private:
+    std::vector<std::size_t> const *cpus_;
+};
+
+task_executor::task_executor(data_reader_params const &prm)
+    : cpus_{prm.cpu_affinity}
+    , priority_{prm.priority}
+#if TBB_INTERFACE_VERSION >= 12000
+    , arena_{get_max_concurrency(prm), 1, as_arena_priority(prm.priority)}
+#else
+    , arena_{get_max_concurrency(prm)}
+#endif
+{
+    if (!cpus_.empty()) {
+        observer_ = std::make_unique<affinity_observer>(arena_, cpus_);
+    }
+}
+
+task_executor::~task_executor() = default;
+
+void
+task_executor::pin_current_thread() const
+{
+    if (cpus_.empty()) {
+        return;
+    }
+
+    set_current_thread_affinity(cpus_);
+}
+
+void
+task_executor::apply_priority(tbb::task_group_context &ctx) const
+{
+#if TBB_INTERFACE_VERSION < 12000 && __TBB_TASK_PRIORITY
+    switch (priority_) {
+    case task_priority::low:
+        ctx.set_priority(tbb::priority_low);
+        break;
+    case task_priority::normal:
+        ctx.set_priority(tbb::priority_normal);
+        break;
+    case task_priority::high:
+        ctx.set_priority(tbb::priority_high);
+        break;
+    }
+#else
+    // The priority has already been set on the arena.
+    static_cast<void>(ctx);
+#endif
+}
+
+std::size_t
+task_executor::max_concurrency() const
+{
+    return static_cast<std::size_t>(arena_.max_concurrency());
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <tbb/tbb.h>
+
+#include "mlio/data_reader.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+// Runs the background work of a data reader in a dedicated TBB task
+// arena so that its concurrency, processor affinity, and priority can
+// be controlled independently of other readers in the same process.
+class task_executor {
+    class affinity_observer;
+
+public:
+    explicit task_executor(data_reader_params const &prm);
+
+    task_executor(task_executor const &) = delete;
+
+    task_executor(task_executor &&) = delete;
+
+    ~task_executor();
+
+public:
+    task_executor &
+    operator=(task_executor const &) = delete;
+
+    task_executor &
+    operator=(task_executor &&) = delete;
+
+public:
+    // Executes the specified function in the arena. The tasks spawned
+    // by the function, including the ones of a flow graph constructed
+    // within it, run on the worker threads of the arena.
+    template<typename Func>
+    decltype(auto)
+    execute(Func &&f)
+    {
+        return arena_.execute(std::forward<Func>(f));
+    }
+
+    // Pins the calling thread to the processor cores of the arena.
+    void
+    pin_current_thread() const;
+
+    // Applies the priority of the arena to the specified task group.
+    void
+    apply_priority(tbb::task_group_context &ctx) const;
+
+    std::size_t
+    max_concurrency() const;
+
+private:
+    std::vector<std::size_t> cpus_;
+    task_priority priority_;
+    tbb::task_arena arena_;
+    std::unique_ptr<affinity_observer> observer_{};
+};
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/tensor_rows.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "mlio/data_type.h"
+#include "mlio/example.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/schema.h"
+#include "mlio/tensor.h"
+#include "mlio/tensor_visitor.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+template<data_type dt>
+struct copy_op {
+    void
+    operator()(device_array_view src,
+               std::size_t src_offset,
+               device_array_span dst,
+               std::size_t dst_offset,
+               std::size_t size)
+    {
+        using T = data_type_t<dt>;
+
+        auto s = src.as<T>();
+        auto d = dst.as<T>();
+
+        std::copy_n(s.begin() + as_ssize(src_offset),
+                    size,
+                    d.begin() + as_ssize(dst_offset));
+    }
+};
+
+struct as_dense_tensor_op : public tensor_visitor {
+    using tensor_visitor::visit;
+
+    void
+    visit(tensor &) override
+    {
+        throw not_supported_error{
+            "The data reader supports only dense tensors."};
+    }
+
+    void
+    visit(dense_tensor &tsr) override
+    {
+        dense = &tsr;
+    }
+
+    dense_tensor *dense{};
+};
+
+}  // namespace
+
+dense_tensor &
+as_dense_tensor(tensor &tsr)
+{
+    as_dense_tensor_op op{};
+
+    tsr.accept(op);
+
+    return *op.dense;
+}
+
+std::size_t
+get_row_size(tensor const &tsr) noexcept
+{
+    std::size_t size = 1;
+    for (auto pos = tsr.shape().begin() + 1; pos < tsr.shape().end(); ++pos) {
+        size *= *pos;
+    }
+    return size;
+}
+
+std::size_t
+get_data_size(tensor const &tsr, std::size_t num_rows) noexcept
+{
+    std::size_t last_idx = (num_rows - 1) * as_size(tsr.strides()[0]);
+
+    for (std::size_t dim = 1; dim < tsr.shape().size(); dim++) {
+        last_idx += (tsr.shape()[dim] - 1) * as_size(tsr.strides()[dim]);
+    }
+
+    return last_idx + 1;
+}
+
+bool
+is_row_major(tensor const &tsr) noexcept
+{
+    auto stride = as_ssize(1);
+
+    for (std::size_t dim = tsr.shape().size(); dim > 0; dim--) {
+        if (tsr.strides()[dim - 1] != stride) {
+            return false;
+        }
+        stride *= as_ssize(tsr.shape()[dim - 1]);
+    }
+    return true;
+}
+
+std::size_t
+get_batch_size(example const &exm)
+{
+    if (exm.features().empty()) {
+        throw std::invalid_argument{
+            "The example does not have any features to regroup."};
+    }
+
+    std::size_t batch_size{};
+
+    bool first = true;
+    for (auto const &tsr : exm.features()) {
+        if (tsr->shape().empty()) {
+            throw std::invalid_argument{
+                "The features of the example must have a batch dimension."};
+        }
+
+        for (std::ptrdiff_t stride : tsr->strides()) {
+            if (stride < 0) {
+                throw not_supported_error{
+                    "The data reader does not support negative strides."};
+            }
+        }
+
+        if (first) {
+            batch_size = tsr->shape()[0];
+
+            first = false;
+        }
+        else if (tsr->shape()[0] != batch_size) {
+            throw std::invalid_argument{
+                "The features of the example must have the same batch size."};
+        }
+    }
+
+    if (exm.padding > batch_size) {
+        throw std::invalid_argument{
+            "The padding of the example is greater than its batch size."};
+    }
+
+    return batch_size;
+}
+
+void
+copy_rows(dense_tensor const &src,
+          std::size_t src_row,
+          device_array &dst,
+          std::size_t dst_row,
+          std::size_t num_rows)
+{
+    if (!is_row_major(src)) {
+        throw not_supported_error{
+            "The data reader can only concatenate tensors in row-major "
+            "order."};
+    }
+
+    std::size_t row_size = get_row_size(src);
+
+    // The rows are contiguous, so they are copied at once.
+    dispatch<copy_op>(src.dtype(),
+                      src.data(),
+                      src_row * row_size,
+                      device_array_span{dst},
+                      dst_row * row_size,
+                      num_rows * row_size);
+}
+
+intrusive_ptr<schema>
+make_batch_schema(schema const &source, std::size_t batch_size)
+{
+    std::vector<feature_desc> descs{};
+    descs.reserve(source.descriptors().size());
+
+    for (feature_desc const &desc : source.descriptors()) {
+        size_vector shape = desc.shape();
+        if (!shape.empty()) {
+            shape[0] = batch_size;
+        }
+
+        feature_desc_builder bld{desc.name(), desc.dtype(), std::move(shape)};
+
+        descs.emplace_back(bld.with_strides(desc.strides())
+                               .with_sparsity(desc.sparse())
+                               .build());
+    }
+
+    return make_intrusive<schema>(std::move(descs));
+}
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mlio/device_array.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+
+// The functions below operate on the rows of the batch dimension of
+// dense tensors. They are shared by the data readers that regroup the
+// rows of the examples of other data readers.
+
+// Returns the specified tensor as a dense tensor; throws if the tensor
+// is sparse.
+dense_tensor &
+as_dense_tensor(tensor &tsr);
+
+// Returns the number of elements in a single row of the tensor.
+std::size_t
+get_row_size(tensor const &tsr) noexcept;
+
+// Returns the number of elements spanned by the specified number of
+// rows of the tensor.
+std::size_t
+get_data_size(tensor const &tsr, std::size_t num_rows) noexcept;
+
+bool
+is_row_major(tensor const &tsr) noexcept;
+
+// Returns the size of the batch dimension of the example; throws if
+// the features of the example do not share a batch dimension.
+std::size_t
+get_batch_size(example const &exm);
+
+// Copies the specified number of rows of a row-major tensor into an
+// array of the same data type.
+void
+copy_rows(dense_tensor const &src,
+          std::size_t src_row,
+          device_array &dst,
+          std::size_t dst_row,
+          std::size_t num_rows);
+
+// Returns a copy of the schema with the batch dimension of each
+// feature set to the specified size.
+intrusive_ptr<schema>
+make_batch_schema(schema const &source, std::size_t batch_size);
+
+}  // namespace detail
+}  // namespace v1
+}  // namespace mlio
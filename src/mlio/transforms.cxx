@@ -0,0 +1,204 @@
+/*
+ * Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/transforms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "mlio/data_type.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/tensor.h"
+#include "mlio/tensor_visitor.h"
+
+namespace mlio {
+inline namespace v1 {
+namespace detail {
+namespace {
+
+// Converts the result of a transform back to an integer type. As the
+// conversion of a NaN or an out-of-range value is undefined, the value
+// is rounded and clamped to the range of the type; a NaN becomes zero.
+template<typename T>
+T
+narrow_to_integer(double value) noexcept
+{
+    if (std::isnan(value)) {
+        return 0;
+    }
+
+    value = std::round(value);
+
+    // The limits of a 64-bit type are powers of two and therefore
+    // exactly representable as a double.
+    if (value <= static_cast<double>(std::numeric_limits<T>::min())) {
+        return std::numeric_limits<T>::min();
+    }
+    if (value >= static_cast<double>(std::numeric_limits<T>::max())) {
+        return std::numeric_limits<T>::max();
+    }
+    return static_cast<T>(value);
+}
+
+template<data_type dt>
+struct apply_op {
+    template<typename Func>
+    void
+    operator()(device_array_span arr, Func const &f)
+    {
+        using T = data_type_t<dt>;
+
+        if constexpr (dt == data_type::float16 || dt == data_type::string) {
+            throw not_supported_error{fmt::format(
+                "The transform does not support features of type {0}.", dt)};
+        }
+        else if constexpr (std::is_integral_v<T>) {
+            for (T &value : arr.as<T>()) {
+                value = narrow_to_integer<T>(f(static_cast<double>(value)));
+            }
+        }
+        else {
+            for (T &value : arr.as<T>()) {
+                value = static_cast<T>(f(static_cast<double>(value)));
+            }
+        }
+    }
+};
+
+// Applies a function to the stored values of a tensor.
+template<typename Func>
+struct apply_to_values_op : public tensor_visitor {
+    explicit apply_to_values_op(Func const &f) noexcept : func{&f}
+    {}
+
+    using tensor_visitor::visit;
+
+    void
+    visit(dense_tensor &tsr) override
+    {
+        dispatch<apply_op>(tsr.dtype(), tsr.data(), *func);
+    }
+
+    void
+    visit(coo_tensor &tsr) override
+    {
+        dispatch<apply_op>(tsr.dtype(), tsr.data(), *func);
+    }
+
+    void
+    visit(csr_tensor &tsr) override
+    {
+        dispatch<apply_op>(tsr.dtype(), tsr.data(), *func);
+    }
+
+    Func const *func;
+};
+
+template<typename Func>
+example_transform
+make_value_transform(std::string feature_name, Func f)
+{
+    return [name = std::move(feature_name),
+            f = std::move(f)](intrusive_ptr<example> exm) {
+        intrusive_ptr<tensor> tsr = exm->find_feature(name);
+        if (tsr == nullptr) {
+            throw std::invalid_argument{fmt::format(
+                "The example does not have a feature named '{0}'.", name)};
+        }
+
+        apply_to_values_op<Func> op{f};
+
+        tsr->accept(op);
+
+        return exm;
+    };
+}
+
+}  // namespace
+}  // namespace detail
+
+example_transform
+compose_transforms(std::vector<example_transform> transforms)
+{
+    return [transforms = std::move(transforms)](intrusive_ptr<example> exm) {
+        for (auto const &transform : transforms) {
+            if (exm == nullptr) {
+                break;
+            }
+            exm = transform(std::move(exm));
+        }
+        return exm;
+    };
+}
+
+example_transform
+make_standardize_transform(std::string feature_name,
+                           double mean,
+                           double stddev)
+{
+    // Also rejects a NaN.
+    if (!(std::abs(stddev) > 0)) {
+        throw std::invalid_argument{
+            "The standard deviation must not be zero."};
+    }
+
+    return detail::make_value_transform(std::move(feature_name),
+                                        [mean, stddev](double value) {
+                                            return (value - mean) / stddev;
+                                        });
+}
+
+example_transform
+make_clip_transform(std::string feature_name,
+                    double min_value,
+                    double max_value)
+{
+    if (min_value > max_value) {
+        throw std::invalid_argument{
+            "The minimum value must not be greater than the maximum value."};
+    }
+
+    return detail::make_value_transform(
+        std::move(feature_name), [min_value, max_value](double value) {
+            return std::clamp(value, min_value, max_value);
+        });
+}
+
+example_transform
+make_remap_transform(std::string feature_name,
+                     std::unordered_map<double, double> mapping)
+{
+    return detail::make_value_transform(
+        std::move(feature_name),
+        [mapping = std::move(mapping)](double value) {
+            auto pos = mapping.find(value);
+            if (pos == mapping.end()) {
+                return value;
+            }
+            return pos->second;
+        });
+}
+
+}  // namespace v1
+}  // namespace mlio
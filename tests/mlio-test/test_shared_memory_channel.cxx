@@ -0,0 +1,208 @@
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <mlio.h>
+
+namespace mlio {
+namespace {
+
+intrusive_ptr<example>
+make_example(std::size_t size, float value)
+{
+    auto shm = make_intrusive<schema>(std::vector<feature_desc>{
+        feature_desc_builder{"value", data_type::float32, {size}}.build()});
+
+    std::vector<float> data(size, value);
+
+    auto tsr = make_intrusive<dense_tensor>(
+        size_vector{size},
+        wrap_cpu_array<data_type::float32>(std::move(data)));
+
+    return make_intrusive<example>(
+        std::move(shm), std::vector<intrusive_ptr<tensor>>{std::move(tsr)});
+}
+
+// Runs the specified function in a child process that exits with a
+// non-zero status if the function throws.
+template<typename Function>
+::pid_t
+run_in_child(Function &&fn)
+{
+    ::pid_t pid = ::fork();
+    if (pid == 0) {
+        int status = 0;
+        try {
+            fn();
+        }
+        catch (...) {
+            status = 1;
+        }
+        ::_exit(status);
+    }
+    return pid;
+}
+
+int
+wait_for_child(::pid_t pid)
+{
+    int status{};
+    ::waitpid(pid, &status, 0);
+
+    if (WIFEXITED(status)) {
+        return WEXITSTATUS(status);
+    }
+    return -1;
+}
+
+void
+expect_example(example const &exm, std::size_t size, float value)
+{
+    auto const &tsr = static_cast<dense_tensor const &>(*exm.features()[0]);
+
+    auto data = tsr.data().as<float>();
+
+    ASSERT_EQ(data.size(), size);
+
+    for (float v : data) {
+        ASSERT_EQ(v, value);
+    }
+}
+
+}  // namespace
+
+TEST(shared_memory_channel, wraps_around_records_larger_than_half_capacity)
+{
+    constexpr std::size_t num_examples = 100;
+
+    // Each record takes more than half of the ring buffer, so all but the
+    // first one need the end of the buffer to be padded.
+    auto chnl = make_intrusive<shared_memory_channel>(std::size_t{1024});
+
+    auto get_size = [](std::size_t i) {
+        return i % 2 == 0 ? std::size_t{100} : std::size_t{120};
+    };
+
+    ::pid_t pid = run_in_child([&]() {
+        for (std::size_t i = 0; i < num_examples; i++) {
+            chnl->send(*make_example(get_size(i), static_cast<float>(i)));
+        }
+        chnl->close();
+    });
+
+    std::size_t i = 0;
+    while (intrusive_ptr<example> exm = chnl->receive()) {
+        expect_example(*exm, get_size(i), static_cast<float>(i));
+
+        i++;
+    }
+
+    EXPECT_EQ(i, num_examples);
+
+    EXPECT_EQ(wait_for_child(pid), 0);
+}
+
+TEST(shared_memory_channel, receive_returns_null_after_close)
+{
+    auto chnl = make_intrusive<shared_memory_channel>(std::size_t{4096});
+
+    ::pid_t pid = run_in_child([&]() {
+        for (std::size_t i = 0; i < 3; i++) {
+            chnl->send(*make_example(10, static_cast<float>(i)));
+        }
+        chnl->close();
+    });
+
+    // The examples sent before the channel was closed are still
+    // received.
+    for (std::size_t i = 0; i < 3; i++) {
+        intrusive_ptr<example> exm = chnl->receive();
+
+        ASSERT_NE(exm, nullptr);
+
+        expect_example(*exm, 10, static_cast<float>(i));
+    }
+
+    EXPECT_EQ(chnl->receive(), nullptr);
+    EXPECT_EQ(chnl->receive(), nullptr);
+
+    EXPECT_THROW(chnl->send(*make_example(10, 0)), std::runtime_error);
+
+    EXPECT_EQ(wait_for_child(pid), 0);
+}
+
+TEST(shared_memory_channel, receive_returns_null_if_sender_dies)
+{
+    auto chnl = make_intrusive<shared_memory_channel>(std::size_t{4096});
+
+    ::pid_t pid = run_in_child([&]() {
+        chnl->send(*make_example(10, 1));
+
+        // Exit without closing the channel.
+    });
+
+    intrusive_ptr<example> exm = chnl->receive();
+
+    ASSERT_NE(exm, nullptr);
+
+    expect_example(*exm, 10, 1);
+
+    EXPECT_EQ(chnl->receive(), nullptr);
+
+    EXPECT_EQ(wait_for_child(pid), 0);
+}
+
+TEST(shared_memory_channel, close_unblocks_receive_if_sender_dies_early)
+{
+    auto chnl = make_intrusive<shared_memory_channel>(std::size_t{4096});
+
+    ::pid_t pid = run_in_child([]() {
+        // Exit before sending anything.
+    });
+
+    // The sender is not known to the channel before its first send;
+    // the parent closes the channel once it has reaped the child.
+    std::thread reaper{[&]() {
+        EXPECT_EQ(wait_for_child(pid), 0);
+
+        chnl->close();
+    }};
+
+    EXPECT_EQ(chnl->receive(), nullptr);
+
+    reaper.join();
+}
+
+TEST(shared_memory_channel, send_throws_if_receiver_dies)
+{
+    auto chnl = make_intrusive<shared_memory_channel>(std::size_t{1024});
+
+    ::pid_t pid = run_in_child([&]() {
+        // Hold on to the first example so that its space is never
+        // given back, and exit without closing the channel.
+        intrusive_ptr<example> exm = chnl->receive();
+        if (exm == nullptr) {
+            throw std::runtime_error{"No example has been received."};
+        }
+        ::_exit(0);
+    });
+
+    auto send_all = [&]() {
+        for (std::size_t i = 0; i < 100; i++) {
+            chnl->send(*make_example(100, static_cast<float>(i)));
+        }
+    };
+
+    EXPECT_THROW(send_all(), std::runtime_error);
+
+    EXPECT_EQ(wait_for_child(pid), 0);
+}
+
+}  // namespace mlio